@@ -0,0 +1,226 @@
+/// \file operands.hpp
+/// \brief Operand generation and a widen-and-clamp reference for the
+/// benchmarks.
+
+#ifndef SATURATION_BENCHMARKS_OPERANDS_HPP
+#define SATURATION_BENCHMARKS_OPERANDS_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+#include "saturation/batch_kernel.hpp"
+
+namespace saturation::bench {
+
+using details::batch_arg_t;
+using details::batch_op;
+using details::is_unsigned_op;
+
+__extension__ typedef __int128 int128_type;
+__extension__ typedef unsigned __int128 uint128_type;
+
+/// The distributions from which operands are drawn.
+enum class inputs {
+  random,  ///< Uniformly distributed over the range of the type.
+  always,  ///< Every result saturates.
+  never,   ///< No result saturates.
+};
+
+constexpr char const* to_string (inputs const kind) noexcept {
+  switch (kind) {
+  case inputs::random: return "random";
+  case inputs::always: return "always";
+  case inputs::never: return "never";
+  }
+  return "unknown";
+}
+
+/// True if operands of kind \p kind exist for \p op. Unsigned division by a
+/// non-zero value cannot saturate, so only random operands are used for it.
+constexpr bool has_inputs (batch_op const op, inputs const kind) noexcept {
+  return op != batch_op::divu || kind == inputs::random;
+}
+
+/// The type in which the exact result of \p Op on \p N bit values is
+/// computed: the next standard type wider than 32 bits, or a 128 bit
+/// integer.
+template <batch_op Op, size_t N>
+using wide_t = std::conditional_t<
+    is_unsigned_op (Op), std::conditional_t<(N <= 32), uint64_t, uint128_type>,
+    std::conditional_t<(N <= 32), int64_t, int128_type>>;
+
+/// Returns the exact result of \p Op applied to \p x and \p y.
+template <batch_op Op, size_t N>
+constexpr wide_t<Op, N> exact (batch_arg_t<Op, N> const x,
+                               batch_arg_t<Op, N> const y) noexcept {
+  using wide = wide_t<Op, N>;
+  auto const wx = static_cast<wide> (x);
+  auto const wy = static_cast<wide> (y);
+  if constexpr (Op == batch_op::addu || Op == batch_op::adds) {
+    return wx + wy;
+  } else if constexpr (Op == batch_op::subu) {
+    return wx < wy ? wide{0} : static_cast<wide> (wx - wy);
+  } else if constexpr (Op == batch_op::subs) {
+    return wx - wy;
+  } else if constexpr (Op == batch_op::mulu || Op == batch_op::muls) {
+    return wx * wy;
+  } else {
+    return wx / wy;
+  }
+}
+
+/// Returns true if \p v cannot be represented in the arguments of \p Op on
+/// \p N bit values. An unsigned subtraction which would be negative is
+/// represented as 0 by exact() and so is handled by the caller.
+template <batch_op Op, size_t N>
+constexpr bool out_of_range (wide_t<Op, N> const v) noexcept {
+  if constexpr (is_unsigned_op (Op)) {
+    return v > ulimits<N>::max ();
+  } else {
+    return v < slimits<N>::min () || v > slimits<N>::max ();
+  }
+}
+
+/// Returns true if \p Op applied to \p x and \p y saturates.
+template <batch_op Op, size_t N>
+constexpr bool saturates (batch_arg_t<Op, N> const x,
+                          batch_arg_t<Op, N> const y) noexcept {
+  if constexpr (Op == batch_op::subu) {
+    return x < y;
+  } else {
+    return out_of_range<Op, N> (exact<Op, N> (x, y));
+  }
+}
+
+/// The naive baseline: computes the exact result of \p Op in a wider type
+/// then clamps it to the range of \p N bits.
+template <batch_op Op, size_t N>
+constexpr batch_arg_t<Op, N> naive (batch_arg_t<Op, N> const x,
+                                    batch_arg_t<Op, N> const y) noexcept {
+  using wide = wide_t<Op, N>;
+  auto const v = exact<Op, N> (x, y);
+  if constexpr (is_unsigned_op (Op)) {
+    return static_cast<batch_arg_t<Op, N>> (
+        std::min (v, static_cast<wide> (ulimits<N>::max ())));
+  } else {
+    return static_cast<batch_arg_t<Op, N>> (
+        std::clamp (v, static_cast<wide> (slimits<N>::min ()),
+                    static_cast<wide> (slimits<N>::max ())));
+  }
+}
+
+/// A sequence of pairs of operands.
+template <batch_op Op, size_t N>
+struct operands {
+  std::vector<batch_arg_t<Op, N>> x;
+  std::vector<batch_arg_t<Op, N>> y;
+};
+
+/// Returns \p count pairs of operands for \p Op on \p N bit values, drawn
+/// from the distribution \p kind.
+template <batch_op Op, size_t N>
+operands<Op, N> make_operands (inputs const kind, size_t const count,
+                               unsigned const seed) {
+  using arg = batch_arg_t<Op, N>;
+  using uniform_type =
+      std::conditional_t<is_unsigned_op (Op), uint64_t, int64_t>;
+  std::mt19937_64 generator{seed};
+  auto const uniform = [&generator] (uniform_type const lo,
+                                     uniform_type const hi) {
+    return static_cast<arg> (
+        std::uniform_int_distribution<uniform_type>{lo, hi}(generator));
+  };
+  // Returns v or -v with equal probability.
+  auto const either_sign = [&generator] (arg const v) {
+    return static_cast<arg> ((generator () & 1U) != 0U ? v : -v);
+  };
+
+  operands<Op, N> result;
+  result.x.reserve (count);
+  result.y.reserve (count);
+  for (auto ctr = size_t{0}; ctr < count; ++ctr) {
+    arg x = 0;
+    arg y = 0;
+    if constexpr (is_unsigned_op (Op)) {
+      constexpr auto max = uniform_type{ulimits<N>::max ()};
+      constexpr auto half = uniform_type{1} << (N - 1U);
+      constexpr auto root = uniform_type{1} << (N / 2U);
+      if (kind == inputs::random) {
+        x = uniform (0U, max);
+        y = uniform (Op == batch_op::divu ? 1U : 0U, max);
+      } else if constexpr (Op == batch_op::mulu) {
+        // Both at least 2^(N/2) or both less than it.
+        if (kind == inputs::always) {
+          x = uniform (root, max);
+          y = uniform (root, max);
+        } else {
+          x = uniform (0U, root - 1U);
+          y = uniform (0U, root - 1U);
+        }
+      } else {
+        // addu: both in the upper half or both in the lower half.
+        // subu: x in the lower half and y in the upper or vice versa.
+        auto const upper = [&] { return uniform (half, max); };
+        auto const lower = [&] { return uniform (0U, half - 1U); };
+        if (Op == batch_op::addu) {
+          x = kind == inputs::always ? upper () : lower ();
+        } else {
+          x = kind == inputs::always ? lower () : upper ();
+        }
+        y = kind == inputs::always ? upper () : lower ();
+      }
+    } else {
+      constexpr auto min = uniform_type{slimits<N>::min ()};
+      constexpr auto max = uniform_type{slimits<N>::max ()};
+      constexpr auto quarter = uniform_type{1} << (N - 2U);
+      constexpr auto root = uniform_type{1} << (N / 2U);
+      if (kind == inputs::random) {
+        x = uniform (min, max);
+        y = uniform (min, max);
+        if constexpr (Op == batch_op::divs) {
+          y = y == 0 ? arg{1} : y;
+        }
+      } else if constexpr (Op == batch_op::muls) {
+        // Magnitudes of at least 2^(N/2) or less than 2^(N/2-1).
+        if (kind == inputs::always) {
+          x = either_sign (uniform (root, max));
+          y = either_sign (uniform (root, max));
+        } else {
+          x = uniform (-root / 2, root / 2 - 1);
+          y = uniform (-root / 2, root / 2 - 1);
+        }
+      } else if constexpr (Op == batch_op::divs) {
+        // The only quotient which saturates is min / -1.
+        if (kind == inputs::always) {
+          x = static_cast<arg> (min);
+          y = arg{-1};
+        } else {
+          x = uniform (min, max);
+          y = uniform (min, max);
+          y = y == 0 || (x == min && y == -1) ? arg{1} : y;
+        }
+      } else if (kind == inputs::always) {
+        // adds: both at least 2^(N-2) in magnitude with the same sign.
+        // subs: both at least 2^(N-2) in magnitude with opposite signs.
+        auto const positive = (generator () & 1U) != 0U;
+        x = positive ? uniform (quarter, max) : uniform (min, -quarter - 1);
+        y = positive == (Op == batch_op::adds) ? uniform (quarter, max)
+                                               : uniform (min, -quarter - 1);
+      } else {
+        // Both less than 2^(N-2) in magnitude.
+        x = uniform (-quarter, quarter - 1);
+        y = uniform (-quarter, quarter - 1);
+      }
+    }
+    result.x.push_back (x);
+    result.y.push_back (y);
+  }
+  return result;
+}
+
+}  // end namespace saturation::bench
+
+#endif  // SATURATION_BENCHMARKS_OPERANDS_HPP
@@ -0,0 +1,278 @@
+/// \file ops.cpp
+/// \brief Latency and throughput of the scalar saturating functions.
+///
+/// The implementation of each function is chosen at compile time, so this
+/// file is built once for each strategy (see CMakeLists.txt):
+///
+/// - bench_builtin: the default configuration, which uses the compiler's
+///   overflow builtins where they are available. It also measures the naive
+///   baseline which widens the operands, computes the exact result, and
+///   clamps it.
+/// - bench_asm: the inline assembler (NO_BUILTIN_OVERFLOW).
+/// - bench_generic: the portable code (NO_INLINE_ASM and NO_BUILTIN_OVERFLOW).
+///
+/// Each benchmark is named strategy/op<N>/inputs/measure where inputs is
+/// "random", "always" (every result saturates), or "never" (no result
+/// saturates) and measure is "throughput" (independent operations) or
+/// "latency" (each operation depends on the result of the one before). The
+/// per_op counter is the time taken by a single operation. Use
+/// --benchmark_filter to select a subset: for example,
+/// --benchmark_filter='adds<16>/.*/latency'.
+///
+/// Where the hardware performance counters are available (see
+/// perf_counters.hpp), the number of cycles, instructions, branches, and
+/// branch misses per operation are also reported. These include the
+/// benchmark loop itself: about one predictable branch per operation. The
+/// library's functions are meant to be branchless, so a benchmark of one of
+/// them with random operands fails if it averages more than
+/// --max_branch_misses (default 0.05) mispredicted branches per operation.
+/// The program then exits with a non-zero status. A branch on whether a
+/// result saturates is mispredicted for a large fraction of random operands
+/// (a quarter or more for addition), so it is far above this limit.
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "operands.hpp"
+#include "perf_counters.hpp"
+
+#ifndef SATURATION_BENCH_STRATEGY
+#define SATURATION_BENCH_STRATEGY "builtin"
+#endif
+
+using namespace saturation;
+using namespace saturation::bench;
+
+namespace {
+
+/// The number of pairs of operands. Small enough for them to remain in the
+/// L1 cache.
+constexpr auto operand_count = size_t{1024};
+
+/// The largest acceptable number of branch misses per operation.
+double max_branch_misses = 0.05;
+/// The number of benchmarks which exceeded max_branch_misses.
+unsigned branch_failures = 0;
+/// The number of operations below which branch misses are not checked. The
+/// library runs each benchmark briefly to estimate the number of iterations
+/// needed: start-up costs dominate those runs.
+constexpr auto min_checked_ops = 1e6;
+
+/// Runs the benchmark loop, calling \p body (which performs operand_count
+/// operations) for each iteration, and reports the time and hardware events
+/// per operation. If \p check_branches is true, the benchmark fails if
+/// there are too many branch misses.
+template <typename Body>
+void measure (benchmark::State& state, bool const check_branches, Body body) {
+  perf_counters counters;
+  counters.start ();
+  for (auto _ : state) {
+    body ();
+  }
+  auto const values = counters.stop ();
+
+  auto const ops = static_cast<double> (state.iterations ()) *
+                   static_cast<double> (operand_count);
+  state.counters["per_op"] = benchmark::Counter (
+      static_cast<double> (operand_count),
+      benchmark::Counter::kIsIterationInvariantRate |
+          benchmark::Counter::kInvert);
+  if (!counters.available () || ops == 0.0) {
+    return;
+  }
+  for (auto const c : {perf_counters::cycles, perf_counters::instructions,
+                       perf_counters::branches, perf_counters::branch_misses}) {
+    state.counters[to_string (c)] = static_cast<double> (values[c]) / ops;
+  }
+  auto const misses =
+      static_cast<double> (values[perf_counters::branch_misses]) / ops;
+  if (check_branches && ops >= min_checked_ops && misses > max_branch_misses) {
+    ++branch_failures;
+    auto const message = std::to_string (misses) +
+                         " branch misses per operation exceeds the limit of " +
+                         std::to_string (max_branch_misses);
+    state.SkipWithError (message.c_str ());
+  }
+}
+
+/// Generates the operands for a benchmark and checks that \p f agrees with
+/// the naive baseline for each of them and that they saturate as \p kind
+/// requires. Returns false and marks \p state as failed if not.
+template <batch_op Op, size_t N, typename Function>
+bool prepare (benchmark::State& state, Function f, inputs const kind,
+              operands<Op, N>& args) {
+  args = make_operands<Op, N> (kind, operand_count, static_cast<unsigned> (N));
+  for (auto ctr = size_t{0}; ctr < operand_count; ++ctr) {
+    auto const x = args.x[ctr];
+    auto const y = args.y[ctr];
+    if (f (x, y) != naive<Op, N> (x, y)) {
+      state.SkipWithError ("result differs from the naive baseline");
+      return false;
+    }
+    if (kind != inputs::random &&
+        saturates<Op, N> (x, y) != (kind == inputs::always)) {
+      state.SkipWithError ("operands do not saturate as required");
+      return false;
+    }
+  }
+  return true;
+}
+
+/// Measures the throughput of \p f: the operations are independent of each
+/// other. The results are stored to memory, which is cheap compared with
+/// preventing the compiler from optimizing each of them individually.
+template <batch_op Op, size_t N, typename Function>
+void throughput (benchmark::State& state, Function f, inputs const kind,
+                 bool const check_branches) {
+  operands<Op, N> args;
+  if (!prepare<Op, N> (state, f, kind, args)) {
+    return;
+  }
+  std::vector<batch_arg_t<Op, N>> out (operand_count);
+  measure (state, check_branches, [&] {
+    for (auto ctr = size_t{0}; ctr < operand_count; ++ctr) {
+      out[ctr] = f (args.x[ctr], args.y[ctr]);
+    }
+    benchmark::DoNotOptimize (out.data ());
+    benchmark::ClobberMemory ();
+  });
+}
+
+/// Measures the latency of \p f: the first operand of each operation depends
+/// on the result of the previous one. The dependency passes through an AND
+/// with a zero that the compiler cannot see and an XOR, adding the same
+/// (small) constant to every strategy.
+template <batch_op Op, size_t N, typename Function>
+void latency (benchmark::State& state, Function f, inputs const kind,
+              bool const check_branches) {
+  using arg = batch_arg_t<Op, N>;
+  operands<Op, N> args;
+  if (!prepare<Op, N> (state, f, kind, args)) {
+    return;
+  }
+  auto zero = arg{0};
+  benchmark::DoNotOptimize (zero);
+  auto r = arg{0};
+  measure (state, check_branches, [&] {
+    for (auto ctr = size_t{0}; ctr < operand_count; ++ctr) {
+      r = f (static_cast<arg> (args.x[ctr] ^ (r & zero)), args.y[ctr]);
+    }
+    benchmark::DoNotOptimize (r);
+  });
+}
+
+/// Registers the throughput and latency benchmarks of \p f for \p Op on
+/// \p N bit values under the name \p strategy. If \p branchless is true,
+/// the benchmarks with random operands check the number of branch misses.
+template <batch_op Op, size_t N, typename Function>
+void register_function (char const* const strategy, bool const branchless,
+                        Function f) {
+  for (auto const kind : {inputs::random, inputs::always, inputs::never}) {
+    if (!has_inputs (Op, kind)) {
+      continue;
+    }
+    auto const check = branchless && kind == inputs::random;
+    auto const name = std::string{strategy} + '/' + to_string (Op) + '<' +
+                      std::to_string (N) + ">/" + to_string (kind);
+    benchmark::RegisterBenchmark (
+        (name + "/throughput").c_str (),
+        [f, kind, check] (benchmark::State& state) {
+          throughput<Op, N> (state, f, kind, check);
+        });
+    benchmark::RegisterBenchmark (
+        (name + "/latency").c_str (),
+        [f, kind, check] (benchmark::State& state) {
+          latency<Op, N> (state, f, kind, check);
+        });
+  }
+}
+
+template <batch_op Op, size_t N>
+void register_op () {
+  using arg = batch_arg_t<Op, N>;
+  register_function<Op, N> (SATURATION_BENCH_STRATEGY, true,
+                            [] (arg const x, arg const y) {
+                              return details::scalar_op<Op, N>::apply (x, y);
+                            });
+#ifdef SATURATION_BENCH_BASELINE
+  register_function<Op, N> ("naive", false, [] (arg const x, arg const y) {
+    return naive<Op, N> (x, y);
+  });
+#endif  // SATURATION_BENCH_BASELINE
+}
+
+template <size_t N>
+void register_width () {
+  register_op<batch_op::addu, N> ();
+  register_op<batch_op::adds, N> ();
+  register_op<batch_op::subu, N> ();
+  register_op<batch_op::subs, N> ();
+  register_op<batch_op::mulu, N> ();
+  register_op<batch_op::muls, N> ();
+  register_op<batch_op::divu, N> ();
+  register_op<batch_op::divs, N> ();
+}
+
+/// Removes the options understood by this program from \p argv, returning
+/// false if one of them is malformed.
+bool parse_options (int& argc, char** argv) {
+  constexpr char max_branch_misses_option[] = "--max_branch_misses=";
+  constexpr auto length = sizeof (max_branch_misses_option) - 1U;
+  auto out = 1;
+  for (auto ctr = 1; ctr < argc; ++ctr) {
+    if (std::strncmp (argv[ctr], max_branch_misses_option, length) == 0) {
+      char* end = nullptr;
+      max_branch_misses = std::strtod (argv[ctr] + length, &end);
+      if (end == argv[ctr] + length || *end != '\0') {
+        return false;
+      }
+    } else {
+      argv[out++] = argv[ctr];
+    }
+  }
+  argc = out;
+  argv[argc] = nullptr;
+  return true;
+}
+
+}  // end anonymous namespace
+
+int main (int argc, char** argv) {
+  register_width<4> ();
+  register_width<8> ();
+  register_width<12> ();
+  register_width<16> ();
+  register_width<24> ();
+  register_width<32> ();
+  register_width<48> ();
+  register_width<64> ();
+
+  benchmark::AddCustomContext ("strategy", SATURATION_BENCH_STRATEGY);
+  benchmark::AddCustomContext (
+      "perf_counters", perf_counters{}.available () ? "available"
+                                                    : "unavailable");
+  benchmark::Initialize (&argc, argv);
+  if (!parse_options (argc, argv)) {
+    std::fprintf (stderr, "%s: bad value for --max_branch_misses\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+  if (benchmark::ReportUnrecognizedArguments (argc, argv)) {
+    return EXIT_FAILURE;
+  }
+  benchmark::AddCustomContext ("max_branch_misses",
+                               std::to_string (max_branch_misses));
+  benchmark::RunSpecifiedBenchmarks ();
+  benchmark::Shutdown ();
+  if (branch_failures > 0U) {
+    std::fprintf (stderr, "%u benchmark(s) exceeded the branch miss limit\n",
+                  branch_failures);
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,157 @@
+/// \file perf_counters.hpp
+/// \brief Hardware performance counters read with the Linux perf_event_open()
+/// system call.
+///
+/// The counters are opened as a single group so that the kernel schedules
+/// them together and their values describe the same interval. They count
+/// user-mode events of the calling thread only. Where they cannot be opened
+/// (on other operating systems, in virtual machines which do not expose the
+/// performance monitoring unit, or if /proc/sys/kernel/perf_event_paranoid
+/// forbids it) available() returns false and every value is zero.
+
+#ifndef SATURATION_BENCHMARKS_PERF_COUNTERS_HPP
+#define SATURATION_BENCHMARKS_PERF_COUNTERS_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstring>
+#endif  // __linux__
+
+namespace saturation::bench {
+
+class perf_counters {
+public:
+  /// The events which are counted.
+  enum counter { cycles, instructions, branches, branch_misses };
+  static constexpr auto size = size_t{4};
+  using values = std::array<uint64_t, size>;
+
+  perf_counters () noexcept;
+  perf_counters (perf_counters const&) = delete;
+  perf_counters& operator= (perf_counters const&) = delete;
+  ~perf_counters () noexcept { close (); }
+
+  /// True if the counters were opened successfully.
+  bool available () const noexcept { return fds_[0] >= 0; }
+
+  /// Resets the counters to zero and starts counting.
+  void start () noexcept;
+  /// Stops counting and returns the number of each event since start(). If
+  /// the counters were multiplexed with other users of the hardware, the
+  /// values are scaled to estimate the count for the whole interval.
+  values stop () noexcept;
+
+private:
+  void close () noexcept;
+
+  std::array<int, size> fds_;
+};
+
+/// Returns the name of a counter.
+constexpr char const* to_string (perf_counters::counter const c) noexcept {
+  switch (c) {
+  case perf_counters::cycles: return "cycles";
+  case perf_counters::instructions: return "instructions";
+  case perf_counters::branches: return "branches";
+  case perf_counters::branch_misses: return "branch_misses";
+  }
+  return "unknown";
+}
+
+#ifdef __linux__
+
+inline perf_counters::perf_counters () noexcept {
+  fds_.fill (-1);
+  constexpr std::array<uint64_t, size> configs{
+      {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+       PERF_COUNT_HW_BRANCH_INSTRUCTIONS, PERF_COUNT_HW_BRANCH_MISSES}};
+  for (auto ctr = size_t{0}; ctr < size; ++ctr) {
+    perf_event_attr attr;
+    std::memset (&attr, 0, sizeof (attr));
+    attr.size = sizeof (attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = configs[ctr];
+    // The group leader starts disabled; the other members follow it.
+    attr.disabled = ctr == 0U;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED |
+                       PERF_FORMAT_TOTAL_TIME_RUNNING;
+    auto const fd = syscall (SYS_perf_event_open, &attr, 0 /*this thread*/,
+                             -1 /*any cpu*/, fds_[0] /*group leader*/,
+                             0UL /*flags*/);
+    if (fd < 0) {
+      this->close ();
+      return;
+    }
+    fds_[ctr] = static_cast<int> (fd);
+  }
+}
+
+inline void perf_counters::close () noexcept {
+  for (auto& fd : fds_) {
+    if (fd >= 0) {
+      ::close (fd);
+      fd = -1;
+    }
+  }
+}
+
+inline void perf_counters::start () noexcept {
+  if (available ()) {
+    ioctl (fds_[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl (fds_[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+  }
+}
+
+inline auto perf_counters::stop () noexcept -> values {
+  values result{};
+  if (!available ()) {
+    return result;
+  }
+  ioctl (fds_[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+  // The layout defined by PERF_FORMAT_GROUP with the two time fields.
+  struct {
+    uint64_t nr;
+    uint64_t time_enabled;
+    uint64_t time_running;
+    std::array<uint64_t, size> values;
+  } data{};
+  if (read (fds_[0], &data, sizeof (data)) !=
+          static_cast<ssize_t> (sizeof (data)) ||
+      data.nr != size || data.time_running == 0U) {
+    return result;
+  }
+  auto const scale = static_cast<double> (data.time_enabled) /
+                     static_cast<double> (data.time_running);
+  for (auto ctr = size_t{0}; ctr < size; ++ctr) {
+    result[ctr] =
+        static_cast<uint64_t> (static_cast<double> (data.values[ctr]) * scale);
+  }
+  return result;
+}
+
+#else
+
+inline perf_counters::perf_counters () noexcept {
+  fds_.fill (-1);
+}
+inline void perf_counters::close () noexcept {}
+inline void perf_counters::start () noexcept {}
+inline auto perf_counters::stop () noexcept -> values {
+  return {};
+}
+
+#endif  // __linux__
+
+}  // end namespace saturation::bench
+
+#endif  // SATURATION_BENCHMARKS_PERF_COUNTERS_HPP
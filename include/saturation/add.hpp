@@ -9,29 +9,65 @@ namespace saturation {
 
 /// \name Unsigned Addition
 /// Functions that perform saturating addition of unsigned integral
-/// quantities from 4 to 64 bits.
+/// quantities from 4 to 64 bits (128 bits if HAVE_INT128 is enabled).
 /// @{
 
+#if SATURATION_BUILTIN_OVERFLOW
+namespace details {
+
+/// An implementation of saturating unsigned add for register-sized values of
+/// \p N which the compiler recognizes as an overflow check (and, in a loop,
+/// can vectorize).
+template <size_t N>
+constexpr uinteger_t<N> addu_builtin (uinteger_t<N> const x,
+                                      uinteger_t<N> const y) {
+  auto const res = static_cast<uinteger_t<N>> (x + y);
+  // The sum wrapped if it is less than either argument.
+  return res < x ? ulimits<N>::max () : res;
+}
+
+}  // end namespace details
+#endif  // SATURATION_BUILTIN_OVERFLOW
+
 // addu
 // ~~~~
+namespace details {
+
+/// The portable implementation of addu<N>(). It is also used to constant
+/// evaluate those widths for which addu<N>() is specialized.
+template <size_t N>
+constexpr uinteger_t<N> addu_generic (uinteger_t<N> const x,
+                                      uinteger_t<N> const y) {
+  constexpr auto maxu = mask_v<N>;
+  uinteger_t<N> res = x + y;
+  res |= -((res < x) | (res > maxu));
+  return res & maxu;
+}
+
+}  // end namespace details
+
 /// \brief Adds two unsigned values each \p N bits wide.
 ///
 /// Returns \f$ 2^N-1 \f$ if the result cannot be represented in \p N bits.
 ///
 /// \tparam N  The number of bits for the unsigned arguments and result. May
-///   be in the range \f$ [4, 64] \f$.
+///   be in the range \f$ [4, 64] \f$ (\f$ [4, 128] \f$ if HAVE_INT128 is
+///   enabled).
 /// \param x  The first of the two unsigned values to be added.
 /// \param y  The second of the two unsigned values to be added.
 /// \result  \p x + \p y or \f$ 2^N-1 \f$ if the result cannot be
 ///   represented in \p N bits.
-template <size_t N, typename = typename std::enable_if_t<(N >= 4 && N <= 64)>>
+template <size_t N,
+          typename = typename std::enable_if_t<(N >= 4 && N <= max_width)>>
 constexpr uinteger_t<N> addu (uinteger_t<N> const x, uinteger_t<N> const y) {
   assert (x <= ulimits<N>::max ());  // addu<> x value out of range
   assert (y <= ulimits<N>::max ());  // addu<> y value out of range
-  constexpr auto maxu = mask_v<N>;
-  uinteger_t<N> res = x + y;
-  res |= -((res < x) | (res > maxu));
-  return res & maxu;
+#if SATURATION_BUILTIN_OVERFLOW
+  if constexpr (details::is_register_width (N) && N <= 64) {
+    return details::addu_builtin<N> (x, y);
+  }
+#endif  // SATURATION_BUILTIN_OVERFLOW
+  return details::addu_generic<N> (x, y);
 }
 
 #ifndef NO_INLINE_ASM
@@ -68,28 +104,80 @@ inline uinteger_t<N> addu_asm (uinteger_t<N> x, uinteger_t<N> y) {
 #undef YCONSTRAINT
 }
 
+#if HAVE_INT128
+/// An x86-only implementation of saturating unsigned add for 128 bit values.
+/// The 64 bit halves are added with add and adc so that the final carry
+/// reports overflow of the full value.
+///
+/// \param x  The first of the two unsigned values to be added.
+/// \param y  The second of the two unsigned values to be added.
+/// \result  \p x + \p y or \f$ 2^{128}-1 \f$ if the result cannot be
+///   represented in 128 bits.
+inline uinteger_t<128> addu_asm128 (uinteger_t<128> const x,
+                                    uinteger_t<128> const y) {
+  auto const yl = static_cast<uint64_t> (y);
+  auto const yh = static_cast<uint64_t> (y >> 64U);
+  auto lo = static_cast<uint64_t> (x);
+  auto hi = static_cast<uint64_t> (x >> 64U);
+  uint64_t t;
+  __asm__(
+      "add {%[yl],%[lo] | %[lo],%[yl]}\n\t"         // lo += yl (sets carry C)
+      "adc {%[yh],%[hi] | %[hi],%[yh]}\n\t"         // hi += yh + C (sets C)
+      "sbb %[t],%[t]"                               // t = 0 or ~0 from C.
+      : [lo] "+&r"(lo), [hi] "+&r"(hi), [t] "=&r"(t)  // output
+      : [yl] "r"(yl), [yh] "r"(yh)                    // input
+      : "cc"                                          // clobber
+  );
+  return uinteger_t<128>{hi | t} << 64U | (lo | t);
+}
+#endif  // HAVE_INT128
+
 }  // end namespace details
 
+#if !SATURATION_BUILTIN_OVERFLOW
 template <>
-inline uinteger_t<8> addu<8, std::enable_if_t<true>> (uinteger_t<8> const x,
-                                                      uinteger_t<8> const y) {
+SATURATION_ASM_CONSTEXPR uinteger_t<8> addu<8, std::enable_if_t<true>> (
+    uinteger_t<8> const x, uinteger_t<8> const y) {
+  if (details::is_constant_evaluated ()) {
+    return details::addu_generic<8> (x, y);
+  }
   return details::addu_asm<8> (x, y);
 }
 template <>
-inline uinteger_t<16> addu<16, std::enable_if_t<true>> (
+SATURATION_ASM_CONSTEXPR uinteger_t<16> addu<16, std::enable_if_t<true>> (
     uinteger_t<16> const x, uinteger_t<16> const y) {
+  if (details::is_constant_evaluated ()) {
+    return details::addu_generic<16> (x, y);
+  }
   return details::addu_asm<16> (x, y);
 }
 template <>
-inline uinteger_t<32> addu<32, std::enable_if_t<true>> (
+SATURATION_ASM_CONSTEXPR uinteger_t<32> addu<32, std::enable_if_t<true>> (
     uinteger_t<32> const x, uinteger_t<32> const y) {
+  if (details::is_constant_evaluated ()) {
+    return details::addu_generic<32> (x, y);
+  }
   return details::addu_asm<32> (x, y);
 }
+#endif  // !SATURATION_BUILTIN_OVERFLOW
 template <>
-inline uinteger_t<64> addu<64, std::enable_if_t<true>> (
+SATURATION_ASM_CONSTEXPR uinteger_t<64> addu<64, std::enable_if_t<true>> (
     uinteger_t<64> const x, uinteger_t<64> const y) {
+  if (details::is_constant_evaluated ()) {
+    return details::addu_generic<64> (x, y);
+  }
   return details::addu_asm<64> (x, y);
 }
+#if HAVE_INT128
+template <>
+SATURATION_ASM_CONSTEXPR uinteger_t<128> addu<128, std::enable_if_t<true>> (
+    uinteger_t<128> const x, uinteger_t<128> const y) {
+  if (details::is_constant_evaluated ()) {
+    return details::addu_generic<128> (x, y);
+  }
+  return details::addu_asm128 (x, y);
+}
+#endif  // HAVE_INT128
 #endif  // __GNUC__ && __x86_64__
 #endif  // NO_INLINE_ASM
 
@@ -102,7 +190,7 @@ inline uinteger_t<64> addu<64, std::enable_if_t<true>> (
 /// \result  \p x + \p y or \f$ 2^{32}-1 \f$
 ///   (`std::numeric_limits<uint32_t>::max()`) if the result cannot be
 ///   represented in 32 bits.
-inline uint32_t addu32 (uint32_t const x, uint32_t const y) {
+SATURATION_ASM_CONSTEXPR uint32_t addu32 (uint32_t const x, uint32_t const y) {
   return addu<32> (x, y);
 }
 /// \brief Adds two unsigned 16 bit values.
@@ -114,7 +202,7 @@ inline uint32_t addu32 (uint32_t const x, uint32_t const y) {
 /// \result  \p x + \p y or \f$ 2^{16}-1 \f$
 ///   (`std::numeric_limits<uint16_t>::max()`) if the result cannot be
 ///   represented in 16 bits.
-inline uint16_t addu16 (uint16_t const x, uint16_t const y) {
+SATURATION_ASM_CONSTEXPR uint16_t addu16 (uint16_t const x, uint16_t const y) {
   return addu<16> (x, y);
 }
 /// \brief Adds two unsigned 8 bit values.
@@ -126,20 +214,21 @@ inline uint16_t addu16 (uint16_t const x, uint16_t const y) {
 /// \result  \p x + \p y or \f$ 2^8-1 \f$
 ///   (`std::numeric_limits<uint8_t>::max()`). if the result cannot be
 ///   represented in 8 bits.
-inline uint8_t addu8 (uint8_t const x, uint8_t const y) {
+SATURATION_ASM_CONSTEXPR uint8_t addu8 (uint8_t const x, uint8_t const y) {
   return addu<8> (x, y);
 }
 /// @}
 
 /// \name Signed Addition
 /// Functions that perform saturating addition of signed integral
-/// quantities from 4 to 64 bits.
+/// quantities from 4 to 64 bits (128 bits if HAVE_INT128 is enabled).
 /// @{
 
 namespace details {
 
 /// Calculate the overflowed result as max or min depending on the sign of x.
-template <size_t N, typename = typename std::enable_if_t<(N >= 4 && N <= 64)>>
+template <size_t N,
+          typename = typename std::enable_if_t<(N >= 4 && N <= max_width)>>
 constexpr sinteger_t<N> adds_overflow_value (sinteger_t<N> const x) {
   using uint = uinteger_t<N>;
   using sint = sinteger_t<N>;
@@ -149,28 +238,38 @@ constexpr sinteger_t<N> adds_overflow_value (sinteger_t<N> const x) {
       ubits{static_cast<uint> ((ubits{static_cast<uint> (x)} >> (N - 1U)) + static_cast<uint>(slimits<N>::max ()))})};
 }
 
+#if SATURATION_BUILTIN_OVERFLOW
+/// An implementation of saturating signed add for register-sized values of
+/// \p N which the compiler recognizes as an overflow check (and, in a loop,
+/// can vectorize).
+template <size_t N>
+constexpr sinteger_t<N> adds_builtin (sinteger_t<N> const x,
+                                      sinteger_t<N> const y) {
+  using uint = uinteger_t<N>;
+  using sint = sinteger_t<N>;
+  auto const ux = static_cast<uint> (x);
+  auto const uy = static_cast<uint> (y);
+  auto const res = static_cast<uint> (ux + uy);
+  // Overflow if x and y have the same sign and the sign of res differs.
+  auto const overflow = static_cast<sint> ((ux ^ res) & (uy ^ res)) < 0;
+  // The saturated value takes the sign of x.
+  auto const v = static_cast<sint> ((ux >> (N - 1U)) +
+                                    static_cast<uint> (slimits<N>::max ()));
+  return overflow ? v : static_cast<sint> (res);
+}
+#endif  // SATURATION_BUILTIN_OVERFLOW
+
 } // end namespace details
 
 // adds
 // ~~~~
-/// \brief Adds two signed values each \p N bits wide.
-///
-/// Returns \f$ 2^{N-1}-1 \f$ or \f$ -2^{N-1} \f$ if the result cannot be
-/// represented in \p N bits.
-///
-/// \tparam N  The number of bits for the unsigned arguments and result. May
-///   be in the range \f$ [4, 64] \f$.
-/// \param x  The first of the two values to be added.
-/// \param y  The second of the two values to be added.
-/// \result  \p x + \p y or \f$ 2^{N-1}-1 \f$ if the result is positive but
-///   cannot be represented in \p N bits; \f$ -2{N-1} \f$ if the result is
-///   negative but cannot be represented in \p N bits.
-template <size_t N, typename = typename std::enable_if_t<(N >= 4 && N <= 64)>>
-constexpr sinteger_t<N> adds (sinteger_t<N> const x, sinteger_t<N> const y) {
-  assert (x >= slimits<N>::min () &&
-          x <= slimits<N>::max ());  // adds<> x value out of range
-  assert (y >= slimits<N>::min () &&
-          y <= slimits<N>::max ());  // adds<> y value out of range
+namespace details {
+
+/// The portable implementation of adds<N>(). It is also used to constant
+/// evaluate those widths for which adds<N>() is specialized.
+template <size_t N>
+constexpr sinteger_t<N> adds_generic (sinteger_t<N> const x,
+                                      sinteger_t<N> const y) {
   using uint = uinteger_t<N>;
   using sint = sinteger_t<N>;
   using ubits = details::nbit_scalar<N, true>;
@@ -194,6 +293,36 @@ constexpr sinteger_t<N> adds (sinteger_t<N> const x, sinteger_t<N> const y) {
   return sbits{static_cast<sint> (res)};
 }
 
+}  // end namespace details
+
+/// \brief Adds two signed values each \p N bits wide.
+///
+/// Returns \f$ 2^{N-1}-1 \f$ or \f$ -2^{N-1} \f$ if the result cannot be
+/// represented in \p N bits.
+///
+/// \tparam N  The number of bits for the unsigned arguments and result. May
+///   be in the range \f$ [4, 64] \f$ (\f$ [4, 128] \f$ if HAVE_INT128 is
+///   enabled).
+/// \param x  The first of the two values to be added.
+/// \param y  The second of the two values to be added.
+/// \result  \p x + \p y or \f$ 2^{N-1}-1 \f$ if the result is positive but
+///   cannot be represented in \p N bits; \f$ -2{N-1} \f$ if the result is
+///   negative but cannot be represented in \p N bits.
+template <size_t N,
+          typename = typename std::enable_if_t<(N >= 4 && N <= max_width)>>
+constexpr sinteger_t<N> adds (sinteger_t<N> const x, sinteger_t<N> const y) {
+  assert (x >= slimits<N>::min () &&
+          x <= slimits<N>::max ());  // adds<> x value out of range
+  assert (y >= slimits<N>::min () &&
+          y <= slimits<N>::max ());  // adds<> y value out of range
+#if SATURATION_BUILTIN_OVERFLOW
+  if constexpr (details::is_register_width (N) && N <= 64) {
+    return details::adds_builtin<N> (x, y);
+  }
+#endif  // SATURATION_BUILTIN_OVERFLOW
+  return details::adds_generic<N> (x, y);
+}
+
 #ifndef NO_INLINE_ASM
 #if defined(__GNUC__) && defined(__x86_64__)
 namespace details {
@@ -221,23 +350,78 @@ inline sinteger_t<N> adds_asm (sinteger_t<N> x, sinteger_t<N> y) {
   return x;
 }
 
+#if HAVE_INT128
+/// An x86-only implementation of saturating signed add for 128 bit values.
+/// The 64 bit halves are added with add and adc. The overflow flag from the
+/// second applies to the full value and selects both halves of the
+/// saturated result.
+///
+/// \param x  The first of the two values to be added.
+/// \param y  The second of the two values to be added.
+/// \result  \p x + \p y or \f$ 2^{127}-1 \f$ if the result is positive but
+///   cannot be represented in 128 bits; \f$ -2^{127} \f$ if the result is
+///   negative but cannot be represented in 128 bits.
+inline sinteger_t<128> adds_asm128 (sinteger_t<128> const x,
+                                    sinteger_t<128> const y) {
+  using u128 = uinteger_t<128>;
+  auto const v = static_cast<u128> (details::adds_overflow_value<128> (x));
+  auto const yl = static_cast<uint64_t> (y);
+  auto const yh = static_cast<uint64_t> (static_cast<u128> (y) >> 64U);
+  auto const vl = static_cast<uint64_t> (v);
+  auto const vh = static_cast<uint64_t> (v >> 64U);
+  auto lo = static_cast<uint64_t> (x);
+  auto hi = static_cast<uint64_t> (static_cast<u128> (x) >> 64U);
+  __asm__(
+      "add   {%[yl],%[lo] | %[lo],%[yl]}\n\t"  // lo += yl (sets carry C)
+      "adc   {%[yh],%[hi] | %[hi],%[yh]}\n\t"  // hi += yh + C (sets O)
+      "cmovo {%[vl],%[lo] | %[lo],%[vl]}\n\t"  // if O, lo = vl
+      "cmovo {%[vh],%[hi] | %[hi],%[vh]}"      // if O, hi = vh
+      : [lo] "+&r"(lo), [hi] "+&r"(hi)         // output
+      : [yl] "r"(yl), [yh] "r"(yh), [vl] "r"(vl), [vh] "r"(vh)  // input
+      : "cc"                                                    // clobber
+  );
+  return static_cast<sinteger_t<128>> (u128{hi} << 64U | lo);
+}
+#endif  // HAVE_INT128
+
 }  // end namespace details
 
+#if !SATURATION_BUILTIN_OVERFLOW
 template <>
-inline sinteger_t<16> adds<16, std::enable_if_t<true>> (
+SATURATION_ASM_CONSTEXPR sinteger_t<16> adds<16, std::enable_if_t<true>> (
     sinteger_t<16> const x, sinteger_t<16> const y) {
+  if (details::is_constant_evaluated ()) {
+    return details::adds_generic<16> (x, y);
+  }
   return details::adds_asm<16> (x, y);
 }
 template <>
-inline sinteger_t<32> adds<32, std::enable_if_t<true>> (
+SATURATION_ASM_CONSTEXPR sinteger_t<32> adds<32, std::enable_if_t<true>> (
     sinteger_t<32> const x, sinteger_t<32> const y) {
+  if (details::is_constant_evaluated ()) {
+    return details::adds_generic<32> (x, y);
+  }
   return details::adds_asm<32> (x, y);
 }
+#endif  // !SATURATION_BUILTIN_OVERFLOW
 template <>
-inline sinteger_t<64> adds<64, std::enable_if_t<true>> (
+SATURATION_ASM_CONSTEXPR sinteger_t<64> adds<64, std::enable_if_t<true>> (
     sinteger_t<64> const x, sinteger_t<64> const y) {
+  if (details::is_constant_evaluated ()) {
+    return details::adds_generic<64> (x, y);
+  }
   return details::adds_asm<64> (x, y);
 }
+#if HAVE_INT128
+template <>
+SATURATION_ASM_CONSTEXPR sinteger_t<128> adds<128, std::enable_if_t<true>> (
+    sinteger_t<128> const x, sinteger_t<128> const y) {
+  if (details::is_constant_evaluated ()) {
+    return details::adds_generic<128> (x, y);
+  }
+  return details::adds_asm128 (x, y);
+}
+#endif  // HAVE_INT128
 #endif  // __GNUC__ && __x86_64__
 #endif  // NO_INLINE_ASM
 
@@ -251,7 +435,7 @@ inline sinteger_t<64> adds<64, std::enable_if_t<true>> (
 /// \result  \p x + \p y or \f$ 2^{31}-1 \f$ if the result is positive but
 ///   cannot be represented in 32 bits; \f$ -2{31} \f$ if the result is
 ///   negative but cannot be represented in 32 bits.
-inline int32_t adds32 (int32_t const x, int32_t const y) {
+SATURATION_ASM_CONSTEXPR int32_t adds32 (int32_t const x, int32_t const y) {
   return adds<32> (x, y);
 }
 /// \brief Adds two signed 16 bit values.
@@ -264,7 +448,7 @@ inline int32_t adds32 (int32_t const x, int32_t const y) {
 /// \result  \p x + \p y or \f$ 2^{15}-1 \f$ if the result is positive but
 ///   cannot be represented in 16 bits; \f$ -2{15} \f$ if the result is
 ///   negative but cannot be represented in 16 bits.
-inline int16_t adds16 (int16_t const x, int16_t const y) {
+SATURATION_ASM_CONSTEXPR int16_t adds16 (int16_t const x, int16_t const y) {
   return adds<16> (x, y);
 }
 /// \brief Adds two signed 8 bit values.
@@ -282,6 +466,167 @@ constexpr int16_t adds8 (int8_t const x, int8_t const y) {
 }
 /// @}
 
+/// \name Addition with Overflow Reporting
+/// Functions that perform saturating addition and also report whether the
+/// result was clamped. The report is the condition which the saturating
+/// functions test internally: the carry or overflow flag of the addition
+/// where inline assembler or the compiler's overflow builtins are used.
+/// @{
+
+namespace details {
+
+/// The portable implementation of addu_ovf<N>().
+template <size_t N>
+constexpr ovf_result<uinteger_t<N>> addu_ovf_generic (uinteger_t<N> const x,
+                                                      uinteger_t<N> const y) {
+  uinteger_t<N> const res = x + y;
+  bool const saturated = res < x || res > mask_v<N>;
+  return {saturated ? ulimits<N>::max () : res, saturated};
+}
+/// The portable implementation of adds_ovf<N>().
+template <size_t N>
+constexpr ovf_result<sinteger_t<N>> adds_ovf_generic (sinteger_t<N> const x,
+                                                      sinteger_t<N> const y) {
+  using uint = uinteger_t<N>;
+  using sint = sinteger_t<N>;
+  if constexpr (N < sizeof (sint) * CHAR_BIT) {
+    // The sum is exact in the wider type.
+    auto const res = static_cast<sint> (x + y);
+    if (res > slimits<N>::max ()) {
+      return {slimits<N>::max (), true};
+    }
+    if (res < slimits<N>::min ()) {
+      return {slimits<N>::min (), true};
+    }
+    return {res, false};
+  } else {
+    auto const ux = static_cast<uint> (x);
+    auto const uy = static_cast<uint> (y);
+    auto const res = static_cast<uint> (ux + uy);
+    // Overflow if x and y have the same sign and the sign of res differs.
+    bool const saturated = static_cast<sint> ((ux ^ res) & (uy ^ res)) < 0;
+    return {saturated ? adds_overflow_value<N> (x) : static_cast<sint> (res),
+            saturated};
+  }
+}
+
+#if SATURATION_BUILTIN_OVERFLOW
+/// An implementation of addu_ovf<N>() for register-sized values of \p N.
+template <size_t N>
+constexpr ovf_result<uinteger_t<N>> addu_ovf_builtin (uinteger_t<N> const x,
+                                                      uinteger_t<N> const y) {
+  uinteger_t<N> res = 0;
+  bool const saturated = __builtin_add_overflow (x, y, &res);
+  return {saturated ? ulimits<N>::max () : res, saturated};
+}
+/// An implementation of adds_ovf<N>() for register-sized values of \p N.
+template <size_t N>
+constexpr ovf_result<sinteger_t<N>> adds_ovf_builtin (sinteger_t<N> const x,
+                                                      sinteger_t<N> const y) {
+  sinteger_t<N> res = 0;
+  bool const saturated = __builtin_add_overflow (x, y, &res);
+  return {saturated ? adds_overflow_value<N> (x) : res, saturated};
+}
+#endif  // SATURATION_BUILTIN_OVERFLOW
+
+#if SATURATION_ASM_FLAG_OUTPUTS
+/// An x86-only implementation of addu_ovf<N>() for register-sized values of
+/// \p N. As addu_asm<N>() but the carry flag is also returned.
+template <size_t N>
+inline ovf_result<uinteger_t<N>> addu_ovf_asm (uinteger_t<N> x,
+                                               uinteger_t<N> const y) {
+  uinteger_t<N> t;
+  bool carry;
+  __asm__(
+      "add {%[y],%[x] | %[x],%[y]}\n\t"  // x += y (sets carry C on overflow)
+      "sbb %[t],%[t]"                    // t = 0 or ~0 from C (C unchanged).
+      : [x] "+&r"(x), [t] "=&r"(t), [c] "=@ccc"(carry)  // output
+      : [y] "r"(y)                                      // input
+  );
+  return {static_cast<uinteger_t<N>> (x | t), carry};
+}
+/// An x86-only implementation of adds_ovf<N>() for register-sized values of
+/// \p N of at least 16 bits. As adds_asm<N>() but the overflow flag is also
+/// returned.
+template <size_t N>
+inline ovf_result<sinteger_t<N>> adds_ovf_asm (sinteger_t<N> x,
+                                               sinteger_t<N> const y) {
+  sinteger_t<N> const v = details::adds_overflow_value<N> (x);
+  bool overflow;
+  __asm__(
+      "add   {%[y],%[x] | %[x],%[y]}\n\t"  // x += y (sets O on overflow)
+      "cmovo {%[v],%[x] | %[x],%[v]}"      // if O, x = v
+      : [x] "+&r"(x), [o] "=@cco"(overflow)  // output
+      : [y] "r"(y), [v] "r"(v)               // input
+  );
+  return {x, overflow};
+}
+#endif  // SATURATION_ASM_FLAG_OUTPUTS
+
+}  // end namespace details
+
+/// \brief Adds two unsigned values each \p N bits wide and reports whether
+///   the result saturated.
+///
+/// \tparam N  The number of bits for the unsigned arguments and result. May
+///   be in the range \f$ [4, 64] \f$ (\f$ [4, 128] \f$ if HAVE_INT128 is
+///   enabled).
+/// \param x  The first of the two unsigned values to be added.
+/// \param y  The second of the two unsigned values to be added.
+/// \result  The value addu<N>(\p x, \p y) and true if \p x + \p y could not
+///   be represented in \p N bits.
+template <size_t N,
+          typename = typename std::enable_if_t<(N >= 4 && N <= max_width)>>
+constexpr ovf_result<uinteger_t<N>> addu_ovf (uinteger_t<N> const x,
+                                              uinteger_t<N> const y) {
+  assert (x <= ulimits<N>::max ());  // addu_ovf<> x value out of range
+  assert (y <= ulimits<N>::max ());  // addu_ovf<> y value out of range
+#if SATURATION_BUILTIN_OVERFLOW
+  if constexpr (details::is_register_width (N) && N <= 64) {
+    return details::addu_ovf_builtin<N> (x, y);
+  }
+#elif SATURATION_ASM_FLAG_OUTPUTS
+  if constexpr (details::is_register_width (N) && N <= 64) {
+    if (!details::is_constant_evaluated ()) {
+      return details::addu_ovf_asm<N> (x, y);
+    }
+  }
+#endif  // SATURATION_BUILTIN_OVERFLOW
+  return details::addu_ovf_generic<N> (x, y);
+}
+/// \brief Adds two signed values each \p N bits wide and reports whether the
+///   result saturated.
+///
+/// \tparam N  The number of bits for the signed arguments and result. May be
+///   in the range \f$ [4, 64] \f$ (\f$ [4, 128] \f$ if HAVE_INT128 is
+///   enabled).
+/// \param x  The first of the two values to be added.
+/// \param y  The second of the two values to be added.
+/// \result  The value adds<N>(\p x, \p y) and true if \p x + \p y could not
+///   be represented in \p N bits.
+template <size_t N,
+          typename = typename std::enable_if_t<(N >= 4 && N <= max_width)>>
+constexpr ovf_result<sinteger_t<N>> adds_ovf (sinteger_t<N> const x,
+                                              sinteger_t<N> const y) {
+  assert (x >= slimits<N>::min () &&
+          x <= slimits<N>::max ());  // adds_ovf<> x value out of range
+  assert (y >= slimits<N>::min () &&
+          y <= slimits<N>::max ());  // adds_ovf<> y value out of range
+#if SATURATION_BUILTIN_OVERFLOW
+  if constexpr (details::is_register_width (N) && N <= 64) {
+    return details::adds_ovf_builtin<N> (x, y);
+  }
+#elif SATURATION_ASM_FLAG_OUTPUTS
+  if constexpr (details::is_register_width (N) && N >= 16 && N <= 64) {
+    if (!details::is_constant_evaluated ()) {
+      return details::adds_ovf_asm<N> (x, y);
+    }
+  }
+#endif  // SATURATION_BUILTIN_OVERFLOW
+  return details::adds_ovf_generic<N> (x, y);
+}
+/// @}
+
 }  // end namespace saturation
 
 #endif  // SATURATION_ADD_HPP
@@ -0,0 +1,345 @@
+/// \file autotune.hpp
+/// \brief An optional start-up tuner which chooses the fastest batch kernel
+/// for each operation and width on the host processor.
+///
+/// The batch functions normally use the most capable kernel that the host
+/// supports (see cpu.hpp). That is not always the fastest: a wider vector
+/// unit may run at a lower clock frequency, and some operations gain little
+/// from the wider registers. A program which calls
+///
+///     saturation::autotune ();
+///
+/// at start-up times the kernel for each instruction set level up to
+/// selected_isa() on random operands, for each of the common operations and
+/// widths, and installs the fastest in the dispatch table used by the batch
+/// functions and expressions. The choices are saved in a cache file keyed by
+/// the processor model (cpu_model()) and instruction set level. Later runs on
+/// the same kind of machine read them instead of measuring again.
+///
+/// The implementation of the scalar functions (inline assembler, compiler
+/// builtins, or portable code) is fixed when the program is compiled. The
+/// candidates are therefore the kernels which can be chosen at run time.
+
+#ifndef SATURATION_AUTOTUNE_HPP
+#define SATURATION_AUTOTUNE_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+#include "saturation/batch.hpp"
+#include "saturation/cpu.hpp"
+
+namespace saturation {
+
+/// The kernel chosen by autotune() for one operation and width.
+struct autotune_choice {
+  /// The name of the operation ("addu", "adds", and so on).
+  char const* op;
+  /// The width of the values in bits.
+  size_t bits;
+  /// The instruction set level of the installed kernel.
+  isa level;
+  /// True if the choice was read from the cache; false if it was measured.
+  bool cached;
+};
+
+struct autotune_options {
+  /// The cache file. If empty, the file named by the
+  /// SATURATION_AUTOTUNE_CACHE environment variable is used or, if that is
+  /// not set, saturation/autotune.txt in $XDG_CACHE_HOME or $HOME/.cache.
+  std::string cache_path;
+  /// If false, the cache is neither read nor written.
+  bool use_cache = true;
+};
+
+namespace details {
+
+/// The number of elements processed by each call to a candidate kernel.
+constexpr auto autotune_elements = size_t{4096};
+/// The number of times that each candidate is timed. The fastest time is
+/// used.
+constexpr auto autotune_repeats = 5U;
+/// The number of calls to the kernel in each timing.
+constexpr auto autotune_passes = 4U;
+/// A kernel replaces the default only if it is faster by at least this
+/// proportion, so that noise does not cause needless changes.
+constexpr auto autotune_margin = 0.03;
+
+/// Returns the value of the environment variable \p name or an empty string
+/// if it is not set.
+inline std::string get_env (char const* const name) {
+#ifdef _MSC_VER
+  // MSVC deprecates std::getenv() (C4996) in favor of _dupenv_s().
+  char* value = nullptr;
+  size_t length = 0;
+  std::string result;
+  if (_dupenv_s (&value, &length, name) == 0 && value != nullptr) {
+    result = value;
+  }
+  std::free (value);
+  return result;
+#else
+  auto const* const value = std::getenv (name);
+  return value != nullptr ? value : std::string{};
+#endif  // _MSC_VER
+}
+
+/// Returns the path of the cache file given \p options.
+inline std::filesystem::path autotune_cache_path (
+    autotune_options const& options) {
+  if (!options.cache_path.empty ()) {
+    return options.cache_path;
+  }
+  if (auto const path = get_env ("SATURATION_AUTOTUNE_CACHE");
+      !path.empty ()) {
+    return path;
+  }
+  std::filesystem::path dir;
+  if (auto const xdg = get_env ("XDG_CACHE_HOME"); !xdg.empty ()) {
+    dir = xdg;
+  } else if (auto const home = get_env ("HOME"); !home.empty ()) {
+    dir = std::filesystem::path{home} / ".cache";
+  } else {
+    return {};
+  }
+  return dir / "saturation" / "autotune.txt";
+}
+
+/// \brief The choices made by autotune() and the contents of the cache file.
+///
+/// Each line of the file holds five tab-separated fields: the processor
+/// model, the selected instruction set level, the operation, the width,
+/// and the chosen instruction set level. Lines for other processors or
+/// levels are preserved when the file is rewritten.
+class autotune_state {
+public:
+  autotune_state ()
+      : key_{cpu_model () + '\t' + to_string (selected_isa ())} {}
+
+  /// Reads the cache file at \p path, if it exists.
+  void load (std::filesystem::path const& path) {
+    std::ifstream is{path};
+    std::string line;
+    while (std::getline (is, line)) {
+      if (line.compare (0, key_.size (), key_) == 0 &&
+          line.size () > key_.size () && line[key_.size ()] == '\t') {
+        cached_.push_back (line.substr (key_.size () + 1U));
+      } else if (!line.empty ()) {
+        others_.push_back (line);
+      }
+    }
+  }
+
+  /// Writes the cache file at \p path. Returns false on failure.
+  bool save (std::filesystem::path const& path) const {
+    std::error_code error;
+    std::filesystem::create_directories (path.parent_path (), error);
+    // Write a temporary file then rename it so that a concurrent reader
+    // never sees a partial file.
+    auto temp = path;
+    temp += ".tmp";
+    {
+      std::ofstream os{temp, std::ios::trunc};
+      for (auto const& line : others_) {
+        os << line << '\n';
+      }
+      for (auto const& c : choices_) {
+        os << key_ << '\t' << c.op << '\t' << c.bits << '\t'
+           << to_string (c.level) << '\n';
+      }
+      if (!os.flush ()) {
+        return false;
+      }
+    }
+    std::filesystem::rename (temp, path, error);
+    return !error;
+  }
+
+  /// Looks up the cached instruction set level for \p op on \p bits bit
+  /// values. Returns false if there is none or it is not usable on this host
+  /// (for example, because SATURATION_ISA has lowered selected_isa()).
+  bool lookup (char const* const op, size_t const bits,
+               isa* const level) const {
+    auto const prefix =
+        std::string{op} + '\t' + std::to_string (bits) + '\t';
+    for (auto const& entry : cached_) {
+      if (entry.compare (0, prefix.size (), prefix) != 0) {
+        continue;
+      }
+      auto const name = entry.substr (prefix.size ());
+      for (auto const l : {isa::scalar, isa::sse2, isa::avx2, isa::avx512}) {
+        if (name == to_string (l) && l <= selected_isa ()) {
+          *level = l;
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+  void add (autotune_choice const& c) { choices_.push_back (c); }
+  std::vector<autotune_choice> const& choices () const noexcept {
+    return choices_;
+  }
+
+private:
+  std::string key_;
+  /// The fields after the key of the lines which match it.
+  std::vector<std::string> cached_;
+  /// The lines for other processors or instruction set levels.
+  std::vector<std::string> others_;
+  std::vector<autotune_choice> choices_;
+};
+
+/// Returns \p count pseudo-random operands for \p Op on \p N bit values. If
+/// \p nonzero is true, none of them is zero.
+template <batch_op Op, size_t N>
+std::vector<batch_arg_t<Op, N>> autotune_operands (size_t const count,
+                                                   bool const nonzero,
+                                                   unsigned const seed) {
+  using arg = batch_arg_t<Op, N>;
+  using uniform_type =
+      std::conditional_t<is_unsigned_op (Op), uint64_t, int64_t>;
+  constexpr auto min = is_unsigned_op (Op)
+                           ? uniform_type{0}
+                           : static_cast<uniform_type> (slimits<N>::min ());
+  constexpr auto max = is_unsigned_op (Op)
+                           ? static_cast<uniform_type> (ulimits<N>::max ())
+                           : static_cast<uniform_type> (slimits<N>::max ());
+  std::mt19937_64 generator{seed};
+  std::uniform_int_distribution<uniform_type> distribution{min, max};
+  std::vector<arg> result (count);
+  for (auto& v : result) {
+    do {
+      v = static_cast<arg> (distribution (generator));
+    } while (nonzero && v == 0);
+  }
+  return result;
+}
+
+/// Returns the shortest time taken by \p kernel to process the operands.
+template <batch_op Op, size_t N>
+std::chrono::steady_clock::duration autotune_time (
+    batch_kernel_t<Op, N> const kernel,
+    std::vector<batch_arg_t<Op, N>> const& x,
+    std::vector<batch_arg_t<Op, N>> const& y,
+    std::vector<batch_arg_t<Op, N>>& out) {
+  using clock = std::chrono::steady_clock;
+  kernel (x.data (), y.data (), out.data (), out.size ());  // warm up
+  auto best = clock::duration::max ();
+  for (auto repeat = 0U; repeat < autotune_repeats; ++repeat) {
+    auto const start = clock::now ();
+    for (auto pass = 0U; pass < autotune_passes; ++pass) {
+      kernel (x.data (), y.data (), out.data (), out.size ());
+    }
+    best = std::min (best, clock::now () - start);
+  }
+  return best;
+}
+
+/// Chooses and installs the kernel for \p Op on values of \p N bits.
+template <batch_op Op, size_t N>
+void autotune_kernel (autotune_state& state) {
+  auto level = isa{};
+  if (state.lookup (to_string (Op), N, &level)) {
+    dispatch<Op, N>::set (resolve_kernel<Op, N> (level));
+    state.add ({to_string (Op), N, level, true});
+    return;
+  }
+
+  constexpr auto is_div = Op == batch_op::divu || Op == batch_op::divs;
+  auto const x = autotune_operands<Op, N> (autotune_elements, false, 1U);
+  auto const y = autotune_operands<Op, N> (autotune_elements, is_div, 2U);
+  std::vector<batch_arg_t<Op, N>> out (autotune_elements);
+
+  // Start with the default kernel then try those of the lower levels,
+  // skipping any which are the same as a kernel already timed.
+  level = selected_isa ();
+  auto best = resolve_kernel<Op, N> (level);
+  auto best_time = autotune_time<Op, N> (best, x, y, out);
+  auto previous = best;
+  for (auto l = static_cast<int> (level) - 1; l >= 0; --l) {
+    auto const candidate_level = static_cast<isa> (l);
+    auto const candidate = resolve_kernel<Op, N> (candidate_level);
+    if (candidate == previous) {
+      // The same kernel serves this level and the one above.
+      if (candidate == best) {
+        level = candidate_level;
+      }
+      continue;
+    }
+    previous = candidate;
+    auto const time = autotune_time<Op, N> (candidate, x, y, out);
+    if (static_cast<double> (time.count ()) <
+        static_cast<double> (best_time.count ()) * (1.0 - autotune_margin)) {
+      best = candidate;
+      best_time = time;
+      level = candidate_level;
+    }
+  }
+  dispatch<Op, N>::set (best);
+  state.add ({to_string (Op), N, level, false});
+}
+
+template <size_t N>
+void autotune_width (autotune_state& state) {
+  autotune_kernel<batch_op::addu, N> (state);
+  autotune_kernel<batch_op::adds, N> (state);
+  autotune_kernel<batch_op::subu, N> (state);
+  autotune_kernel<batch_op::subs, N> (state);
+  autotune_kernel<batch_op::mulu, N> (state);
+  autotune_kernel<batch_op::muls, N> (state);
+  autotune_kernel<batch_op::divu, N> (state);
+  autotune_kernel<batch_op::divs, N> (state);
+}
+
+}  // end namespace details
+
+/// \brief Chooses the fastest batch kernel for each operation and width,
+/// reading and updating the cache described by \p options, and installs it.
+///
+/// The operations are addu, adds, subu, subs, mulu, muls, divu, and divs on
+/// values of 8, 12, 16, 24, 32, 48, and 64 bits. The kernels of other
+/// operations and widths are unchanged. A failure to read or write the cache
+/// file is not an error: the kernels are then measured or, respectively, not
+/// remembered. This should be called before the batch functions are used
+/// from other threads.
+///
+/// \param options  The location of the cache and whether it is used.
+/// \returns  The kernel chosen for each operation and width.
+inline std::vector<autotune_choice> autotune (
+    autotune_options const& options = {}) {
+  details::autotune_state state;
+  auto const path = options.use_cache
+                        ? details::autotune_cache_path (options)
+                        : std::filesystem::path{};
+  if (!path.empty ()) {
+    state.load (path);
+  }
+  details::autotune_width<8> (state);
+  details::autotune_width<12> (state);
+  details::autotune_width<16> (state);
+  details::autotune_width<24> (state);
+  details::autotune_width<32> (state);
+  details::autotune_width<48> (state);
+  details::autotune_width<64> (state);
+  auto const& choices = state.choices ();
+  if (!path.empty () &&
+      std::any_of (choices.begin (), choices.end (),
+                   [] (autotune_choice const& c) { return !c.cached; })) {
+    state.save (path);
+  }
+  return choices;
+}
+
+}  // end namespace saturation
+
+#endif  // SATURATION_AUTOTUNE_HPP
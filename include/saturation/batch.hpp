@@ -0,0 +1,609 @@
+/// \file batch.hpp
+/// \brief Functions which apply saturating arithmetic elementwise to arrays of
+/// values.
+///
+/// Each function takes two input spans and an output span, all of which must
+/// have the same number of elements. The output may be the same as either
+/// input (so that operations can be performed in place) but must not
+/// otherwise overlap them. The results are identical to those produced by
+/// calling the corresponding scalar function template for each element in
+/// turn. Where the host processor provides suitable vector instructions these
+/// are used to process many elements at once: the most capable kernel for each
+/// operation and width is chosen at run time (see cpu.hpp).
+
+#ifndef SATURATION_BATCH_HPP
+#define SATURATION_BATCH_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <climits>
+
+#include "saturation/batch_avx2.hpp"
+#include "saturation/batch_avx512.hpp"
+#include "saturation/batch_kernel.hpp"
+#include "saturation/batch_sse2.hpp"
+#include "saturation/cpu.hpp"
+#include "saturation/div_round.hpp"
+#include "saturation/span.hpp"
+
+namespace saturation {
+
+namespace details {
+
+/// Returns the most capable kernel that implements \p Op on values of \p N
+/// bits using instructions no more advanced than \p level.
+template <batch_op Op, size_t N>
+batch_kernel_t<Op, N> resolve_kernel (isa const level) noexcept {
+#ifndef NO_SIMD
+#if defined(__GNUC__) && defined(__x86_64__)
+  if constexpr (avx512::kernel<Op, N> () != nullptr) {
+    if (level >= isa::avx512) {
+      return avx512::kernel<Op, N> ();
+    }
+  }
+  if constexpr (avx2::kernel<Op, N> () != nullptr) {
+    if (level >= isa::avx2) {
+      return avx2::kernel<Op, N> ();
+    }
+  }
+  if constexpr (sse2::kernel<Op, N> () != nullptr) {
+    if (level >= isa::sse2) {
+      return sse2::kernel<Op, N> ();
+    }
+  }
+#endif  // __GNUC__ && __x86_64__
+#endif  // NO_SIMD
+  (void)level;
+  return &batch_scalar<Op, N>;
+}
+
+/// Holds the kernel used to implement \p Op on values of \p N bits. The
+/// kernel is chosen on first use according to selected_isa().
+template <batch_op Op, size_t N>
+class dispatch {
+public:
+  /// Returns the kernel for this operation.
+  static batch_kernel_t<Op, N> get () noexcept {
+    auto kernel = kernel_.load (std::memory_order_relaxed);
+    if (kernel == nullptr) {
+      kernel = resolve_kernel<Op, N> (selected_isa ());
+      kernel_.store (kernel, std::memory_order_relaxed);
+    }
+    return kernel;
+  }
+  /// Replaces the kernel for this operation.
+  static void set (batch_kernel_t<Op, N> const kernel) noexcept {
+    kernel_.store (kernel, std::memory_order_relaxed);
+  }
+
+private:
+  static inline std::atomic<batch_kernel_t<Op, N>> kernel_{nullptr};
+};
+
+/// Returns the most capable kernel that implements \p Op on values of \p N
+/// bits, reporting the elements that saturate, using instructions no more
+/// advanced than \p level.
+template <batch_op Op, size_t N>
+batch_ovf_kernel_t<Op, N> resolve_ovf_kernel (isa const level) noexcept {
+#ifndef NO_SIMD
+#if defined(__GNUC__) && defined(__x86_64__)
+  if constexpr (avx512::ovf_kernel<Op, N> () != nullptr) {
+    if (level >= isa::avx512) {
+      return avx512::ovf_kernel<Op, N> ();
+    }
+  }
+  if constexpr (avx2::ovf_kernel<Op, N> () != nullptr) {
+    if (level >= isa::avx2) {
+      return avx2::ovf_kernel<Op, N> ();
+    }
+  }
+  if constexpr (sse2::ovf_kernel<Op, N> () != nullptr) {
+    if (level >= isa::sse2) {
+      return sse2::ovf_kernel<Op, N> ();
+    }
+  }
+#endif  // __GNUC__ && __x86_64__
+#endif  // NO_SIMD
+  (void)level;
+  return &batch_scalar_ovf<Op, N>;
+}
+
+/// Holds the kernel used to implement \p Op on values of \p N bits when the
+/// elements that saturate are reported. As for dispatch<>, the kernel is
+/// chosen on first use according to selected_isa().
+template <batch_op Op, size_t N>
+class ovf_dispatch {
+public:
+  /// Returns the kernel for this operation.
+  static batch_ovf_kernel_t<Op, N> get () noexcept {
+    auto kernel = kernel_.load (std::memory_order_relaxed);
+    if (kernel == nullptr) {
+      kernel = resolve_ovf_kernel<Op, N> (selected_isa ());
+      kernel_.store (kernel, std::memory_order_relaxed);
+    }
+    return kernel;
+  }
+  /// Replaces the kernel for this operation.
+  static void set (batch_ovf_kernel_t<Op, N> const kernel) noexcept {
+    kernel_.store (kernel, std::memory_order_relaxed);
+  }
+
+private:
+  static inline std::atomic<batch_ovf_kernel_t<Op, N>> kernel_{nullptr};
+};
+
+template <batch_op Op, size_t N>
+void batch_apply (span<batch_arg_t<Op, N> const> const x,
+                  span<batch_arg_t<Op, N> const> const y,
+                  span<batch_arg_t<Op, N>> const out) {
+  assert (x.size () == out.size ());  // batch x and out sizes must match
+  assert (y.size () == out.size ());  // batch y and out sizes must match
+  dispatch<Op, N>::get () (x.data (), y.data (), out.data (), out.size ());
+}
+
+template <batch_op Op, size_t N>
+void batch_apply_ovf (span<batch_arg_t<Op, N> const> const x,
+                      span<batch_arg_t<Op, N> const> const y,
+                      span<batch_arg_t<Op, N>> const out,
+                      span<uint8_t> const clipped) {
+  assert (x.size () == out.size ());  // batch x and out sizes must match
+  assert (y.size () == out.size ());  // batch y and out sizes must match
+  assert (clipped.size () >= (out.size () + 7U) / 8U);  // clipped too small
+  ovf_dispatch<Op, N>::get () (x.data (), y.data (), out.data (),
+                               clipped.data (), out.size ());
+}
+
+/// Divides the arrays \p x and \p y using the batch division kernel for
+/// \p Op and rounds the quotients according to \p Mode. The truncated
+/// quotients are produced a block at a time in a local buffer so that the
+/// dividends and divisors are still available for the correction even when
+/// \p out is the same as \p x or \p y.
+template <batch_op Op, size_t N, rounding Mode>
+void batch_round (span<batch_arg_t<Op, N> const> const x,
+                  span<batch_arg_t<Op, N> const> const y,
+                  span<batch_arg_t<Op, N>> const out) {
+  assert (x.size () == out.size ());  // batch x and out sizes must match
+  assert (y.size () == out.size ());  // batch y and out sizes must match
+  constexpr auto block_size = size_t{256};
+  auto const kernel = dispatch<Op, N>::get ();
+  std::array<batch_arg_t<Op, N>, block_size> q;
+  for (auto first = size_t{0}, size = out.size (); first < size;
+       first += block_size) {
+    auto const n = std::min (block_size, size - first);
+    auto const* const src_x = x.data () + first;
+    auto const* const src_y = y.data () + first;
+    auto* const dest = out.data () + first;
+    kernel (src_x, src_y, q.data (), n);
+    for (auto ctr = size_t{0}; ctr < n; ++ctr) {
+      dest[ctr] = round_quotient<N, Mode> (src_x[ctr], src_y[ctr], q[ctr]);
+    }
+  }
+}
+
+/// Avoids template argument deduction for a function parameter.
+template <typename T>
+struct identity {
+  using type = T;
+};
+template <typename T>
+using identity_t = typename identity<T>::type;
+
+/// True if \p T is the type named by sinteger_t<N> or uinteger_t<N> (as
+/// appropriate for its signedness) where N is the number of bits in \p T.
+template <typename T, typename = void>
+struct is_exact_integer : std::false_type {};
+template <typename T>
+struct is_exact_integer<T, std::enable_if_t<std::is_integral_v<T>>>
+    : std::bool_constant<std::is_same_v<
+          T, std::conditional_t<std::is_unsigned_v<T>,
+                                uinteger_t<sizeof (T) * CHAR_BIT>,
+                                sinteger_t<sizeof (T) * CHAR_BIT>>>> {};
+template <typename T>
+inline constexpr bool is_exact_integer_v = is_exact_integer<T>::value;
+
+}  // end namespace details
+
+namespace batch {
+
+/// \name Batch Addition
+/// Functions that perform saturating addition of arrays of integral
+/// quantities from 4 to 64 bits.
+/// @{
+
+/// \brief Adds two arrays of unsigned values each \p N bits wide.
+///
+/// For each i, sets out[i] to saturation::addu<N>(x[i], y[i]).
+///
+/// \tparam N  The number of bits for the unsigned arguments and results. May
+///   be in the range \f$ [4, 64] \f$.
+/// \param x  The first of the two arrays of values to be added.
+/// \param y  The second of the two arrays of values to be added.
+/// \param out  The array to which the results are written.
+template <size_t N, typename = typename std::enable_if_t<(N >= 4 && N <= 64)>>
+void addu (span<uinteger_t<N> const> const x,
+           span<uinteger_t<N> const> const y,
+           span<uinteger_t<N>> const out) {
+  details::batch_apply<details::batch_op::addu, N> (x, y, out);
+}
+/// \brief Adds two arrays of signed values each \p N bits wide.
+///
+/// For each i, sets out[i] to saturation::adds<N>(x[i], y[i]).
+///
+/// \tparam N  The number of bits for the signed arguments and results. May be
+///   in the range \f$ [4, 64] \f$.
+/// \param x  The first of the two arrays of values to be added.
+/// \param y  The second of the two arrays of values to be added.
+/// \param out  The array to which the results are written.
+template <size_t N, typename = typename std::enable_if_t<(N >= 4 && N <= 64)>>
+void adds (span<sinteger_t<N> const> const x,
+           span<sinteger_t<N> const> const y,
+           span<sinteger_t<N>> const out) {
+  details::batch_apply<details::batch_op::adds, N> (x, y, out);
+}
+/// \brief Adds two arrays of standard integer values.
+///
+/// Equivalent to batch::addu<N>() or batch::adds<N>() (depending on the
+/// signedness of \p T) where N is the number of bits in \p T.
+///
+/// \tparam T  A standard integer type. Must be one of the types named by
+///   saturation::sinteger_t<> or saturation::uinteger_t<>.
+/// \param x  The first of the two arrays of values to be added.
+/// \param y  The second of the two arrays of values to be added.
+/// \param out  The array to which the results are written.
+template <typename T,
+          typename = typename std::enable_if_t<details::is_exact_integer_v<T>>>
+void add (span<details::identity_t<T> const> const x,
+          span<details::identity_t<T> const> const y, span<T> const out) {
+  constexpr auto bits = sizeof (T) * CHAR_BIT;
+  if constexpr (std::is_unsigned_v<T>) {
+    addu<bits> (x, y, out);
+  } else {
+    adds<bits> (x, y, out);
+  }
+}
+/// @}
+
+/// \name Batch Subtraction
+/// Functions that perform saturating subtraction of arrays of integral
+/// quantities from 4 to 64 bits.
+/// @{
+
+/// \brief Subtracts an array of unsigned values each \p N bits wide from
+///   another.
+///
+/// For each i, sets out[i] to saturation::subu<N>(x[i], y[i]).
+///
+/// \tparam N  The number of bits for the unsigned arguments and results. May
+///   be in the range \f$ [4, 64] \f$.
+/// \param x  The values from which the elements of \p y are deducted.
+/// \param y  The values deducted from the elements of \p x.
+/// \param out  The array to which the results are written.
+template <size_t N, typename = typename std::enable_if_t<(N >= 4 && N <= 64)>>
+void subu (span<uinteger_t<N> const> const x,
+           span<uinteger_t<N> const> const y,
+           span<uinteger_t<N>> const out) {
+  details::batch_apply<details::batch_op::subu, N> (x, y, out);
+}
+/// \brief Subtracts an array of signed values each \p N bits wide from
+///   another.
+///
+/// For each i, sets out[i] to saturation::subs<N>(x[i], y[i]).
+///
+/// \tparam N  The number of bits for the signed arguments and results. May be
+///   in the range \f$ [4, 64] \f$.
+/// \param x  The values from which the elements of \p y are deducted.
+/// \param y  The values deducted from the elements of \p x.
+/// \param out  The array to which the results are written.
+template <size_t N, typename = typename std::enable_if_t<(N >= 4 && N <= 64)>>
+void subs (span<sinteger_t<N> const> const x,
+           span<sinteger_t<N> const> const y,
+           span<sinteger_t<N>> const out) {
+  details::batch_apply<details::batch_op::subs, N> (x, y, out);
+}
+/// \brief Subtracts an array of standard integer values from another.
+///
+/// Equivalent to batch::subu<N>() or batch::subs<N>() (depending on the
+/// signedness of \p T) where N is the number of bits in \p T.
+///
+/// \tparam T  A standard integer type. Must be one of the types named by
+///   saturation::sinteger_t<> or saturation::uinteger_t<>.
+/// \param x  The values from which the elements of \p y are deducted.
+/// \param y  The values deducted from the elements of \p x.
+/// \param out  The array to which the results are written.
+template <typename T,
+          typename = typename std::enable_if_t<details::is_exact_integer_v<T>>>
+void sub (span<details::identity_t<T> const> const x,
+          span<details::identity_t<T> const> const y, span<T> const out) {
+  constexpr auto bits = sizeof (T) * CHAR_BIT;
+  if constexpr (std::is_unsigned_v<T>) {
+    subu<bits> (x, y, out);
+  } else {
+    subs<bits> (x, y, out);
+  }
+}
+/// @}
+
+/// \name Batch Multiplication
+/// Functions that perform saturating multiplication of arrays of integral
+/// quantities from 4 to 64 bits.
+/// @{
+
+/// \brief Multiplies two arrays of unsigned values each \p N bits wide.
+///
+/// For each i, sets out[i] to saturation::mulu<N>(x[i], y[i]).
+///
+/// \tparam N  The number of bits for the unsigned arguments and results. May
+///   be in the range \f$ [4, 64] \f$.
+/// \param x  The first of the two arrays of values to be multiplied.
+/// \param y  The second of the two arrays of values to be multiplied.
+/// \param out  The array to which the results are written.
+template <size_t N, typename = typename std::enable_if_t<(N >= 4 && N <= 64)>>
+void mulu (span<uinteger_t<N> const> const x,
+           span<uinteger_t<N> const> const y,
+           span<uinteger_t<N>> const out) {
+  details::batch_apply<details::batch_op::mulu, N> (x, y, out);
+}
+/// \brief Multiplies two arrays of signed values each \p N bits wide.
+///
+/// For each i, sets out[i] to saturation::muls<N>(x[i], y[i]).
+///
+/// \tparam N  The number of bits for the signed arguments and results. May be
+///   in the range \f$ [4, 64] \f$.
+/// \param x  The first of the two arrays of values to be multiplied.
+/// \param y  The second of the two arrays of values to be multiplied.
+/// \param out  The array to which the results are written.
+template <size_t N, typename = typename std::enable_if_t<(N >= 4 && N <= 64)>>
+void muls (span<sinteger_t<N> const> const x,
+           span<sinteger_t<N> const> const y,
+           span<sinteger_t<N>> const out) {
+  details::batch_apply<details::batch_op::muls, N> (x, y, out);
+}
+/// \brief Multiplies two arrays of standard integer values.
+///
+/// Equivalent to batch::mulu<N>() or batch::muls<N>() (depending on the
+/// signedness of \p T) where N is the number of bits in \p T.
+///
+/// \tparam T  A standard integer type. Must be one of the types named by
+///   saturation::sinteger_t<> or saturation::uinteger_t<>.
+/// \param x  The first of the two arrays of values to be multiplied.
+/// \param y  The second of the two arrays of values to be multiplied.
+/// \param out  The array to which the results are written.
+template <typename T,
+          typename = typename std::enable_if_t<details::is_exact_integer_v<T>>>
+void mul (span<details::identity_t<T> const> const x,
+          span<details::identity_t<T> const> const y, span<T> const out) {
+  constexpr auto bits = sizeof (T) * CHAR_BIT;
+  if constexpr (std::is_unsigned_v<T>) {
+    mulu<bits> (x, y, out);
+  } else {
+    muls<bits> (x, y, out);
+  }
+}
+/// @}
+
+/// \name Batch Division
+/// Functions that perform saturating division of arrays of integral
+/// quantities from 4 to 64 bits.
+/// @{
+
+/// \brief Divides an array of unsigned values each \p N bits wide by
+///   another.
+///
+/// For each i, sets out[i] to saturation::divu<N>(x[i], y[i]).
+///
+/// \tparam N  The number of bits for the unsigned arguments and results. May
+///   be in the range \f$ [4, 64] \f$.
+/// \param x  The dividends.
+/// \param y  The divisors. No element may be 0.
+/// \param out  The array to which the results are written.
+template <size_t N, typename = typename std::enable_if_t<(N >= 4 && N <= 64)>>
+void divu (span<uinteger_t<N> const> const x,
+           span<uinteger_t<N> const> const y,
+           span<uinteger_t<N>> const out) {
+  details::batch_apply<details::batch_op::divu, N> (x, y, out);
+}
+/// \brief Divides an array of signed values each \p N bits wide by another.
+///
+/// For each i, sets out[i] to saturation::divs<N>(x[i], y[i]).
+///
+/// \tparam N  The number of bits for the signed arguments and results. May be
+///   in the range \f$ [4, 64] \f$.
+/// \param x  The dividends.
+/// \param y  The divisors. No element may be 0.
+/// \param out  The array to which the results are written.
+template <size_t N, typename = typename std::enable_if_t<(N >= 4 && N <= 64)>>
+void divs (span<sinteger_t<N> const> const x,
+           span<sinteger_t<N> const> const y,
+           span<sinteger_t<N>> const out) {
+  details::batch_apply<details::batch_op::divs, N> (x, y, out);
+}
+/// \brief Divides an array of unsigned values each \p N bits wide by
+///   another with a policy for division by zero.
+///
+/// For each i, sets out[i] to saturation::divu<N, Policy>(x[i], y[i]). With
+/// divide_by_zero::saturate, this does not branch on the value of the
+/// divisors.
+///
+/// \tparam N  The number of bits for the unsigned arguments and results. May
+///   be in the range \f$ [4, 64] \f$.
+/// \tparam Policy  The behavior if an element of \p y is zero.
+/// \param x  The dividends.
+/// \param y  The divisors.
+/// \param out  The array to which the results are written.
+template <size_t N, divide_by_zero Policy,
+          typename = typename std::enable_if_t<(N >= 4 && N <= 64)>>
+void divu (span<uinteger_t<N> const> const x,
+           span<uinteger_t<N> const> const y,
+           span<uinteger_t<N>> const out) {
+  constexpr auto op = Policy == divide_by_zero::saturate
+                          ? details::batch_op::divu_saturate
+                          : details::batch_op::divu;
+  details::batch_apply<op, N> (x, y, out);
+}
+/// \brief Divides an array of signed values each \p N bits wide by another
+///   with a policy for division by zero.
+///
+/// For each i, sets out[i] to saturation::divs<N, Policy>(x[i], y[i]). With
+/// divide_by_zero::saturate, this does not branch on the value of the
+/// divisors.
+///
+/// \tparam N  The number of bits for the signed arguments and results. May be
+///   in the range \f$ [4, 64] \f$.
+/// \tparam Policy  The behavior if an element of \p y is zero.
+/// \param x  The dividends.
+/// \param y  The divisors.
+/// \param out  The array to which the results are written.
+template <size_t N, divide_by_zero Policy,
+          typename = typename std::enable_if_t<(N >= 4 && N <= 64)>>
+void divs (span<sinteger_t<N> const> const x,
+           span<sinteger_t<N> const> const y,
+           span<sinteger_t<N>> const out) {
+  constexpr auto op = Policy == divide_by_zero::saturate
+                          ? details::batch_op::divs_saturate
+                          : details::batch_op::divs;
+  details::batch_apply<op, N> (x, y, out);
+}
+/// \brief Divides an array of standard integer values by another.
+///
+/// Equivalent to batch::divu<N, Policy>() or batch::divs<N, Policy>()
+/// (depending on the signedness of \p T) where N is the number of bits in
+/// \p T.
+///
+/// \tparam T  A standard integer type. Must be one of the types named by
+///   saturation::sinteger_t<> or saturation::uinteger_t<>.
+/// \tparam Policy  The behavior if an element of \p y is zero.
+/// \param x  The dividends.
+/// \param y  The divisors. No element may be 0 unless \p Policy is
+///   divide_by_zero::saturate.
+/// \param out  The array to which the results are written.
+template <typename T, divide_by_zero Policy = divide_by_zero::undefined,
+          typename = typename std::enable_if_t<details::is_exact_integer_v<T>>>
+void div (span<details::identity_t<T> const> const x,
+          span<details::identity_t<T> const> const y, span<T> const out) {
+  constexpr auto bits = sizeof (T) * CHAR_BIT;
+  if constexpr (std::is_unsigned_v<T>) {
+    divu<bits, Policy> (x, y, out);
+  } else {
+    divs<bits, Policy> (x, y, out);
+  }
+}
+/// @}
+
+/// \name Batch Arithmetic with Saturation Reporting
+/// Functions that perform saturating addition, subtraction, and
+/// multiplication of arrays and also report which elements saturated. Each
+/// takes an additional span \p clipped of at least (n + 7) / 8 bytes (where
+/// n is the number of elements) which receives a packed bitmask: bit i % 8 of
+/// clipped[i / 8] is set if the result for element i was clamped and
+/// cleared otherwise. Unused bits of the final byte are cleared.
+///
+/// The vector kernels for addition and subtraction compute the mask
+/// alongside the results, with one movemask (or, with AVX-512, a mask
+/// register comparison) per register. Multiplication uses the scalar
+/// functions mulu_ovf<N>() and muls_ovf<N>().
+/// @{
+
+/// For each i, sets out[i] to saturation::addu<N>(x[i], y[i]) and records
+/// whether it saturated in \p clipped.
+template <size_t N, typename = typename std::enable_if_t<(N >= 4 && N <= 64)>>
+void addu_ovf (span<uinteger_t<N> const> const x,
+               span<uinteger_t<N> const> const y,
+               span<uinteger_t<N>> const out, span<uint8_t> const clipped) {
+  details::batch_apply_ovf<details::batch_op::addu, N> (x, y, out, clipped);
+}
+/// For each i, sets out[i] to saturation::adds<N>(x[i], y[i]) and records
+/// whether it saturated in \p clipped.
+template <size_t N, typename = typename std::enable_if_t<(N >= 4 && N <= 64)>>
+void adds_ovf (span<sinteger_t<N> const> const x,
+               span<sinteger_t<N> const> const y,
+               span<sinteger_t<N>> const out, span<uint8_t> const clipped) {
+  details::batch_apply_ovf<details::batch_op::adds, N> (x, y, out, clipped);
+}
+/// For each i, sets out[i] to saturation::subu<N>(x[i], y[i]) and records
+/// whether it saturated in \p clipped.
+template <size_t N, typename = typename std::enable_if_t<(N >= 4 && N <= 64)>>
+void subu_ovf (span<uinteger_t<N> const> const x,
+               span<uinteger_t<N> const> const y,
+               span<uinteger_t<N>> const out, span<uint8_t> const clipped) {
+  details::batch_apply_ovf<details::batch_op::subu, N> (x, y, out, clipped);
+}
+/// For each i, sets out[i] to saturation::subs<N>(x[i], y[i]) and records
+/// whether it saturated in \p clipped.
+template <size_t N, typename = typename std::enable_if_t<(N >= 4 && N <= 64)>>
+void subs_ovf (span<sinteger_t<N> const> const x,
+               span<sinteger_t<N> const> const y,
+               span<sinteger_t<N>> const out, span<uint8_t> const clipped) {
+  details::batch_apply_ovf<details::batch_op::subs, N> (x, y, out, clipped);
+}
+/// For each i, sets out[i] to saturation::mulu<N>(x[i], y[i]) and records
+/// whether it saturated in \p clipped.
+template <size_t N, typename = typename std::enable_if_t<(N >= 4 && N <= 64)>>
+void mulu_ovf (span<uinteger_t<N> const> const x,
+               span<uinteger_t<N> const> const y,
+               span<uinteger_t<N>> const out, span<uint8_t> const clipped) {
+  details::batch_apply_ovf<details::batch_op::mulu, N> (x, y, out, clipped);
+}
+/// For each i, sets out[i] to saturation::muls<N>(x[i], y[i]) and records
+/// whether it saturated in \p clipped.
+template <size_t N, typename = typename std::enable_if_t<(N >= 4 && N <= 64)>>
+void muls_ovf (span<sinteger_t<N> const> const x,
+               span<sinteger_t<N> const> const y,
+               span<sinteger_t<N>> const out, span<uint8_t> const clipped) {
+  details::batch_apply_ovf<details::batch_op::muls, N> (x, y, out, clipped);
+}
+/// @}
+
+/// \name Batch Division with Rounding
+/// @{
+
+/// \brief Divides an array of unsigned values each \p N bits wide by another
+///   and rounds the quotients.
+///
+/// For each i, sets out[i] to saturation::divu_round<N, Mode>(x[i], y[i]).
+/// The truncated quotients are computed by the same kernel as batch::divu<N>()
+/// and then corrected by a branch-free loop which the compiler is able to
+/// vectorize.
+///
+/// \tparam N  The number of bits for the unsigned arguments and results. May
+///   be in the range \f$ [4, 64] \f$.
+/// \tparam Mode  The rounding mode.
+/// \param x  The dividends.
+/// \param y  The divisors. No element may be 0.
+/// \param out  The array to which the results are written.
+template <size_t N, rounding Mode,
+          typename = typename std::enable_if_t<(N >= 4 && N <= 64)>>
+void divu_round (span<uinteger_t<N> const> const x,
+                 span<uinteger_t<N> const> const y,
+                 span<uinteger_t<N>> const out) {
+  details::batch_round<details::batch_op::divu, N, Mode> (x, y, out);
+}
+/// \brief Divides an array of signed values each \p N bits wide by another
+///   and rounds the quotients.
+///
+/// For each i, sets out[i] to saturation::divs_round<N, Mode>(x[i], y[i]).
+/// The truncated quotients are computed by the same kernel as batch::divs<N>()
+/// and then corrected by a branch-free loop which the compiler is able to
+/// vectorize.
+///
+/// \tparam N  The number of bits for the signed arguments and results. May be
+///   in the range \f$ [4, 64] \f$.
+/// \tparam Mode  The rounding mode.
+/// \param x  The dividends.
+/// \param y  The divisors. No element may be 0.
+/// \param out  The array to which the results are written.
+template <size_t N, rounding Mode,
+          typename = typename std::enable_if_t<(N >= 4 && N <= 64)>>
+void divs_round (span<sinteger_t<N> const> const x,
+                 span<sinteger_t<N> const> const y,
+                 span<sinteger_t<N>> const out) {
+  details::batch_round<details::batch_op::divs, N, Mode> (x, y, out);
+}
+/// @}
+
+}  // end namespace batch
+
+}  // end namespace saturation
+
+#endif  // SATURATION_BATCH_HPP
@@ -0,0 +1,852 @@
+/// \file batch_avx2.hpp
+/// \brief Batch kernels using the x86 AVX2 instruction set. These kernels
+/// are compiled for every x86-64 target and selected at run time when the
+/// host processor supports them.
+
+#ifndef SATURATION_BATCH_AVX2_HPP
+#define SATURATION_BATCH_AVX2_HPP
+
+#include "saturation/batch_kernel.hpp"
+
+#ifndef NO_SIMD
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+
+/// Enables AVX2 instructions in a function regardless of the options with which
+/// the compiler was invoked. Such functions must only be called if
+/// selected_isa() reports that the host supports them.
+#define SATURATION_TARGET_AVX2 __attribute__ ((target ("avx2")))
+
+namespace saturation {
+
+namespace details {
+
+namespace avx2 {
+
+/// Defines the vector implementation of the operation \p Op on lanes of \p N
+/// bits. The primary template is used when AVX2 provides no implementation.
+template <batch_op Op, size_t N, typename = void>
+struct lanes {
+  static constexpr bool available = false;
+};
+
+template <>
+struct lanes<batch_op::addu, 8> {
+  static constexpr bool available = true;
+  SATURATION_TARGET_AVX2 static __m256i apply (__m256i const x,
+                                               __m256i const y) {
+    return _mm256_adds_epu8 (x, y);  // vpaddusb
+  }
+};
+template <>
+struct lanes<batch_op::adds, 8> {
+  static constexpr bool available = true;
+  SATURATION_TARGET_AVX2 static __m256i apply (__m256i const x,
+                                               __m256i const y) {
+    return _mm256_adds_epi8 (x, y);  // vpaddsb
+  }
+};
+template <>
+struct lanes<batch_op::subu, 8> {
+  static constexpr bool available = true;
+  SATURATION_TARGET_AVX2 static __m256i apply (__m256i const x,
+                                               __m256i const y) {
+    return _mm256_subs_epu8 (x, y);  // vpsubusb
+  }
+};
+template <>
+struct lanes<batch_op::subs, 8> {
+  static constexpr bool available = true;
+  SATURATION_TARGET_AVX2 static __m256i apply (__m256i const x,
+                                               __m256i const y) {
+    return _mm256_subs_epi8 (x, y);  // vpsubsb
+  }
+};
+template <>
+struct lanes<batch_op::addu, 16> {
+  static constexpr bool available = true;
+  SATURATION_TARGET_AVX2 static __m256i apply (__m256i const x,
+                                               __m256i const y) {
+    return _mm256_adds_epu16 (x, y);  // vpaddusw
+  }
+};
+template <>
+struct lanes<batch_op::adds, 16> {
+  static constexpr bool available = true;
+  SATURATION_TARGET_AVX2 static __m256i apply (__m256i const x,
+                                               __m256i const y) {
+    return _mm256_adds_epi16 (x, y);  // vpaddsw
+  }
+};
+template <>
+struct lanes<batch_op::subu, 16> {
+  static constexpr bool available = true;
+  SATURATION_TARGET_AVX2 static __m256i apply (__m256i const x,
+                                               __m256i const y) {
+    return _mm256_subs_epu16 (x, y);  // vpsubusw
+  }
+};
+template <>
+struct lanes<batch_op::subs, 16> {
+  static constexpr bool available = true;
+  SATURATION_TARGET_AVX2 static __m256i apply (__m256i const x,
+                                               __m256i const y) {
+    return _mm256_subs_epi16 (x, y);  // vpsubsw
+  }
+};
+
+/// \name Lane helpers
+/// Helper functions which select the instruction appropriate for lanes of
+/// \p N bits where \p N is 32 or 64. add() and sub() also accept 8 and 16.
+/// @{
+
+template <size_t N>
+SATURATION_TARGET_AVX2 inline __m256i add (__m256i const x, __m256i const y) {
+  if constexpr (N == 8) {
+    return _mm256_add_epi8 (x, y);
+  } else if constexpr (N == 16) {
+    return _mm256_add_epi16 (x, y);
+  } else if constexpr (N == 32) {
+    return _mm256_add_epi32 (x, y);
+  } else {
+    return _mm256_add_epi64 (x, y);
+  }
+}
+template <size_t N>
+SATURATION_TARGET_AVX2 inline __m256i sub (__m256i const x, __m256i const y) {
+  if constexpr (N == 8) {
+    return _mm256_sub_epi8 (x, y);
+  } else if constexpr (N == 16) {
+    return _mm256_sub_epi16 (x, y);
+  } else if constexpr (N == 32) {
+    return _mm256_sub_epi32 (x, y);
+  } else {
+    return _mm256_sub_epi64 (x, y);
+  }
+}
+/// Computes the value to which each lane of a signed operation saturates:
+/// max or min depending on the sign of \p x. This is the vector form of
+/// details::adds_overflow_value().
+template <size_t N>
+SATURATION_TARGET_AVX2 inline __m256i overflow_value (__m256i const x) {
+  if constexpr (N == 32) {
+    return _mm256_add_epi32 (_mm256_srli_epi32 (x, 31),
+                             _mm256_set1_epi32 (slimits<32>::max ()));
+  } else {
+    return _mm256_add_epi64 (_mm256_srli_epi64 (x, 63),
+                             _mm256_set1_epi64x (slimits<64>::max ()));
+  }
+}
+/// Returns the lanes of \p x where the most significant bit of the
+/// corresponding lane of \p mask is clear and the lanes of \p y where it is
+/// set.
+template <size_t N>
+SATURATION_TARGET_AVX2 inline __m256i blend (__m256i const mask,
+                                             __m256i const x, __m256i const y) {
+  if constexpr (N == 32) {
+    auto const result =
+        _mm256_blendv_ps (_mm256_castsi256_ps (x), _mm256_castsi256_ps (y),
+                          _mm256_castsi256_ps (mask));
+    return _mm256_castps_si256 (result);
+  } else {
+    auto const result =
+        _mm256_blendv_pd (_mm256_castsi256_pd (x), _mm256_castsi256_pd (y),
+                          _mm256_castsi256_pd (mask));
+    return _mm256_castpd_si256 (result);
+  }
+}
+/// @}
+
+// There are no packed saturating instructions for 32 and 64 bit lanes. AVX2
+// provides unsigned min/max for 32 bit lanes; otherwise the carry (or
+// overflow) of each lane is computed in its most significant bit and used to
+// blend the wrapped and saturated results.
+template <>
+struct lanes<batch_op::addu, 32> {
+  static constexpr bool available = true;
+  SATURATION_TARGET_AVX2 static __m256i apply (__m256i const x,
+                                               __m256i const y) {
+    // y + min(x, ~y) is y + x if that does not overflow or 2^32-1 if it does.
+    auto const not_y = _mm256_xor_si256 (y, _mm256_set1_epi32 (-1));
+    return _mm256_add_epi32 (y, _mm256_min_epu32 (x, not_y));
+  }
+};
+template <>
+struct lanes<batch_op::subu, 32> {
+  static constexpr bool available = true;
+  SATURATION_TARGET_AVX2 static __m256i apply (__m256i const x,
+                                               __m256i const y) {
+    // max(x, y) - y is x - y if x >= y or 0 otherwise.
+    return _mm256_sub_epi32 (_mm256_max_epu32 (x, y), y);
+  }
+};
+template <>
+struct lanes<batch_op::addu, 64> {
+  static constexpr bool available = true;
+  SATURATION_TARGET_AVX2 static __m256i apply (__m256i const x,
+                                               __m256i const y) {
+    auto const sum = _mm256_add_epi64 (x, y);
+    // carry = (x & y) | ((x | y) & ~sum)
+    auto const carry =
+        _mm256_or_si256 (_mm256_and_si256 (x, y),
+                         _mm256_andnot_si256 (sum, _mm256_or_si256 (x, y)));
+    return blend<64> (carry, sum, _mm256_set1_epi64x (-1));
+  }
+};
+template <>
+struct lanes<batch_op::subu, 64> {
+  static constexpr bool available = true;
+  SATURATION_TARGET_AVX2 static __m256i apply (__m256i const x,
+                                               __m256i const y) {
+    auto const diff = _mm256_sub_epi64 (x, y);
+    // borrow = (~x & y) | (~(x ^ y) & diff)
+    auto const borrow =
+        _mm256_or_si256 (_mm256_andnot_si256 (x, y),
+                         _mm256_andnot_si256 (_mm256_xor_si256 (x, y), diff));
+    return blend<64> (borrow, diff, _mm256_setzero_si256 ());
+  }
+};
+template <size_t N>
+struct lanes<batch_op::adds, N, std::enable_if_t<N == 32 || N == 64>> {
+  static constexpr bool available = true;
+  SATURATION_TARGET_AVX2 static __m256i apply (__m256i const x,
+                                               __m256i const y) {
+    auto const sum = add<N> (x, y);
+    // Overflow if x and y have the same sign and the sign of sum differs.
+    auto const overflow = _mm256_andnot_si256 (_mm256_xor_si256 (x, y),
+                                               _mm256_xor_si256 (x, sum));
+    return blend<N> (overflow, sum, overflow_value<N> (x));
+  }
+};
+template <size_t N>
+struct lanes<batch_op::subs, N, std::enable_if_t<N == 32 || N == 64>> {
+  static constexpr bool available = true;
+  SATURATION_TARGET_AVX2 static __m256i apply (__m256i const x,
+                                               __m256i const y) {
+    auto const diff = sub<N> (x, y);
+    // Overflow if x and y have different signs and the sign of diff differs
+    // from that of x.
+    auto const overflow =
+        _mm256_and_si256 (_mm256_xor_si256 (x, y), _mm256_xor_si256 (x, diff));
+    return blend<N> (overflow, diff, overflow_value<N> (x));
+  }
+};
+
+/// \name Padded lane helpers
+/// Signed lanes of 8, 16 or 32 bits for values which do not fill them (see
+/// is_padded_width()). AVX2 has signed min and max for each of these widths.
+/// @{
+
+/// Returns a value with every lane set to \p v.
+template <size_t N>
+SATURATION_TARGET_AVX2 inline __m256i set1 (int64_t const v) {
+  if constexpr (N == 8) {
+    return _mm256_set1_epi8 (static_cast<char> (v));
+  } else if constexpr (N == 16) {
+    return _mm256_set1_epi16 (static_cast<short> (v));
+  } else {
+    return _mm256_set1_epi32 (static_cast<int> (v));
+  }
+}
+/// Returns the lanewise signed minimum of \p x and \p y.
+template <size_t N>
+SATURATION_TARGET_AVX2 inline __m256i min (__m256i const x, __m256i const y) {
+  if constexpr (N == 8) {
+    return _mm256_min_epi8 (x, y);
+  } else if constexpr (N == 16) {
+    return _mm256_min_epi16 (x, y);
+  } else {
+    return _mm256_min_epi32 (x, y);
+  }
+}
+/// Returns the lanewise signed maximum of \p x and \p y.
+template <size_t N>
+SATURATION_TARGET_AVX2 inline __m256i max (__m256i const x, __m256i const y) {
+  if constexpr (N == 8) {
+    return _mm256_max_epi8 (x, y);
+  } else if constexpr (N == 16) {
+    return _mm256_max_epi16 (x, y);
+  } else {
+    return _mm256_max_epi32 (x, y);
+  }
+}
+/// @}
+
+// The kernels for values which do not fill their lanes.
+template <size_t N>
+struct lanes<batch_op::addu, N, std::enable_if_t<is_padded_width (N)>> {
+  static constexpr bool available = true;
+  SATURATION_TARGET_AVX2 static __m256i apply (__m256i const x,
+                                               __m256i const y) {
+    constexpr auto lane = lane_width<batch_op::addu, N> ();
+    constexpr auto upper = ulimits<N>::max ();
+    return add<lane> (x, min<lane> (y, sub<lane> (set1<lane> (upper), x)));
+  }
+};
+template <size_t N>
+struct lanes<batch_op::subu, N, std::enable_if_t<is_padded_width (N)>> {
+  static constexpr bool available = true;
+  SATURATION_TARGET_AVX2 static __m256i apply (__m256i const x,
+                                               __m256i const y) {
+    constexpr auto lane = lane_width<batch_op::subu, N> ();
+    return max<lane> (sub<lane> (x, y), _mm256_setzero_si256 ());
+  }
+};
+template <size_t N>
+struct lanes<batch_op::adds, N, std::enable_if_t<is_padded_width (N)>> {
+  static constexpr bool available = true;
+  SATURATION_TARGET_AVX2 static __m256i apply (__m256i const x,
+                                               __m256i const y) {
+    constexpr auto lane = lane_width<batch_op::adds, N> ();
+    constexpr auto upper = slimits<N>::max ();
+    constexpr auto lower = slimits<N>::min ();
+    return max<lane> (min<lane> (add<lane> (x, y), set1<lane> (upper)),
+                      set1<lane> (lower));
+  }
+};
+template <size_t N>
+struct lanes<batch_op::subs, N, std::enable_if_t<is_padded_width (N)>> {
+  static constexpr bool available = true;
+  SATURATION_TARGET_AVX2 static __m256i apply (__m256i const x,
+                                               __m256i const y) {
+    constexpr auto lane = lane_width<batch_op::subs, N> ();
+    constexpr auto upper = slimits<N>::max ();
+    constexpr auto lower = slimits<N>::min ();
+    return max<lane> (min<lane> (sub<lane> (x, y), set1<lane> (upper)),
+                      set1<lane> (lower));
+  }
+};
+
+/// \name Multiplication helpers
+/// @{
+
+/// The low- and high-order halves of the double-width products of the lanes
+/// of two vectors.
+struct wide_product {
+  __m256i lo;
+  __m256i hi;
+};
+
+/// Multiplies the 32 bit lanes of \p x and \p y. vpmuludq/vpmuldq multiply
+/// only the even lanes so the odd lanes are shifted into the even positions
+/// and multiplied separately.
+template <bool IsUnsigned>
+SATURATION_TARGET_AVX2 inline wide_product mul_wide_epi32 (__m256i const x,
+                                                           __m256i const y) {
+  auto const x_odd = _mm256_srli_epi64 (x, 32);
+  auto const y_odd = _mm256_srli_epi64 (y, 32);
+  auto even = __m256i{};
+  auto odd = __m256i{};
+  if constexpr (IsUnsigned) {
+    even = _mm256_mul_epu32 (x, y);
+    odd = _mm256_mul_epu32 (x_odd, y_odd);
+  } else {
+    even = _mm256_mul_epi32 (x, y);
+    odd = _mm256_mul_epi32 (x_odd, y_odd);
+  }
+  auto const low_mask = _mm256_set1_epi64x (0xFFFFFFFF);
+  return {_mm256_or_si256 (_mm256_and_si256 (even, low_mask),
+                           _mm256_slli_epi64 (odd, 32)),
+          _mm256_or_si256 (_mm256_srli_epi64 (even, 32),
+                           _mm256_andnot_si256 (low_mask, odd))};
+}
+/// Multiplies the unsigned 64 bit lanes of \p x and \p y. This is the vector
+/// form of details::multiply(): the product is assembled from four 32 x 32
+/// bit partial products.
+SATURATION_TARGET_AVX2 inline wide_product mul_wide_epu64 (__m256i const x,
+                                                           __m256i const y) {
+  auto const low_mask = _mm256_set1_epi64x (0xFFFFFFFF);
+  auto const x_hi = _mm256_srli_epi64 (x, 32);
+  auto const y_hi = _mm256_srli_epi64 (y, 32);
+  auto const lo_lo = _mm256_mul_epu32 (x, y);
+  auto const hi_lo = _mm256_mul_epu32 (x_hi, y);
+  auto const lo_hi = _mm256_mul_epu32 (x, y_hi);
+  auto const hi_hi = _mm256_mul_epu32 (x_hi, y_hi);
+  // The sum of the middle terms cannot overflow 64 bits.
+  auto const mid = _mm256_add_epi64 (
+      _mm256_add_epi64 (_mm256_srli_epi64 (lo_lo, 32),
+                        _mm256_and_si256 (hi_lo, low_mask)),
+      _mm256_and_si256 (lo_hi, low_mask));
+  auto const hi = _mm256_add_epi64 (
+      _mm256_add_epi64 (hi_hi, _mm256_srli_epi64 (mid, 32)),
+      _mm256_add_epi64 (_mm256_srli_epi64 (hi_lo, 32),
+                        _mm256_srli_epi64 (lo_hi, 32)));
+  return {_mm256_or_si256 (_mm256_and_si256 (lo_lo, low_mask),
+                           _mm256_slli_epi64 (mid, 32)),
+          hi};
+}
+/// Multiplies the signed 64 bit lanes of \p x and \p y. The high half of the
+/// signed product is derived from the unsigned product by subtracting y (or
+/// x) where x (or y) is negative.
+SATURATION_TARGET_AVX2 inline wide_product mul_wide_epi64 (__m256i const x,
+                                                           __m256i const y) {
+  auto const zero = _mm256_setzero_si256 ();
+  auto product = mul_wide_epu64 (x, y);
+  product.hi = _mm256_sub_epi64 (
+      _mm256_sub_epi64 (product.hi,
+                        _mm256_and_si256 (_mm256_cmpgt_epi64 (zero, x), y)),
+      _mm256_and_si256 (_mm256_cmpgt_epi64 (zero, y), x));
+  return product;
+}
+/// Returns a value in which each lane is all ones if the corresponding lanes
+/// of \p x and \p y are equal and zero otherwise.
+template <size_t N>
+SATURATION_TARGET_AVX2 inline __m256i equal (__m256i const x,
+                                             __m256i const y) {
+  if constexpr (N == 32) {
+    return _mm256_cmpeq_epi32 (x, y);
+  } else {
+    return _mm256_cmpeq_epi64 (x, y);
+  }
+}
+/// Returns a value in which each lane is the arithmetic right shift of the
+/// corresponding lane of \p x by N-1 bits: all ones if it is negative and
+/// zero otherwise.
+template <size_t N>
+SATURATION_TARGET_AVX2 inline __m256i sign_mask (__m256i const x) {
+  if constexpr (N == 32) {
+    return _mm256_srai_epi32 (x, 31);
+  } else {
+    return _mm256_cmpgt_epi64 (_mm256_setzero_si256 (), x);
+  }
+}
+/// @}
+
+template <>
+struct lanes<batch_op::mulu, 8> {
+  static constexpr bool available = true;
+  SATURATION_TARGET_AVX2 static __m256i apply (__m256i const x,
+                                               __m256i const y) {
+    // Widen to 16 bits, multiply, then clamp to 255 before packing back to 8
+    // bits. (The unpack and pack instructions operate within each 128 bit
+    // half so the order of the lanes is preserved.)
+    auto const zero = _mm256_setzero_si256 ();
+    auto const limit = _mm256_set1_epi16 (0xFF);
+    auto const lo = _mm256_mullo_epi16 (_mm256_unpacklo_epi8 (x, zero),
+                                        _mm256_unpacklo_epi8 (y, zero));
+    auto const hi = _mm256_mullo_epi16 (_mm256_unpackhi_epi8 (x, zero),
+                                        _mm256_unpackhi_epi8 (y, zero));
+    return _mm256_packus_epi16 (_mm256_min_epu16 (lo, limit),
+                                _mm256_min_epu16 (hi, limit));
+  }
+};
+template <>
+struct lanes<batch_op::muls, 8> {
+  static constexpr bool available = true;
+  SATURATION_TARGET_AVX2 static __m256i apply (__m256i const x,
+                                               __m256i const y) {
+    // Sign-extend to 16 bits (where the product cannot overflow), multiply,
+    // and pack back to 8 bits with signed saturation.
+    auto const x_lo = _mm256_srai_epi16 (_mm256_unpacklo_epi8 (x, x), 8);
+    auto const y_lo = _mm256_srai_epi16 (_mm256_unpacklo_epi8 (y, y), 8);
+    auto const x_hi = _mm256_srai_epi16 (_mm256_unpackhi_epi8 (x, x), 8);
+    auto const y_hi = _mm256_srai_epi16 (_mm256_unpackhi_epi8 (y, y), 8);
+    return _mm256_packs_epi16 (_mm256_mullo_epi16 (x_lo, y_lo),
+                               _mm256_mullo_epi16 (x_hi, y_hi));
+  }
+};
+template <>
+struct lanes<batch_op::mulu, 16> {
+  static constexpr bool available = true;
+  SATURATION_TARGET_AVX2 static __m256i apply (__m256i const x,
+                                               __m256i const y) {
+    // vpmullw/vpmulhuw yield the low and high halves of the product. Lanes
+    // with a non-zero high half saturate.
+    auto const lo = _mm256_mullo_epi16 (x, y);
+    auto const hi = _mm256_mulhi_epu16 (x, y);
+    auto const overflow = _mm256_xor_si256 (
+        _mm256_cmpeq_epi16 (hi, _mm256_setzero_si256 ()),
+        _mm256_set1_epi16 (-1));
+    return _mm256_or_si256 (lo, overflow);
+  }
+};
+template <>
+struct lanes<batch_op::muls, 16> {
+  static constexpr bool available = true;
+  SATURATION_TARGET_AVX2 static __m256i apply (__m256i const x,
+                                               __m256i const y) {
+    // vpmullw/vpmulhw yield the low and high halves of the product.
+    // Interleaving them gives the 32 bit products which vpackssdw saturates
+    // to 16 bits.
+    auto const lo = _mm256_mullo_epi16 (x, y);
+    auto const hi = _mm256_mulhi_epi16 (x, y);
+    return _mm256_packs_epi32 (_mm256_unpacklo_epi16 (lo, hi),
+                               _mm256_unpackhi_epi16 (lo, hi));
+  }
+};
+template <size_t N>
+struct lanes<batch_op::mulu, N, std::enable_if_t<N == 32 || N == 64>> {
+  static constexpr bool available = true;
+  SATURATION_TARGET_AVX2 static __m256i apply (__m256i const x,
+                                               __m256i const y) {
+    // As mulu<>: lanes with a non-zero high half saturate.
+    auto product = wide_product{};
+    if constexpr (N == 32) {
+      product = mul_wide_epi32<true> (x, y);
+    } else {
+      product = mul_wide_epu64 (x, y);
+    }
+    auto const no_overflow = equal<N> (product.hi, _mm256_setzero_si256 ());
+    return _mm256_blendv_epi8 (_mm256_set1_epi32 (-1), product.lo,
+                               no_overflow);
+  }
+};
+template <size_t N>
+struct lanes<batch_op::muls, N, std::enable_if_t<N == 32 || N == 64>> {
+  static constexpr bool available = true;
+  SATURATION_TARGET_AVX2 static __m256i apply (__m256i const x,
+                                               __m256i const y) {
+    // As muls<>: the product fits if the high half is the sign extension of
+    // the low half. If not, the result saturates according to the sign of
+    // x ^ y (see details::overflow_value()).
+    auto product = wide_product{};
+    if constexpr (N == 32) {
+      product = mul_wide_epi32<false> (x, y);
+    } else {
+      product = mul_wide_epi64 (x, y);
+    }
+    auto const fits = equal<N> (product.hi, sign_mask<N> (product.lo));
+    return _mm256_blendv_epi8 (overflow_value<N> (_mm256_xor_si256 (x, y)),
+                               product.lo, fits);
+  }
+};
+
+/// \name Division helpers
+/// There are no integer division instructions. Instead, lanes are converted
+/// to floating point, divided, and the quotient truncated (see the SSE2
+/// implementation).
+/// @{
+
+/// Divides 32 bit lanes holding signed values of no more than 16 bits and
+/// truncates the quotient.
+SATURATION_TARGET_AVX2 inline __m256i div_ps (__m256i const x,
+                                              __m256i const y) {
+  return _mm256_cvttps_epi32 (
+      _mm256_div_ps (_mm256_cvtepi32_ps (x), _mm256_cvtepi32_ps (y)));
+}
+/// Sign-extends the low (\p Hi false) or high (\p Hi true) four 16 bit lanes
+/// of each 128 bit half of \p x to 32 bits.
+template <bool Hi>
+SATURATION_TARGET_AVX2 inline __m256i widen_epi16 (__m256i const x) {
+  if constexpr (Hi) {
+    return _mm256_srai_epi32 (_mm256_unpackhi_epi16 (x, x), 16);
+  } else {
+    return _mm256_srai_epi32 (_mm256_unpacklo_epi16 (x, x), 16);
+  }
+}
+/// Converts four unsigned 32 bit values to double.
+SATURATION_TARGET_AVX2 inline __m256d cvtepu32_pd (__m128i const x) {
+  // Bias the value into the signed range, convert, and remove the bias.
+  auto const bias = _mm_set1_epi32 (slimits<32>::min ());
+  return _mm256_add_pd (_mm256_cvtepi32_pd (_mm_xor_si128 (x, bias)),
+                        _mm256_set1_pd (2147483648.0));
+}
+/// Truncates four unsigned values to 32 bits.
+SATURATION_TARGET_AVX2 inline __m128i cvttpd_epu32 (__m256d const q) {
+  // vcvttpd2dq produces 0x80000000 for values too large to be represented
+  // (that is, 2^31 or more). Those are converted again after subtracting
+  // 2^31.
+  auto const min = _mm_set1_epi32 (slimits<32>::min ());
+  auto const small = _mm256_cvttpd_epi32 (q);
+  auto const large = _mm_xor_si128 (
+      _mm256_cvttpd_epi32 (_mm256_sub_pd (q, _mm256_set1_pd (2147483648.0))),
+      min);
+  return _mm_blendv_epi8 (small, large, _mm_cmpeq_epi32 (small, min));
+}
+/// Combines two 128 bit values into the low and high halves of a 256 bit
+/// value.
+SATURATION_TARGET_AVX2 inline __m256i combine (__m128i const lo,
+                                               __m128i const hi) {
+  return _mm256_inserti128_si256 (_mm256_castsi128_si256 (lo), hi, 1);
+}
+/// @}
+
+template <>
+struct lanes<batch_op::divu, 16> {
+  static constexpr bool available = true;
+  SATURATION_TARGET_AVX2 static __m256i apply (__m256i const x,
+                                               __m256i const y) {
+    auto const zero = _mm256_setzero_si256 ();
+    auto const lo = div_ps (_mm256_unpacklo_epi16 (x, zero),
+                            _mm256_unpacklo_epi16 (y, zero));
+    auto const hi = div_ps (_mm256_unpackhi_epi16 (x, zero),
+                            _mm256_unpackhi_epi16 (y, zero));
+    return _mm256_packus_epi32 (lo, hi);
+  }
+};
+template <>
+struct lanes<batch_op::divs, 16> {
+  static constexpr bool available = true;
+  SATURATION_TARGET_AVX2 static __m256i apply (__m256i const x,
+                                               __m256i const y) {
+    // vpackssdw saturates -2^15 / -1 = 2^15 to 2^15-1.
+    auto const lo = div_ps (widen_epi16<false> (x), widen_epi16<false> (y));
+    auto const hi = div_ps (widen_epi16<true> (x), widen_epi16<true> (y));
+    return _mm256_packs_epi32 (lo, hi);
+  }
+};
+template <>
+struct lanes<batch_op::divu, 8> {
+  static constexpr bool available = true;
+  SATURATION_TARGET_AVX2 static __m256i apply (__m256i const x,
+                                               __m256i const y) {
+    // Widen to 16 bits and divide. The quotients fit in 8 bits.
+    using divide = lanes<batch_op::divu, 16>;
+    auto const zero = _mm256_setzero_si256 ();
+    return _mm256_packus_epi16 (divide::apply (_mm256_unpacklo_epi8 (x, zero),
+                                               _mm256_unpacklo_epi8 (y, zero)),
+                                divide::apply (_mm256_unpackhi_epi8 (x, zero),
+                                               _mm256_unpackhi_epi8 (y, zero)));
+  }
+};
+template <>
+struct lanes<batch_op::divs, 8> {
+  static constexpr bool available = true;
+  SATURATION_TARGET_AVX2 static __m256i apply (__m256i const x,
+                                               __m256i const y) {
+    // Sign-extend to 16 bits and divide. vpacksswb saturates -2^7 / -1.
+    using divide = lanes<batch_op::divs, 16>;
+    auto const x_lo = _mm256_srai_epi16 (_mm256_unpacklo_epi8 (x, x), 8);
+    auto const y_lo = _mm256_srai_epi16 (_mm256_unpacklo_epi8 (y, y), 8);
+    auto const x_hi = _mm256_srai_epi16 (_mm256_unpackhi_epi8 (x, x), 8);
+    auto const y_hi = _mm256_srai_epi16 (_mm256_unpackhi_epi8 (y, y), 8);
+    return _mm256_packs_epi16 (divide::apply (x_lo, y_lo),
+                               divide::apply (x_hi, y_hi));
+  }
+};
+template <>
+struct lanes<batch_op::divu, 32> {
+  static constexpr bool available = true;
+  SATURATION_TARGET_AVX2 static __m256i apply (__m256i const x,
+                                               __m256i const y) {
+    auto const x_lo = _mm256_castsi256_si128 (x);
+    auto const y_lo = _mm256_castsi256_si128 (y);
+    auto const x_hi = _mm256_extracti128_si256 (x, 1);
+    auto const y_hi = _mm256_extracti128_si256 (y, 1);
+    return combine (
+        cvttpd_epu32 (_mm256_div_pd (cvtepu32_pd (x_lo), cvtepu32_pd (y_lo))),
+        cvttpd_epu32 (_mm256_div_pd (cvtepu32_pd (x_hi), cvtepu32_pd (y_hi))));
+  }
+};
+template <>
+struct lanes<batch_op::divs, 32> {
+  static constexpr bool available = true;
+  SATURATION_TARGET_AVX2 static __m256i apply (__m256i const x,
+                                               __m256i const y) {
+    // -2^31 / -1 = 2^31 is clamped to 2^31-1 before it is converted.
+    auto const max = _mm256_set1_pd (slimits<32>::max ());
+    auto const x_lo = _mm256_castsi256_si128 (x);
+    auto const y_lo = _mm256_castsi256_si128 (y);
+    auto const x_hi = _mm256_extracti128_si256 (x, 1);
+    auto const y_hi = _mm256_extracti128_si256 (y, 1);
+    auto const lo = _mm256_cvttpd_epi32 (_mm256_min_pd (
+        _mm256_div_pd (_mm256_cvtepi32_pd (x_lo), _mm256_cvtepi32_pd (y_lo)),
+        max));
+    auto const hi = _mm256_cvttpd_epi32 (_mm256_min_pd (
+        _mm256_div_pd (_mm256_cvtepi32_pd (x_hi), _mm256_cvtepi32_pd (y_hi)),
+        max));
+    return combine (lo, hi);
+  }
+};
+
+/// \name Divide-by-zero helpers
+/// Helper functions for the divide_by_zero::saturate policy which select the
+/// instruction appropriate for lanes of \p N bits where \p N is 8, 16 or 32.
+/// @{
+
+/// Returns a value in which each lane is all ones if the corresponding lane
+/// of \p x is zero and zero otherwise.
+template <size_t N>
+SATURATION_TARGET_AVX2 inline __m256i is_zero (__m256i const x) {
+  auto const zero = _mm256_setzero_si256 ();
+  if constexpr (N == 8) {
+    return _mm256_cmpeq_epi8 (x, zero);
+  } else if constexpr (N == 16) {
+    return _mm256_cmpeq_epi16 (x, zero);
+  } else {
+    return _mm256_cmpeq_epi32 (x, zero);
+  }
+}
+/// Replaces the lanes of the divisor \p y which are zero (those which are all
+/// ones in \p zero) with 1.
+template <size_t N>
+SATURATION_TARGET_AVX2 inline __m256i nonzero (__m256i const y,
+                                               __m256i const zero) {
+  if constexpr (N == 8) {
+    return _mm256_sub_epi8 (y, zero);
+  } else if constexpr (N == 16) {
+    return _mm256_sub_epi16 (y, zero);
+  } else {
+    return _mm256_sub_epi32 (y, zero);
+  }
+}
+/// Computes the value to which each lane of a signed division by zero
+/// saturates: max, min, or zero depending on the sign of \p x.
+template <size_t N>
+SATURATION_TARGET_AVX2 inline __m256i divide_by_zero_value (__m256i const x) {
+  auto const zero = _mm256_setzero_si256 ();
+  auto max = __m256i{};
+  auto negative = __m256i{};
+  if constexpr (N == 8) {
+    max = _mm256_set1_epi8 (slimits<8>::max ());
+    negative = _mm256_cmpgt_epi8 (zero, x);
+  } else if constexpr (N == 16) {
+    max = _mm256_set1_epi16 (slimits<16>::max ());
+    negative = _mm256_cmpgt_epi16 (zero, x);
+  } else {
+    max = _mm256_set1_epi32 (slimits<32>::max ());
+    negative = _mm256_cmpgt_epi32 (zero, x);
+  }
+  // max ^ -1 is min.
+  return _mm256_andnot_si256 (is_zero<N> (x), _mm256_xor_si256 (max, negative));
+}
+/// @}
+
+// Division with the divide_by_zero::saturate policy replaces zero divisors
+// with 1 then overwrites the corresponding quotients.
+template <size_t N>
+struct lanes<batch_op::divu_saturate, N,
+             std::enable_if_t<N == 8 || N == 16 || N == 32>> {
+  static constexpr bool available = true;
+  SATURATION_TARGET_AVX2 static __m256i apply (__m256i const x,
+                                               __m256i const y) {
+    auto const zero = is_zero<N> (y);
+    auto const q = lanes<batch_op::divu, N>::apply (x, nonzero<N> (y, zero));
+    // The quotient is x: OR with all ones unless x is 0.
+    return _mm256_or_si256 (q, _mm256_andnot_si256 (is_zero<N> (x), zero));
+  }
+};
+template <size_t N>
+struct lanes<batch_op::divs_saturate, N,
+             std::enable_if_t<N == 8 || N == 16 || N == 32>> {
+  static constexpr bool available = true;
+  SATURATION_TARGET_AVX2 static __m256i apply (__m256i const x,
+                                               __m256i const y) {
+    auto const zero = is_zero<N> (y);
+    auto const q = lanes<batch_op::divs, N>::apply (x, nonzero<N> (y, zero));
+    // Every bit of each lane of zero is the same so a byte blend is correct
+    // for any lane width.
+    return _mm256_blendv_epi8 (q, divide_by_zero_value<N> (x), zero);
+  }
+};
+
+/// Applies \p Op to \p n pairs of values from \p x and \p y, a full AVX2
+/// register at a time, passing any remaining elements to the scalar
+/// implementation.
+template <batch_op Op, size_t N>
+SATURATION_TARGET_AVX2 void run (batch_arg_t<Op, N> const* const x,
+                                 batch_arg_t<Op, N> const* const y,
+                                 batch_arg_t<Op, N>* const out,
+                                 size_t const n) {
+  constexpr auto width = sizeof (__m256i) / sizeof (batch_arg_t<Op, N>);
+  auto i = size_t{0};
+  for (; n - i >= width; i += width) {
+    auto const vx =
+        _mm256_loadu_si256 (reinterpret_cast<__m256i const*> (x + i));
+    auto const vy =
+        _mm256_loadu_si256 (reinterpret_cast<__m256i const*> (y + i));
+    _mm256_storeu_si256 (reinterpret_cast<__m256i*> (out + i),
+                      lanes<Op, N>::apply (vx, vy));
+  }
+  batch_scalar_range<Op, N> (x, y, out, i, n);
+}
+
+/// Returns the AVX2 kernel for \p Op on values of \p N bits or nullptr if
+/// there is none.
+template <batch_op Op, size_t N>
+constexpr batch_kernel_t<Op, N> kernel () {
+  if constexpr (lanes<Op, N>::available) {
+    return &run<Op, N>;
+  } else {
+    return nullptr;
+  }
+}
+
+/// \name Saturation reporting helpers
+/// @{
+
+/// Returns one bit for each lane of \p N bits, set if the corresponding lanes
+/// of \p x and \p y differ. The bit for the first lane is bit 0.
+template <size_t N>
+SATURATION_TARGET_AVX2 inline uint64_t not_equal_bits (__m256i const x,
+                                                       __m256i const y) {
+  auto equal_bits = 0U;
+  if constexpr (N == 8) {
+    equal_bits = static_cast<unsigned> (
+        _mm256_movemask_epi8 (_mm256_cmpeq_epi8 (x, y)));  // vpmovmskb
+  } else if constexpr (N == 16) {
+    // vpacksswb works within 128 bit halves so the two halves are packed
+    // with the SSE2 instruction instead.
+    auto const eq = _mm256_cmpeq_epi16 (x, y);
+    equal_bits = static_cast<unsigned> (_mm_movemask_epi8 (_mm_packs_epi16 (
+        _mm256_castsi256_si128 (eq), _mm256_extracti128_si256 (eq, 1))));
+  } else if constexpr (N == 32) {
+    equal_bits = static_cast<unsigned> (
+        _mm256_movemask_ps (_mm256_castsi256_ps (equal<32> (x, y))));
+  } else {
+    equal_bits = static_cast<unsigned> (
+        _mm256_movemask_pd (_mm256_castsi256_pd (equal<64> (x, y))));
+  }
+  constexpr auto lanes_mask = static_cast<unsigned> ((1ULL << (256U / N)) - 1U);
+  return ~equal_bits & lanes_mask;
+}
+/// Returns the wrapped (modular) result of the addition or subtraction \p Op
+/// on lanes of \p N bits.
+template <batch_op Op, size_t N>
+SATURATION_TARGET_AVX2 inline __m256i wrapped (__m256i const x,
+                                               __m256i const y) {
+  if constexpr (Op == batch_op::addu || Op == batch_op::adds) {
+    return add<N> (x, y);
+  } else {
+    return sub<N> (x, y);
+  }
+}
+/// @}
+
+/// As run() but also records the elements that saturated in \p clipped (see
+/// sse2::run_ovf()).
+template <batch_op Op, size_t N>
+SATURATION_TARGET_AVX2 void run_ovf (batch_arg_t<Op, N> const* const x,
+                                     batch_arg_t<Op, N> const* const y,
+                                     batch_arg_t<Op, N>* const out,
+                                     uint8_t* const clipped, size_t const n) {
+  static_assert (is_add_sub_op (Op));
+  constexpr auto width = sizeof (__m256i) / sizeof (batch_arg_t<Op, N>);
+  constexpr auto lane = lane_width<Op, N> ();
+  auto writer = clip_mask_writer{clipped};
+  auto i = size_t{0};
+  for (; n - i >= width; i += width) {
+    auto const vx =
+        _mm256_loadu_si256 (reinterpret_cast<__m256i const*> (x + i));
+    auto const vy =
+        _mm256_loadu_si256 (reinterpret_cast<__m256i const*> (y + i));
+    auto const res = lanes<Op, N>::apply (vx, vy);
+    _mm256_storeu_si256 (reinterpret_cast<__m256i*> (out + i), res);
+    writer.put (i, width,
+                not_equal_bits<lane> (res, wrapped<Op, lane> (vx, vy)));
+  }
+  batch_scalar_ovf_range<Op, N> (x, y, out, writer, i, n);
+  writer.finish (n);
+}
+
+/// Returns the AVX2 kernel which reports saturation for \p Op on values of
+/// \p N bits or nullptr if there is none.
+template <batch_op Op, size_t N>
+constexpr batch_ovf_kernel_t<Op, N> ovf_kernel () {
+  if constexpr (is_add_sub_op (Op) && lanes<Op, N>::available) {
+    return &run_ovf<Op, N>;
+  } else {
+    return nullptr;
+  }
+}
+
+}  // end namespace avx2
+
+}  // end namespace details
+
+}  // end namespace saturation
+
+#endif  // __GNUC__ && __x86_64__
+#endif  // NO_SIMD
+
+#endif  // SATURATION_BATCH_AVX2_HPP
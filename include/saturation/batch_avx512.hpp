@@ -0,0 +1,822 @@
+/// \file batch_avx512.hpp
+/// \brief Batch kernels using the x86 AVX-512 (F and BW) instruction sets.
+/// These kernels are compiled for every x86-64 target and selected at run
+/// time when the host processor supports them.
+
+#ifndef SATURATION_BATCH_AVX512_HPP
+#define SATURATION_BATCH_AVX512_HPP
+
+#include "saturation/batch_kernel.hpp"
+
+#ifndef NO_SIMD
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+
+/// Enables AVX-512 instructions in a function regardless of the options with
+/// which the compiler was invoked. Such functions must only be called if
+/// selected_isa() reports that the host supports them.
+#define SATURATION_TARGET_AVX512 \
+  __attribute__ ((target ("avx2,avx512f,avx512bw")))
+
+// GCC 12 issues spurious -Wmaybe-uninitialized diagnostics for AVX-512
+// intrinsics which are implemented in terms of _mm512_undefined_si512().
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif  // __GNUC__ && !__clang__
+
+namespace saturation {
+
+namespace details {
+
+namespace avx512 {
+
+/// Defines the vector implementation of the operation \p Op on lanes of \p N
+/// bits. The primary template is used when AVX-512 provides no
+/// implementation.
+template <batch_op Op, size_t N, typename = void>
+struct lanes {
+  static constexpr bool available = false;
+};
+
+template <>
+struct lanes<batch_op::addu, 8> {
+  static constexpr bool available = true;
+  SATURATION_TARGET_AVX512 static __m512i apply (__m512i const x,
+                                                 __m512i const y) {
+    return _mm512_adds_epu8 (x, y);  // vpaddusb
+  }
+};
+template <>
+struct lanes<batch_op::adds, 8> {
+  static constexpr bool available = true;
+  SATURATION_TARGET_AVX512 static __m512i apply (__m512i const x,
+                                                 __m512i const y) {
+    return _mm512_adds_epi8 (x, y);  // vpaddsb
+  }
+};
+template <>
+struct lanes<batch_op::subu, 8> {
+  static constexpr bool available = true;
+  SATURATION_TARGET_AVX512 static __m512i apply (__m512i const x,
+                                                 __m512i const y) {
+    return _mm512_subs_epu8 (x, y);  // vpsubusb
+  }
+};
+template <>
+struct lanes<batch_op::subs, 8> {
+  static constexpr bool available = true;
+  SATURATION_TARGET_AVX512 static __m512i apply (__m512i const x,
+                                                 __m512i const y) {
+    return _mm512_subs_epi8 (x, y);  // vpsubsb
+  }
+};
+template <>
+struct lanes<batch_op::addu, 16> {
+  static constexpr bool available = true;
+  SATURATION_TARGET_AVX512 static __m512i apply (__m512i const x,
+                                                 __m512i const y) {
+    return _mm512_adds_epu16 (x, y);  // vpaddusw
+  }
+};
+template <>
+struct lanes<batch_op::adds, 16> {
+  static constexpr bool available = true;
+  SATURATION_TARGET_AVX512 static __m512i apply (__m512i const x,
+                                                 __m512i const y) {
+    return _mm512_adds_epi16 (x, y);  // vpaddsw
+  }
+};
+template <>
+struct lanes<batch_op::subu, 16> {
+  static constexpr bool available = true;
+  SATURATION_TARGET_AVX512 static __m512i apply (__m512i const x,
+                                                 __m512i const y) {
+    return _mm512_subs_epu16 (x, y);  // vpsubusw
+  }
+};
+template <>
+struct lanes<batch_op::subs, 16> {
+  static constexpr bool available = true;
+  SATURATION_TARGET_AVX512 static __m512i apply (__m512i const x,
+                                                 __m512i const y) {
+    return _mm512_subs_epi16 (x, y);  // vpsubsw
+  }
+};
+
+/// \name Lane helpers
+/// Helper functions which select the instruction appropriate for lanes of
+/// \p N bits where \p N is 32 or 64. add() and sub() also accept 8 and 16.
+/// @{
+
+template <size_t N>
+SATURATION_TARGET_AVX512 inline __m512i add (__m512i const x, __m512i const y) {
+  if constexpr (N == 8) {
+    return _mm512_add_epi8 (x, y);
+  } else if constexpr (N == 16) {
+    return _mm512_add_epi16 (x, y);
+  } else if constexpr (N == 32) {
+    return _mm512_add_epi32 (x, y);
+  } else {
+    return _mm512_add_epi64 (x, y);
+  }
+}
+template <size_t N>
+SATURATION_TARGET_AVX512 inline __m512i sub (__m512i const x, __m512i const y) {
+  if constexpr (N == 8) {
+    return _mm512_sub_epi8 (x, y);
+  } else if constexpr (N == 16) {
+    return _mm512_sub_epi16 (x, y);
+  } else if constexpr (N == 32) {
+    return _mm512_sub_epi32 (x, y);
+  } else {
+    return _mm512_sub_epi64 (x, y);
+  }
+}
+/// Returns a mask register with bits set for each lane of \p x whose most
+/// significant bit is set.
+template <size_t N>
+SATURATION_TARGET_AVX512 inline auto top_bit_mask (__m512i const x) {
+  if constexpr (N == 32) {
+    return _mm512_cmplt_epi32_mask (x, _mm512_setzero_si512 ());
+  } else {
+    return _mm512_cmplt_epi64_mask (x, _mm512_setzero_si512 ());
+  }
+}
+/// Returns the lanes of \p x where \p mask is clear and the lanes of \p y
+/// where it is set.
+template <size_t N, typename Mask>
+SATURATION_TARGET_AVX512 inline __m512i blend (Mask const mask,
+                                               __m512i const x,
+                                               __m512i const y) {
+  if constexpr (N == 32) {
+    return _mm512_mask_blend_epi32 (mask, x, y);
+  } else {
+    return _mm512_mask_blend_epi64 (mask, x, y);
+  }
+}
+/// Computes the value to which each lane of a signed operation saturates:
+/// max or min depending on the sign of \p x. Equivalent to
+/// details::adds_overflow_value().
+template <size_t N>
+SATURATION_TARGET_AVX512 inline __m512i overflow_value (__m512i const x) {
+  if constexpr (N == 32) {
+    return blend<N> (top_bit_mask<N> (x),
+                     _mm512_set1_epi32 (slimits<32>::max ()),
+                     _mm512_set1_epi32 (slimits<32>::min ()));
+  } else {
+    return blend<N> (top_bit_mask<N> (x),
+                     _mm512_set1_epi64 (slimits<64>::max ()),
+                     _mm512_set1_epi64 (slimits<64>::min ()));
+  }
+}
+/// Computes a three-input bitwise function of \p x, \p y, and \p z as
+/// described by the truth table \p Imm (see vpternlogd).
+template <int Imm>
+SATURATION_TARGET_AVX512 inline __m512i ternary (__m512i const x,
+                                                 __m512i const y,
+                                                 __m512i const z) {
+  return _mm512_ternarylogic_epi32 (x, y, z, Imm);
+}
+/// @}
+
+// There are no packed saturating instructions for 32 and 64 bit lanes. The
+// overflow condition for each lane is computed into a mask register which
+// selects between the wrapped and saturated results.
+template <size_t N>
+struct lanes<batch_op::addu, N, std::enable_if_t<N == 32 || N == 64>> {
+  static constexpr bool available = true;
+  SATURATION_TARGET_AVX512 static __m512i apply (__m512i const x,
+                                                 __m512i const y) {
+    auto const sum = add<N> (x, y);
+    if constexpr (N == 32) {
+      auto const carry = _mm512_cmplt_epu32_mask (sum, x);
+      return _mm512_mask_mov_epi32 (sum, carry, _mm512_set1_epi32 (-1));
+    } else {
+      auto const carry = _mm512_cmplt_epu64_mask (sum, x);
+      return _mm512_mask_mov_epi64 (sum, carry, _mm512_set1_epi64 (-1));
+    }
+  }
+};
+template <size_t N>
+struct lanes<batch_op::subu, N, std::enable_if_t<N == 32 || N == 64>> {
+  static constexpr bool available = true;
+  SATURATION_TARGET_AVX512 static __m512i apply (__m512i const x,
+                                                 __m512i const y) {
+    // Lanes where x < y are zeroed; the remainder are x - y.
+    if constexpr (N == 32) {
+      return _mm512_maskz_sub_epi32 (_mm512_cmpge_epu32_mask (x, y), x, y);
+    } else {
+      return _mm512_maskz_sub_epi64 (_mm512_cmpge_epu64_mask (x, y), x, y);
+    }
+  }
+};
+template <size_t N>
+struct lanes<batch_op::adds, N, std::enable_if_t<N == 32 || N == 64>> {
+  static constexpr bool available = true;
+  SATURATION_TARGET_AVX512 static __m512i apply (__m512i const x,
+                                                 __m512i const y) {
+    auto const sum = add<N> (x, y);
+    // Overflow if x and y have the same sign and the sign of sum differs:
+    // (x ^ sum) & ~(x ^ y).
+    auto const overflow = ternary<0x42> (x, y, sum);
+    return blend<N> (top_bit_mask<N> (overflow), sum, overflow_value<N> (x));
+  }
+};
+template <size_t N>
+struct lanes<batch_op::subs, N, std::enable_if_t<N == 32 || N == 64>> {
+  static constexpr bool available = true;
+  SATURATION_TARGET_AVX512 static __m512i apply (__m512i const x,
+                                                 __m512i const y) {
+    auto const diff = sub<N> (x, y);
+    // Overflow if x and y have different signs and the sign of diff differs
+    // from that of x: (x ^ y) & (x ^ diff).
+    auto const overflow = ternary<0x18> (x, y, diff);
+    return blend<N> (top_bit_mask<N> (overflow), diff, overflow_value<N> (x));
+  }
+};
+
+/// \name Padded lane helpers
+/// Signed lanes of 8, 16 or 32 bits for values which do not fill them (see
+/// is_padded_width()). The 8 and 16 bit forms need AVX512BW.
+/// @{
+
+/// Returns a value with every lane set to \p v.
+template <size_t N>
+SATURATION_TARGET_AVX512 inline __m512i set1 (int64_t const v) {
+  if constexpr (N == 8) {
+    return _mm512_set1_epi8 (static_cast<char> (v));
+  } else if constexpr (N == 16) {
+    return _mm512_set1_epi16 (static_cast<short> (v));
+  } else {
+    return _mm512_set1_epi32 (static_cast<int> (v));
+  }
+}
+/// Returns the lanewise signed minimum of \p x and \p y.
+template <size_t N>
+SATURATION_TARGET_AVX512 inline __m512i min (__m512i const x,
+                                             __m512i const y) {
+  if constexpr (N == 8) {
+    return _mm512_min_epi8 (x, y);
+  } else if constexpr (N == 16) {
+    return _mm512_min_epi16 (x, y);
+  } else {
+    return _mm512_min_epi32 (x, y);
+  }
+}
+/// Returns the lanewise signed maximum of \p x and \p y.
+template <size_t N>
+SATURATION_TARGET_AVX512 inline __m512i max (__m512i const x,
+                                             __m512i const y) {
+  if constexpr (N == 8) {
+    return _mm512_max_epi8 (x, y);
+  } else if constexpr (N == 16) {
+    return _mm512_max_epi16 (x, y);
+  } else {
+    return _mm512_max_epi32 (x, y);
+  }
+}
+/// @}
+
+// The kernels for values which do not fill their lanes.
+template <size_t N>
+struct lanes<batch_op::addu, N, std::enable_if_t<is_padded_width (N)>> {
+  static constexpr bool available = true;
+  SATURATION_TARGET_AVX512 static __m512i apply (__m512i const x,
+                                                 __m512i const y) {
+    constexpr auto lane = lane_width<batch_op::addu, N> ();
+    constexpr auto upper = ulimits<N>::max ();
+    return add<lane> (x, min<lane> (y, sub<lane> (set1<lane> (upper), x)));
+  }
+};
+template <size_t N>
+struct lanes<batch_op::subu, N, std::enable_if_t<is_padded_width (N)>> {
+  static constexpr bool available = true;
+  SATURATION_TARGET_AVX512 static __m512i apply (__m512i const x,
+                                                 __m512i const y) {
+    constexpr auto lane = lane_width<batch_op::subu, N> ();
+    return max<lane> (sub<lane> (x, y), _mm512_setzero_si512 ());
+  }
+};
+template <size_t N>
+struct lanes<batch_op::adds, N, std::enable_if_t<is_padded_width (N)>> {
+  static constexpr bool available = true;
+  SATURATION_TARGET_AVX512 static __m512i apply (__m512i const x,
+                                                 __m512i const y) {
+    constexpr auto lane = lane_width<batch_op::adds, N> ();
+    constexpr auto upper = slimits<N>::max ();
+    constexpr auto lower = slimits<N>::min ();
+    return max<lane> (min<lane> (add<lane> (x, y), set1<lane> (upper)),
+                      set1<lane> (lower));
+  }
+};
+template <size_t N>
+struct lanes<batch_op::subs, N, std::enable_if_t<is_padded_width (N)>> {
+  static constexpr bool available = true;
+  SATURATION_TARGET_AVX512 static __m512i apply (__m512i const x,
+                                                 __m512i const y) {
+    constexpr auto lane = lane_width<batch_op::subs, N> ();
+    constexpr auto upper = slimits<N>::max ();
+    constexpr auto lower = slimits<N>::min ();
+    return max<lane> (min<lane> (sub<lane> (x, y), set1<lane> (upper)),
+                      set1<lane> (lower));
+  }
+};
+
+/// \name Multiplication helpers
+/// @{
+
+/// The low- and high-order halves of the double-width products of the lanes
+/// of two vectors.
+struct wide_product {
+  __m512i lo;
+  __m512i hi;
+};
+
+/// Multiplies the 32 bit lanes of \p x and \p y. vpmuludq/vpmuldq multiply
+/// only the even lanes so the odd lanes are shifted into the even positions
+/// and multiplied separately.
+template <bool IsUnsigned>
+SATURATION_TARGET_AVX512 inline wide_product mul_wide_epi32 (__m512i const x,
+                                                             __m512i const y) {
+  auto const x_odd = _mm512_srli_epi64 (x, 32);
+  auto const y_odd = _mm512_srli_epi64 (y, 32);
+  auto even = __m512i{};
+  auto odd = __m512i{};
+  if constexpr (IsUnsigned) {
+    even = _mm512_mul_epu32 (x, y);
+    odd = _mm512_mul_epu32 (x_odd, y_odd);
+  } else {
+    even = _mm512_mul_epi32 (x, y);
+    odd = _mm512_mul_epi32 (x_odd, y_odd);
+  }
+  // Odd 32 bit lanes: 0b1010...
+  constexpr auto odd_lanes = __mmask16{0xAAAA};
+  return {_mm512_mask_mov_epi32 (even, odd_lanes, _mm512_slli_epi64 (odd, 32)),
+          _mm512_mask_mov_epi32 (_mm512_srli_epi64 (even, 32), odd_lanes, odd)};
+}
+/// Multiplies the unsigned 64 bit lanes of \p x and \p y. This is the vector
+/// form of details::multiply(): the product is assembled from four 32 x 32
+/// bit partial products.
+SATURATION_TARGET_AVX512 inline wide_product mul_wide_epu64 (__m512i const x,
+                                                             __m512i const y) {
+  auto const low_mask = _mm512_set1_epi64 (0xFFFFFFFF);
+  auto const x_hi = _mm512_srli_epi64 (x, 32);
+  auto const y_hi = _mm512_srli_epi64 (y, 32);
+  auto const lo_lo = _mm512_mul_epu32 (x, y);
+  auto const hi_lo = _mm512_mul_epu32 (x_hi, y);
+  auto const lo_hi = _mm512_mul_epu32 (x, y_hi);
+  auto const hi_hi = _mm512_mul_epu32 (x_hi, y_hi);
+  // The sum of the middle terms cannot overflow 64 bits.
+  auto const mid = _mm512_add_epi64 (
+      _mm512_add_epi64 (_mm512_srli_epi64 (lo_lo, 32),
+                        _mm512_and_si512 (hi_lo, low_mask)),
+      _mm512_and_si512 (lo_hi, low_mask));
+  auto const hi = _mm512_add_epi64 (
+      _mm512_add_epi64 (hi_hi, _mm512_srli_epi64 (mid, 32)),
+      _mm512_add_epi64 (_mm512_srli_epi64 (hi_lo, 32),
+                        _mm512_srli_epi64 (lo_hi, 32)));
+  return {_mm512_or_si512 (_mm512_and_si512 (lo_lo, low_mask),
+                           _mm512_slli_epi64 (mid, 32)),
+          hi};
+}
+/// Multiplies the signed 64 bit lanes of \p x and \p y. The high half of the
+/// signed product is derived from the unsigned product by subtracting y (or
+/// x) where x (or y) is negative.
+SATURATION_TARGET_AVX512 inline wide_product mul_wide_epi64 (__m512i const x,
+                                                             __m512i const y) {
+  auto product = mul_wide_epu64 (x, y);
+  product.hi = _mm512_mask_sub_epi64 (product.hi, top_bit_mask<64> (x),
+                                      product.hi, y);
+  product.hi = _mm512_mask_sub_epi64 (product.hi, top_bit_mask<64> (y),
+                                      product.hi, x);
+  return product;
+}
+/// Returns a mask register with bits set for each lane where \p x and \p y
+/// differ.
+template <size_t N>
+SATURATION_TARGET_AVX512 inline auto not_equal (__m512i const x,
+                                                __m512i const y) {
+  if constexpr (N == 32) {
+    return _mm512_cmpneq_epi32_mask (x, y);
+  } else {
+    return _mm512_cmpneq_epi64_mask (x, y);
+  }
+}
+/// Returns a value in which each lane is all ones if the corresponding lane
+/// of \p x is negative and zero otherwise.
+template <size_t N>
+SATURATION_TARGET_AVX512 inline __m512i sign_mask (__m512i const x) {
+  if constexpr (N == 32) {
+    return _mm512_srai_epi32 (x, 31);
+  } else {
+    return _mm512_srai_epi64 (x, 63);
+  }
+}
+/// @}
+
+template <>
+struct lanes<batch_op::mulu, 8> {
+  static constexpr bool available = true;
+  SATURATION_TARGET_AVX512 static __m512i apply (__m512i const x,
+                                                 __m512i const y) {
+    // Widen to 16 bits, multiply, then clamp to 255 before packing back to 8
+    // bits. (The unpack and pack instructions operate within each 128 bit
+    // quarter so the order of the lanes is preserved.)
+    auto const zero = _mm512_setzero_si512 ();
+    auto const limit = _mm512_set1_epi16 (0xFF);
+    auto const lo = _mm512_mullo_epi16 (_mm512_unpacklo_epi8 (x, zero),
+                                        _mm512_unpacklo_epi8 (y, zero));
+    auto const hi = _mm512_mullo_epi16 (_mm512_unpackhi_epi8 (x, zero),
+                                        _mm512_unpackhi_epi8 (y, zero));
+    return _mm512_packus_epi16 (_mm512_min_epu16 (lo, limit),
+                                _mm512_min_epu16 (hi, limit));
+  }
+};
+template <>
+struct lanes<batch_op::muls, 8> {
+  static constexpr bool available = true;
+  SATURATION_TARGET_AVX512 static __m512i apply (__m512i const x,
+                                                 __m512i const y) {
+    // Sign-extend to 16 bits (where the product cannot overflow), multiply,
+    // and pack back to 8 bits with signed saturation.
+    auto const x_lo = _mm512_srai_epi16 (_mm512_unpacklo_epi8 (x, x), 8);
+    auto const y_lo = _mm512_srai_epi16 (_mm512_unpacklo_epi8 (y, y), 8);
+    auto const x_hi = _mm512_srai_epi16 (_mm512_unpackhi_epi8 (x, x), 8);
+    auto const y_hi = _mm512_srai_epi16 (_mm512_unpackhi_epi8 (y, y), 8);
+    return _mm512_packs_epi16 (_mm512_mullo_epi16 (x_lo, y_lo),
+                               _mm512_mullo_epi16 (x_hi, y_hi));
+  }
+};
+template <>
+struct lanes<batch_op::mulu, 16> {
+  static constexpr bool available = true;
+  SATURATION_TARGET_AVX512 static __m512i apply (__m512i const x,
+                                                 __m512i const y) {
+    // vpmullw/vpmulhuw yield the low and high halves of the product. Lanes
+    // with a non-zero high half saturate.
+    auto const lo = _mm512_mullo_epi16 (x, y);
+    auto const overflow =
+        _mm512_test_epi16_mask (_mm512_mulhi_epu16 (x, y),
+                                _mm512_set1_epi16 (-1));
+    return _mm512_mask_mov_epi16 (lo, overflow, _mm512_set1_epi16 (-1));
+  }
+};
+template <>
+struct lanes<batch_op::muls, 16> {
+  static constexpr bool available = true;
+  SATURATION_TARGET_AVX512 static __m512i apply (__m512i const x,
+                                                 __m512i const y) {
+    // vpmullw/vpmulhw yield the low and high halves of the product.
+    // Interleaving them gives the 32 bit products which vpackssdw saturates
+    // to 16 bits.
+    auto const lo = _mm512_mullo_epi16 (x, y);
+    auto const hi = _mm512_mulhi_epi16 (x, y);
+    return _mm512_packs_epi32 (_mm512_unpacklo_epi16 (lo, hi),
+                               _mm512_unpackhi_epi16 (lo, hi));
+  }
+};
+template <size_t N>
+struct lanes<batch_op::mulu, N, std::enable_if_t<N == 32 || N == 64>> {
+  static constexpr bool available = true;
+  SATURATION_TARGET_AVX512 static __m512i apply (__m512i const x,
+                                                 __m512i const y) {
+    // As mulu<>: lanes with a non-zero high half saturate.
+    auto product = wide_product{};
+    if constexpr (N == 32) {
+      product = mul_wide_epi32<true> (x, y);
+    } else {
+      product = mul_wide_epu64 (x, y);
+    }
+    auto const overflow =
+        not_equal<N> (product.hi, _mm512_setzero_si512 ());
+    return blend<N> (overflow, product.lo, _mm512_set1_epi32 (-1));
+  }
+};
+template <size_t N>
+struct lanes<batch_op::muls, N, std::enable_if_t<N == 32 || N == 64>> {
+  static constexpr bool available = true;
+  SATURATION_TARGET_AVX512 static __m512i apply (__m512i const x,
+                                                 __m512i const y) {
+    // As muls<>: the product fits if the high half is the sign extension of
+    // the low half. If not, the result saturates according to the sign of
+    // x ^ y (see details::overflow_value()).
+    auto product = wide_product{};
+    if constexpr (N == 32) {
+      product = mul_wide_epi32<false> (x, y);
+    } else {
+      product = mul_wide_epi64 (x, y);
+    }
+    auto const overflow = not_equal<N> (product.hi, sign_mask<N> (product.lo));
+    return blend<N> (overflow, product.lo,
+                     overflow_value<N> (_mm512_xor_si512 (x, y)));
+  }
+};
+
+/// \name Division helpers
+/// There are no integer division instructions. Instead, lanes are converted
+/// to floating point, divided, and the quotient truncated (see the SSE2
+/// implementation).
+/// @{
+
+/// Divides 32 bit lanes holding signed values of no more than 16 bits and
+/// truncates the quotient.
+SATURATION_TARGET_AVX512 inline __m512i div_ps (__m512i const x,
+                                                __m512i const y) {
+  return _mm512_cvttps_epi32 (
+      _mm512_div_ps (_mm512_cvtepi32_ps (x), _mm512_cvtepi32_ps (y)));
+}
+/// Sign-extends the low (\p Hi false) or high (\p Hi true) four 16 bit lanes
+/// of each 128 bit quarter of \p x to 32 bits.
+template <bool Hi>
+SATURATION_TARGET_AVX512 inline __m512i widen_epi16 (__m512i const x) {
+  if constexpr (Hi) {
+    return _mm512_srai_epi32 (_mm512_unpackhi_epi16 (x, x), 16);
+  } else {
+    return _mm512_srai_epi32 (_mm512_unpacklo_epi16 (x, x), 16);
+  }
+}
+/// Combines two 256 bit values into the low and high halves of a 512 bit
+/// value.
+SATURATION_TARGET_AVX512 inline __m512i combine (__m256i const lo,
+                                                 __m256i const hi) {
+  return _mm512_inserti64x4 (_mm512_castsi256_si512 (lo), hi, 1);
+}
+/// @}
+
+template <>
+struct lanes<batch_op::divu, 16> {
+  static constexpr bool available = true;
+  SATURATION_TARGET_AVX512 static __m512i apply (__m512i const x,
+                                                 __m512i const y) {
+    auto const zero = _mm512_setzero_si512 ();
+    auto const lo = div_ps (_mm512_unpacklo_epi16 (x, zero),
+                            _mm512_unpacklo_epi16 (y, zero));
+    auto const hi = div_ps (_mm512_unpackhi_epi16 (x, zero),
+                            _mm512_unpackhi_epi16 (y, zero));
+    return _mm512_packus_epi32 (lo, hi);
+  }
+};
+template <>
+struct lanes<batch_op::divs, 16> {
+  static constexpr bool available = true;
+  SATURATION_TARGET_AVX512 static __m512i apply (__m512i const x,
+                                                 __m512i const y) {
+    // vpackssdw saturates -2^15 / -1 = 2^15 to 2^15-1.
+    auto const lo = div_ps (widen_epi16<false> (x), widen_epi16<false> (y));
+    auto const hi = div_ps (widen_epi16<true> (x), widen_epi16<true> (y));
+    return _mm512_packs_epi32 (lo, hi);
+  }
+};
+template <>
+struct lanes<batch_op::divu, 8> {
+  static constexpr bool available = true;
+  SATURATION_TARGET_AVX512 static __m512i apply (__m512i const x,
+                                                 __m512i const y) {
+    // Widen to 16 bits and divide. The quotients fit in 8 bits.
+    using divide = lanes<batch_op::divu, 16>;
+    auto const zero = _mm512_setzero_si512 ();
+    return _mm512_packus_epi16 (divide::apply (_mm512_unpacklo_epi8 (x, zero),
+                                               _mm512_unpacklo_epi8 (y, zero)),
+                                divide::apply (_mm512_unpackhi_epi8 (x, zero),
+                                               _mm512_unpackhi_epi8 (y, zero)));
+  }
+};
+template <>
+struct lanes<batch_op::divs, 8> {
+  static constexpr bool available = true;
+  SATURATION_TARGET_AVX512 static __m512i apply (__m512i const x,
+                                                 __m512i const y) {
+    // Sign-extend to 16 bits and divide. vpacksswb saturates -2^7 / -1.
+    using divide = lanes<batch_op::divs, 16>;
+    auto const x_lo = _mm512_srai_epi16 (_mm512_unpacklo_epi8 (x, x), 8);
+    auto const y_lo = _mm512_srai_epi16 (_mm512_unpacklo_epi8 (y, y), 8);
+    auto const x_hi = _mm512_srai_epi16 (_mm512_unpackhi_epi8 (x, x), 8);
+    auto const y_hi = _mm512_srai_epi16 (_mm512_unpackhi_epi8 (y, y), 8);
+    return _mm512_packs_epi16 (divide::apply (x_lo, y_lo),
+                               divide::apply (x_hi, y_hi));
+  }
+};
+template <>
+struct lanes<batch_op::divu, 32> {
+  static constexpr bool available = true;
+  SATURATION_TARGET_AVX512 static __m512i apply (__m512i const x,
+                                                 __m512i const y) {
+    return combine (divide (_mm512_castsi512_si256 (x),
+                            _mm512_castsi512_si256 (y)),
+                    divide (_mm512_extracti64x4_epi64 (x, 1),
+                            _mm512_extracti64x4_epi64 (y, 1)));
+  }
+
+private:
+  // AVX-512F provides unsigned conversions in both directions.
+  SATURATION_TARGET_AVX512 static __m256i divide (__m256i const x,
+                                                  __m256i const y) {
+    return _mm512_cvttpd_epu32 (
+        _mm512_div_pd (_mm512_cvtepu32_pd (x), _mm512_cvtepu32_pd (y)));
+  }
+};
+template <>
+struct lanes<batch_op::divs, 32> {
+  static constexpr bool available = true;
+  SATURATION_TARGET_AVX512 static __m512i apply (__m512i const x,
+                                                 __m512i const y) {
+    return combine (divide (_mm512_castsi512_si256 (x),
+                            _mm512_castsi512_si256 (y)),
+                    divide (_mm512_extracti64x4_epi64 (x, 1),
+                            _mm512_extracti64x4_epi64 (y, 1)));
+  }
+
+private:
+  SATURATION_TARGET_AVX512 static __m256i divide (__m256i const x,
+                                                  __m256i const y) {
+    // -2^31 / -1 = 2^31 is clamped to 2^31-1 before it is converted.
+    return _mm512_cvttpd_epi32 (_mm512_min_pd (
+        _mm512_div_pd (_mm512_cvtepi32_pd (x), _mm512_cvtepi32_pd (y)),
+        _mm512_set1_pd (slimits<32>::max ())));
+  }
+};
+
+/// \name Divide-by-zero helpers
+/// Helper functions for the divide_by_zero::saturate policy which select the
+/// instruction appropriate for lanes of \p N bits where \p N is 8, 16 or 32.
+/// @{
+
+/// Returns a mask register with bits set for each lane of \p x which is zero.
+template <size_t N>
+SATURATION_TARGET_AVX512 inline auto is_zero (__m512i const x) {
+  if constexpr (N == 8) {
+    return _mm512_testn_epi8_mask (x, x);
+  } else if constexpr (N == 16) {
+    return _mm512_testn_epi16_mask (x, x);
+  } else {
+    return _mm512_testn_epi32_mask (x, x);
+  }
+}
+/// Returns a mask register with bits set for each lane of \p x selected by
+/// \p mask whose comparison with zero satisfies \p Predicate (one of the
+/// _MM_CMPINT_ constants).
+template <size_t N, int Predicate, typename Mask>
+SATURATION_TARGET_AVX512 inline Mask compare_zero (Mask const mask,
+                                                   __m512i const x) {
+  auto const zero = _mm512_setzero_si512 ();
+  if constexpr (N == 8) {
+    return _mm512_mask_cmp_epi8_mask (mask, x, zero, Predicate);
+  } else if constexpr (N == 16) {
+    return _mm512_mask_cmp_epi16_mask (mask, x, zero, Predicate);
+  } else {
+    return _mm512_mask_cmp_epi32_mask (mask, x, zero, Predicate);
+  }
+}
+/// Returns \p x with the lanes selected by \p mask replaced by \p value.
+template <size_t N, typename Mask>
+SATURATION_TARGET_AVX512 inline __m512i fill (__m512i const x,
+                                              Mask const mask,
+                                              sinteger_t<N> const value) {
+  if constexpr (N == 8) {
+    return _mm512_mask_mov_epi8 (x, mask, _mm512_set1_epi8 (value));
+  } else if constexpr (N == 16) {
+    return _mm512_mask_mov_epi16 (x, mask, _mm512_set1_epi16 (value));
+  } else {
+    return _mm512_mask_mov_epi32 (x, mask, _mm512_set1_epi32 (value));
+  }
+}
+/// @}
+
+// Division with the divide_by_zero::saturate policy replaces zero divisors
+// with 1 then overwrites the corresponding quotients.
+template <size_t N>
+struct lanes<batch_op::divu_saturate, N,
+             std::enable_if_t<N == 8 || N == 16 || N == 32>> {
+  static constexpr bool available = true;
+  SATURATION_TARGET_AVX512 static __m512i apply (__m512i const x,
+                                                 __m512i const y) {
+    auto const zero = is_zero<N> (y);
+    auto const q = lanes<batch_op::divu, N>::apply (x, fill<N> (y, zero, 1));
+    return fill<N> (q, compare_zero<N, _MM_CMPINT_NE> (zero, x), -1);
+  }
+};
+template <size_t N>
+struct lanes<batch_op::divs_saturate, N,
+             std::enable_if_t<N == 8 || N == 16 || N == 32>> {
+  static constexpr bool available = true;
+  SATURATION_TARGET_AVX512 static __m512i apply (__m512i const x,
+                                                 __m512i const y) {
+    auto const zero = is_zero<N> (y);
+    auto const q = lanes<batch_op::divs, N>::apply (x, fill<N> (y, zero, 1));
+    auto const positive = compare_zero<N, _MM_CMPINT_NLE> (zero, x);
+    auto const negative = compare_zero<N, _MM_CMPINT_LT> (zero, x);
+    return fill<N> (fill<N> (q, positive, slimits<N>::max ()), negative,
+                    slimits<N>::min ());
+  }
+};
+
+/// Applies \p Op to \p n pairs of values from \p x and \p y, a full AVX-512
+/// register at a time, passing any remaining elements to the scalar
+/// implementation.
+template <batch_op Op, size_t N>
+SATURATION_TARGET_AVX512 void run (batch_arg_t<Op, N> const* const x,
+                                   batch_arg_t<Op, N> const* const y,
+                                   batch_arg_t<Op, N>* const out,
+                                   size_t const n) {
+  constexpr auto width = sizeof (__m512i) / sizeof (batch_arg_t<Op, N>);
+  auto i = size_t{0};
+  for (; n - i >= width; i += width) {
+    auto const vx = _mm512_loadu_si512 (x + i);
+    auto const vy = _mm512_loadu_si512 (y + i);
+    _mm512_storeu_si512 (out + i, lanes<Op, N>::apply (vx, vy));
+  }
+  batch_scalar_range<Op, N> (x, y, out, i, n);
+}
+
+/// Returns the AVX-512 kernel for \p Op on values of \p N bits or nullptr if
+/// there is none.
+template <batch_op Op, size_t N>
+constexpr batch_kernel_t<Op, N> kernel () {
+  if constexpr (lanes<Op, N>::available) {
+    return &run<Op, N>;
+  } else {
+    return nullptr;
+  }
+}
+
+/// \name Saturation reporting helpers
+/// @{
+
+/// Returns one bit for each lane of \p N bits, set if the corresponding lanes
+/// of \p x and \p y differ. The comparisons produce the bits directly in a
+/// mask register.
+template <size_t N>
+SATURATION_TARGET_AVX512 inline uint64_t not_equal_bits (__m512i const x,
+                                                         __m512i const y) {
+  if constexpr (N == 8) {
+    return _mm512_cmpneq_epi8_mask (x, y);
+  } else if constexpr (N == 16) {
+    return _mm512_cmpneq_epi16_mask (x, y);
+  } else {
+    return not_equal<N> (x, y);
+  }
+}
+/// Returns the wrapped (modular) result of the addition or subtraction \p Op
+/// on lanes of \p N bits.
+template <batch_op Op, size_t N>
+SATURATION_TARGET_AVX512 inline __m512i wrapped (__m512i const x,
+                                                 __m512i const y) {
+  if constexpr (Op == batch_op::addu || Op == batch_op::adds) {
+    return add<N> (x, y);
+  } else {
+    return sub<N> (x, y);
+  }
+}
+/// @}
+
+/// As run() but also records the elements that saturated in \p clipped (see
+/// sse2::run_ovf()).
+template <batch_op Op, size_t N>
+SATURATION_TARGET_AVX512 void run_ovf (batch_arg_t<Op, N> const* const x,
+                                       batch_arg_t<Op, N> const* const y,
+                                       batch_arg_t<Op, N>* const out,
+                                       uint8_t* const clipped,
+                                       size_t const n) {
+  static_assert (is_add_sub_op (Op));
+  constexpr auto width = sizeof (__m512i) / sizeof (batch_arg_t<Op, N>);
+  constexpr auto lane = lane_width<Op, N> ();
+  auto writer = clip_mask_writer{clipped};
+  auto i = size_t{0};
+  for (; n - i >= width; i += width) {
+    auto const vx = _mm512_loadu_si512 (x + i);
+    auto const vy = _mm512_loadu_si512 (y + i);
+    auto const res = lanes<Op, N>::apply (vx, vy);
+    _mm512_storeu_si512 (out + i, res);
+    writer.put (i, width,
+                not_equal_bits<lane> (res, wrapped<Op, lane> (vx, vy)));
+  }
+  batch_scalar_ovf_range<Op, N> (x, y, out, writer, i, n);
+  writer.finish (n);
+}
+
+/// Returns the AVX-512 kernel which reports saturation for \p Op on values
+/// of \p N bits or nullptr if there is none.
+template <batch_op Op, size_t N>
+constexpr batch_ovf_kernel_t<Op, N> ovf_kernel () {
+  if constexpr (is_add_sub_op (Op) && lanes<Op, N>::available) {
+    return &run_ovf<Op, N>;
+  } else {
+    return nullptr;
+  }
+}
+
+}  // end namespace avx512
+
+}  // end namespace details
+
+}  // end namespace saturation
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif  // __GNUC__ && !__clang__
+
+#endif  // __GNUC__ && __x86_64__
+#endif  // NO_SIMD
+
+#endif  // SATURATION_BATCH_AVX512_HPP
@@ -0,0 +1,331 @@
+/// \file batch_kernel.hpp
+/// \brief Infrastructure shared by the batch (span) functions and by the
+/// target-specific kernels which implement them.
+
+#ifndef SATURATION_BATCH_KERNEL_HPP
+#define SATURATION_BATCH_KERNEL_HPP
+
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+
+#include "saturation/add.hpp"
+#include "saturation/div.hpp"
+#include "saturation/mul.hpp"
+#include "saturation/sub.hpp"
+#include "saturation/types.hpp"
+
+namespace saturation {
+
+namespace details {
+
+/// The operations which may be applied elementwise by a batch kernel.
+/// divu_saturate and divs_saturate are division with the
+/// divide_by_zero::saturate policy.
+enum class batch_op {
+  addu,
+  adds,
+  subu,
+  subs,
+  mulu,
+  muls,
+  divu,
+  divs,
+  divu_saturate,
+  divs_saturate
+};
+
+/// Returns the name of an operation.
+constexpr char const* to_string (batch_op const op) noexcept {
+  switch (op) {
+  case batch_op::addu: return "addu";
+  case batch_op::adds: return "adds";
+  case batch_op::subu: return "subu";
+  case batch_op::subs: return "subs";
+  case batch_op::mulu: return "mulu";
+  case batch_op::muls: return "muls";
+  case batch_op::divu: return "divu";
+  case batch_op::divs: return "divs";
+  case batch_op::divu_saturate: return "divu_saturate";
+  case batch_op::divs_saturate: return "divs_saturate";
+  }
+  return "unknown";
+}
+
+/// True if \p Op operates on unsigned values; false otherwise.
+constexpr bool is_unsigned_op (batch_op const op) {
+  return op == batch_op::addu || op == batch_op::subu ||
+         op == batch_op::mulu || op == batch_op::divu ||
+         op == batch_op::divu_saturate;
+}
+
+/// True if values of \p n bits do not fill the standard integer type which
+/// holds them (for example, 12 bit values in a 16 bit type) and that type is
+/// no wider than 32 bits. The vector kernels process such values in lanes of
+/// the width of the standard type.
+///
+/// Such values cannot overflow the lane, so the wrapped sum or difference is
+/// exact and is clamped to the range of N bits with signed min and max.
+/// Unsigned values are less than 2^(L-1) for lanes of L bits so signed
+/// comparisons order them correctly; addu computes x + min(y, max - x) so
+/// that the intermediate values stay in that range.
+constexpr bool is_padded_width (size_t const n) {
+  return n < 32U && !is_register_width (n);
+}
+
+/// The type of the arguments and results of the elementwise operation \p Op on
+/// values of \p N bits.
+template <batch_op Op, size_t N>
+using batch_arg_t = std::conditional_t<is_unsigned_op (Op), uinteger_t<N>,
+                                       sinteger_t<N>>;
+
+/// Returns the number of bits in the vector lanes used for the elementwise
+/// operation \p Op on values of \p N bits: the width of batch_arg_t<Op, N>.
+template <batch_op Op, size_t N>
+constexpr size_t lane_width () {
+  return sizeof (batch_arg_t<Op, N>) * CHAR_BIT;
+}
+
+/// The type of a batch kernel: a function which applies an elementwise
+/// operation to \p n pairs of values taken from the arrays at \p x and \p y,
+/// writing the results to the array at \p out.
+///
+/// \p out may be equal to either \p x or \p y but must not otherwise overlap
+/// them.
+template <batch_op Op, size_t N>
+using batch_kernel_t = void (*) (batch_arg_t<Op, N> const* x,
+                                 batch_arg_t<Op, N> const* y,
+                                 batch_arg_t<Op, N>* out, size_t n);
+
+/// True if \p Op has a variant which reports the elements that saturated
+/// (see batch_ovf_kernel_t).
+constexpr bool is_ovf_op (batch_op const op) {
+  return op == batch_op::addu || op == batch_op::adds ||
+         op == batch_op::subu || op == batch_op::subs ||
+         op == batch_op::mulu || op == batch_op::muls;
+}
+
+/// True if \p Op is an addition or subtraction.
+constexpr bool is_add_sub_op (batch_op const op) {
+  return op == batch_op::addu || op == batch_op::adds ||
+         op == batch_op::subu || op == batch_op::subs;
+}
+
+/// The type of a batch kernel which also reports the elements that
+/// saturated: as batch_kernel_t, and sets bit i % 8 of clipped[i / 8] if
+/// the result for element i was clamped (clearing it otherwise). Any unused
+/// bits of the final byte of \p clipped are cleared.
+template <batch_op Op, size_t N>
+using batch_ovf_kernel_t = void (*) (batch_arg_t<Op, N> const* x,
+                                     batch_arg_t<Op, N> const* y,
+                                     batch_arg_t<Op, N>* out,
+                                     uint8_t* clipped, size_t n);
+
+/// Maps batch_op values to the scalar function templates which implement
+/// them. For the operations where is_ovf_op() is true, apply_ovf() calls the
+/// function which also reports saturation.
+template <batch_op Op, size_t N>
+struct scalar_op;
+
+template <size_t N>
+struct scalar_op<batch_op::addu, N> {
+  static constexpr uinteger_t<N> apply (uinteger_t<N> const x,
+                                        uinteger_t<N> const y) {
+    return addu<N> (x, y);
+  }
+  static constexpr ovf_result<uinteger_t<N>> apply_ovf (
+      uinteger_t<N> const x, uinteger_t<N> const y) {
+    return addu_ovf<N> (x, y);
+  }
+};
+template <size_t N>
+struct scalar_op<batch_op::adds, N> {
+  static constexpr sinteger_t<N> apply (sinteger_t<N> const x,
+                                        sinteger_t<N> const y) {
+    return adds<N> (x, y);
+  }
+  static constexpr ovf_result<sinteger_t<N>> apply_ovf (
+      sinteger_t<N> const x, sinteger_t<N> const y) {
+    return adds_ovf<N> (x, y);
+  }
+};
+template <size_t N>
+struct scalar_op<batch_op::subu, N> {
+  static constexpr uinteger_t<N> apply (uinteger_t<N> const x,
+                                        uinteger_t<N> const y) {
+    return subu<N> (x, y);
+  }
+  static constexpr ovf_result<uinteger_t<N>> apply_ovf (
+      uinteger_t<N> const x, uinteger_t<N> const y) {
+    return subu_ovf<N> (x, y);
+  }
+};
+template <size_t N>
+struct scalar_op<batch_op::subs, N> {
+  static constexpr sinteger_t<N> apply (sinteger_t<N> const x,
+                                        sinteger_t<N> const y) {
+    return subs<N> (x, y);
+  }
+  static constexpr ovf_result<sinteger_t<N>> apply_ovf (
+      sinteger_t<N> const x, sinteger_t<N> const y) {
+    return subs_ovf<N> (x, y);
+  }
+};
+
+template <size_t N>
+struct scalar_op<batch_op::mulu, N> {
+  static constexpr uinteger_t<N> apply (uinteger_t<N> const x,
+                                        uinteger_t<N> const y) {
+    return mulu<N> (x, y);
+  }
+  static constexpr ovf_result<uinteger_t<N>> apply_ovf (
+      uinteger_t<N> const x, uinteger_t<N> const y) {
+    return mulu_ovf<N> (x, y);
+  }
+};
+template <size_t N>
+struct scalar_op<batch_op::muls, N> {
+  static constexpr sinteger_t<N> apply (sinteger_t<N> const x,
+                                        sinteger_t<N> const y) {
+    return muls<N> (x, y);
+  }
+  static constexpr ovf_result<sinteger_t<N>> apply_ovf (
+      sinteger_t<N> const x, sinteger_t<N> const y) {
+    return muls_ovf<N> (x, y);
+  }
+};
+template <size_t N>
+struct scalar_op<batch_op::divu, N> {
+  static constexpr uinteger_t<N> apply (uinteger_t<N> const x,
+                                        uinteger_t<N> const y) {
+    return divu<N> (x, y);
+  }
+};
+template <size_t N>
+struct scalar_op<batch_op::divs, N> {
+  static constexpr sinteger_t<N> apply (sinteger_t<N> const x,
+                                        sinteger_t<N> const y) {
+    return divs<N> (x, y);
+  }
+};
+template <size_t N>
+struct scalar_op<batch_op::divu_saturate, N> {
+  static constexpr uinteger_t<N> apply (uinteger_t<N> const x,
+                                        uinteger_t<N> const y) {
+    return divu<N, divide_by_zero::saturate> (x, y);
+  }
+};
+template <size_t N>
+struct scalar_op<batch_op::divs_saturate, N> {
+  static constexpr sinteger_t<N> apply (sinteger_t<N> const x,
+                                        sinteger_t<N> const y) {
+    return divs<N, divide_by_zero::saturate> (x, y);
+  }
+};
+
+/// Applies the elementwise operation \p Op to elements [\p first, \p last) of
+/// the arrays \p x and \p y using the scalar function templates. This is used
+/// both as the portable batch kernel and to process the tail elements which
+/// do not fill a complete vector register.
+template <batch_op Op, size_t N>
+inline void batch_scalar_range (batch_arg_t<Op, N> const* const x,
+                                batch_arg_t<Op, N> const* const y,
+                                batch_arg_t<Op, N>* const out,
+                                size_t first, size_t const last) {
+  for (; first < last; ++first) {
+    out[first] = scalar_op<Op, N>::apply (x[first], y[first]);
+  }
+}
+
+/// The portable batch kernel.
+template <batch_op Op, size_t N>
+void batch_scalar (batch_arg_t<Op, N> const* const x,
+                   batch_arg_t<Op, N> const* const y,
+                   batch_arg_t<Op, N>* const out, size_t const n) {
+  batch_scalar_range<Op, N> (x, y, out, 0U, n);
+}
+
+/// Accumulates the bits of the packed mask written by a batch_ovf_kernel_t
+/// and stores them 64 bits at a time.
+class clip_mask_writer {
+public:
+  explicit clip_mask_writer (uint8_t* const clipped) noexcept
+      : clipped_{clipped} {}
+
+  /// Records the bits for the \p count elements starting at \p first. The
+  /// bit for element first + i is bit i of \p bits. \p count must be a
+  /// power of two no greater than 64 and \p first a multiple of \p count.
+  void put (size_t const first, size_t const count,
+            uint64_t const bits) noexcept {
+    word_ |= bits << (first % 64U);
+    if ((first + count) % 64U == 0U) {
+      store<8U> (first + count - 64U);
+    }
+  }
+  /// Stores the bits for the elements following the last multiple of 64 in
+  /// an array of \p n elements.
+  void finish (size_t const n) noexcept {
+    if (auto const tail = n % 64U; tail != 0U) {
+      store (n - tail, (tail + 7U) / 8U);
+    }
+  }
+
+private:
+  /// Writes the first \p bytes bytes of the accumulated word (least
+  /// significant first) for the elements starting at \p first and clears
+  /// it.
+  void store (size_t const first, size_t const bytes) noexcept {
+    auto* const dest = clipped_ + first / 8U;
+    for (auto b = size_t{0}; b < bytes; ++b) {
+      dest[b] = static_cast<uint8_t> (word_ >> (b * 8U));
+    }
+    word_ = 0U;
+  }
+  /// As store() for a constant number of bytes, which the compiler can
+  /// combine into a single store.
+  template <size_t Bytes>
+  void store (size_t const first) noexcept {
+    auto* const dest = clipped_ + first / 8U;
+    for (auto b = size_t{0}; b < Bytes; ++b) {
+      dest[b] = static_cast<uint8_t> (word_ >> (b * 8U));
+    }
+    word_ = 0U;
+  }
+
+  uint8_t* clipped_;
+  uint64_t word_ = 0U;
+};
+
+/// Applies the elementwise operation \p Op to elements [\p first, \p last)
+/// of the arrays \p x and \p y using the scalar functions which report
+/// saturation, recording the saturated elements in \p clipped.
+template <batch_op Op, size_t N>
+inline void batch_scalar_ovf_range (batch_arg_t<Op, N> const* const x,
+                                    batch_arg_t<Op, N> const* const y,
+                                    batch_arg_t<Op, N>* const out,
+                                    clip_mask_writer& clipped, size_t first,
+                                    size_t const last) {
+  for (; first < last; ++first) {
+    auto const [value, saturated] =
+        scalar_op<Op, N>::apply_ovf (x[first], y[first]);
+    out[first] = value;
+    clipped.put (first, 1U, saturated);
+  }
+}
+
+/// The portable batch kernel which reports saturation.
+template <batch_op Op, size_t N>
+void batch_scalar_ovf (batch_arg_t<Op, N> const* const x,
+                       batch_arg_t<Op, N> const* const y,
+                       batch_arg_t<Op, N>* const out, uint8_t* const clipped,
+                       size_t const n) {
+  auto writer = clip_mask_writer{clipped};
+  batch_scalar_ovf_range<Op, N> (x, y, out, writer, 0U, n);
+  writer.finish (n);
+}
+
+}  // end namespace details
+
+}  // end namespace saturation
+
+#endif  // SATURATION_BATCH_KERNEL_HPP
@@ -0,0 +1,763 @@
+/// \file batch_sse2.hpp
+/// \brief Batch kernels using the x86 SSE2 instruction set. SSE2 is part of
+/// the x86-64 baseline so these kernels are always available on that target.
+
+#ifndef SATURATION_BATCH_SSE2_HPP
+#define SATURATION_BATCH_SSE2_HPP
+
+#include "saturation/batch_kernel.hpp"
+
+#ifndef NO_SIMD
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <emmintrin.h>
+
+namespace saturation {
+
+namespace details {
+
+namespace sse2 {
+
+/// Defines the vector implementation of the operation \p Op on lanes of \p N
+/// bits. The primary template is used when SSE2 provides no implementation.
+template <batch_op Op, size_t N, typename = void>
+struct lanes {
+  static constexpr bool available = false;
+};
+
+template <>
+struct lanes<batch_op::addu, 8> {
+  static constexpr bool available = true;
+  static __m128i apply (__m128i const x, __m128i const y) {
+    return _mm_adds_epu8 (x, y);  // paddusb
+  }
+};
+template <>
+struct lanes<batch_op::adds, 8> {
+  static constexpr bool available = true;
+  static __m128i apply (__m128i const x, __m128i const y) {
+    return _mm_adds_epi8 (x, y);  // paddsb
+  }
+};
+template <>
+struct lanes<batch_op::subu, 8> {
+  static constexpr bool available = true;
+  static __m128i apply (__m128i const x, __m128i const y) {
+    return _mm_subs_epu8 (x, y);  // psubusb
+  }
+};
+template <>
+struct lanes<batch_op::subs, 8> {
+  static constexpr bool available = true;
+  static __m128i apply (__m128i const x, __m128i const y) {
+    return _mm_subs_epi8 (x, y);  // psubsb
+  }
+};
+template <>
+struct lanes<batch_op::addu, 16> {
+  static constexpr bool available = true;
+  static __m128i apply (__m128i const x, __m128i const y) {
+    return _mm_adds_epu16 (x, y);  // paddusw
+  }
+};
+template <>
+struct lanes<batch_op::adds, 16> {
+  static constexpr bool available = true;
+  static __m128i apply (__m128i const x, __m128i const y) {
+    return _mm_adds_epi16 (x, y);  // paddsw
+  }
+};
+template <>
+struct lanes<batch_op::subu, 16> {
+  static constexpr bool available = true;
+  static __m128i apply (__m128i const x, __m128i const y) {
+    return _mm_subs_epu16 (x, y);  // psubusw
+  }
+};
+template <>
+struct lanes<batch_op::subs, 16> {
+  static constexpr bool available = true;
+  static __m128i apply (__m128i const x, __m128i const y) {
+    return _mm_subs_epi16 (x, y);  // psubsw
+  }
+};
+
+/// \name Lane helpers
+/// Helper functions which select the instruction appropriate for lanes of
+/// \p N bits where \p N is 32 or 64. add() and sub() also accept 8 and 16.
+/// @{
+
+template <size_t N>
+inline __m128i add (__m128i const x, __m128i const y) {
+  if constexpr (N == 8) {
+    return _mm_add_epi8 (x, y);
+  } else if constexpr (N == 16) {
+    return _mm_add_epi16 (x, y);
+  } else if constexpr (N == 32) {
+    return _mm_add_epi32 (x, y);
+  } else {
+    return _mm_add_epi64 (x, y);
+  }
+}
+template <size_t N>
+inline __m128i sub (__m128i const x, __m128i const y) {
+  if constexpr (N == 8) {
+    return _mm_sub_epi8 (x, y);
+  } else if constexpr (N == 16) {
+    return _mm_sub_epi16 (x, y);
+  } else if constexpr (N == 32) {
+    return _mm_sub_epi32 (x, y);
+  } else {
+    return _mm_sub_epi64 (x, y);
+  }
+}
+/// Returns a value in which each lane is all ones if the most significant bit
+/// of the corresponding lane of \p x is set and zero otherwise.
+template <size_t N>
+inline __m128i top_bit_mask (__m128i const x) {
+  if constexpr (N == 32) {
+    return _mm_srai_epi32 (x, 31);
+  } else {
+    // There is no 64 bit arithmetic shift before AVX-512: copy the upper half
+    // of each lane into both halves and shift those instead.
+    return _mm_srai_epi32 (_mm_shuffle_epi32 (x, _MM_SHUFFLE (3, 3, 1, 1)),
+                           31);
+  }
+}
+/// Computes the value to which each lane of a signed operation saturates:
+/// max or min depending on the sign of \p x. This is the vector form of
+/// details::adds_overflow_value().
+template <size_t N>
+inline __m128i overflow_value (__m128i const x) {
+  if constexpr (N == 32) {
+    return _mm_add_epi32 (_mm_srli_epi32 (x, 31),
+                          _mm_set1_epi32 (slimits<32>::max ()));
+  } else {
+    return _mm_add_epi64 (_mm_srli_epi64 (x, 63),
+                          _mm_set1_epi64x (slimits<64>::max ()));
+  }
+}
+/// Returns the lanes of \p x where \p mask is zero and the lanes of \p y
+/// where \p mask is all ones.
+inline __m128i select (__m128i const mask, __m128i const x, __m128i const y) {
+  return _mm_or_si128 (_mm_andnot_si128 (mask, x), _mm_and_si128 (mask, y));
+}
+/// @}
+
+// There are no packed saturating instructions for 32 and 64 bit lanes. These
+// compute the carry (or overflow) of each lane in its most significant bit and
+// use that to select between the wrapped and saturated results.
+template <size_t N>
+struct lanes<batch_op::addu, N, std::enable_if_t<N == 32 || N == 64>> {
+  static constexpr bool available = true;
+  static __m128i apply (__m128i const x, __m128i const y) {
+    auto const sum = add<N> (x, y);
+    // carry = (x & y) | ((x | y) & ~sum)
+    auto const carry =
+        _mm_or_si128 (_mm_and_si128 (x, y),
+                      _mm_andnot_si128 (sum, _mm_or_si128 (x, y)));
+    return _mm_or_si128 (sum, top_bit_mask<N> (carry));
+  }
+};
+template <size_t N>
+struct lanes<batch_op::subu, N, std::enable_if_t<N == 32 || N == 64>> {
+  static constexpr bool available = true;
+  static __m128i apply (__m128i const x, __m128i const y) {
+    auto const diff = sub<N> (x, y);
+    // borrow = (~x & y) | (~(x ^ y) & diff)
+    auto const borrow =
+        _mm_or_si128 (_mm_andnot_si128 (x, y),
+                      _mm_andnot_si128 (_mm_xor_si128 (x, y), diff));
+    return _mm_andnot_si128 (top_bit_mask<N> (borrow), diff);
+  }
+};
+template <size_t N>
+struct lanes<batch_op::adds, N, std::enable_if_t<N == 32 || N == 64>> {
+  static constexpr bool available = true;
+  static __m128i apply (__m128i const x, __m128i const y) {
+    auto const sum = add<N> (x, y);
+    // Overflow if x and y have the same sign and the sign of sum differs.
+    auto const overflow =
+        _mm_andnot_si128 (_mm_xor_si128 (x, y), _mm_xor_si128 (x, sum));
+    return select (top_bit_mask<N> (overflow), sum, overflow_value<N> (x));
+  }
+};
+template <size_t N>
+struct lanes<batch_op::subs, N, std::enable_if_t<N == 32 || N == 64>> {
+  static constexpr bool available = true;
+  static __m128i apply (__m128i const x, __m128i const y) {
+    auto const diff = sub<N> (x, y);
+    // Overflow if x and y have different signs and the sign of diff differs
+    // from that of x.
+    auto const overflow =
+        _mm_and_si128 (_mm_xor_si128 (x, y), _mm_xor_si128 (x, diff));
+    return select (top_bit_mask<N> (overflow), diff, overflow_value<N> (x));
+  }
+};
+
+/// \name Padded lane helpers
+/// Signed lanes of 8, 16 or 32 bits for values which do not fill them (see
+/// is_padded_width()). SSE2 has signed min and max only for 16 bit lanes.
+/// @{
+
+/// Returns a value with every lane set to \p v.
+template <size_t N>
+inline __m128i set1 (int64_t const v) {
+  if constexpr (N == 8) {
+    return _mm_set1_epi8 (static_cast<char> (v));
+  } else if constexpr (N == 16) {
+    return _mm_set1_epi16 (static_cast<short> (v));
+  } else {
+    return _mm_set1_epi32 (static_cast<int> (v));
+  }
+}
+/// Returns a value in which each lane is all ones if the corresponding lane
+/// of \p x is greater than that of \p y and zero otherwise.
+template <size_t N>
+inline __m128i greater (__m128i const x, __m128i const y) {
+  if constexpr (N == 8) {
+    return _mm_cmpgt_epi8 (x, y);
+  } else if constexpr (N == 16) {
+    return _mm_cmpgt_epi16 (x, y);
+  } else {
+    return _mm_cmpgt_epi32 (x, y);
+  }
+}
+/// Returns the lanewise signed minimum of \p x and \p y.
+template <size_t N>
+inline __m128i min (__m128i const x, __m128i const y) {
+  if constexpr (N == 16) {
+    return _mm_min_epi16 (x, y);  // pminsw
+  } else {
+    // There is no pminsb or pminsd before SSE4.1.
+    return select (greater<N> (x, y), x, y);
+  }
+}
+/// Returns the lanewise signed maximum of \p x and \p y.
+template <size_t N>
+inline __m128i max (__m128i const x, __m128i const y) {
+  if constexpr (N == 16) {
+    return _mm_max_epi16 (x, y);  // pmaxsw
+  } else {
+    return select (greater<N> (x, y), y, x);
+  }
+}
+/// @}
+
+// The kernels for values which do not fill their lanes.
+template <size_t N>
+struct lanes<batch_op::addu, N, std::enable_if_t<is_padded_width (N)>> {
+  static constexpr bool available = true;
+  static __m128i apply (__m128i const x, __m128i const y) {
+    constexpr auto lane = lane_width<batch_op::addu, N> ();
+    constexpr auto upper = ulimits<N>::max ();
+    return add<lane> (x, min<lane> (y, sub<lane> (set1<lane> (upper), x)));
+  }
+};
+template <size_t N>
+struct lanes<batch_op::subu, N, std::enable_if_t<is_padded_width (N)>> {
+  static constexpr bool available = true;
+  static __m128i apply (__m128i const x, __m128i const y) {
+    constexpr auto lane = lane_width<batch_op::subu, N> ();
+    return max<lane> (sub<lane> (x, y), _mm_setzero_si128 ());
+  }
+};
+template <size_t N>
+struct lanes<batch_op::adds, N, std::enable_if_t<is_padded_width (N)>> {
+  static constexpr bool available = true;
+  static __m128i apply (__m128i const x, __m128i const y) {
+    constexpr auto lane = lane_width<batch_op::adds, N> ();
+    constexpr auto upper = slimits<N>::max ();
+    constexpr auto lower = slimits<N>::min ();
+    return max<lane> (min<lane> (add<lane> (x, y), set1<lane> (upper)),
+                      set1<lane> (lower));
+  }
+};
+template <size_t N>
+struct lanes<batch_op::subs, N, std::enable_if_t<is_padded_width (N)>> {
+  static constexpr bool available = true;
+  static __m128i apply (__m128i const x, __m128i const y) {
+    constexpr auto lane = lane_width<batch_op::subs, N> ();
+    constexpr auto upper = slimits<N>::max ();
+    constexpr auto lower = slimits<N>::min ();
+    return max<lane> (min<lane> (sub<lane> (x, y), set1<lane> (upper)),
+                      set1<lane> (lower));
+  }
+};
+
+/// \name Multiplication helpers
+/// @{
+
+/// The low- and high-order halves of the double-width products of the lanes
+/// of two vectors.
+struct wide_product {
+  __m128i lo;
+  __m128i hi;
+};
+
+/// Multiplies the unsigned 32 bit lanes of \p x and \p y. pmuludq multiplies
+/// only the even lanes so the odd lanes are shifted into the even positions
+/// and multiplied separately.
+inline wide_product mul_wide_epu32 (__m128i const x, __m128i const y) {
+  auto const low_mask = _mm_set1_epi64x (0xFFFFFFFF);
+  auto const even = _mm_mul_epu32 (x, y);
+  auto const odd =
+      _mm_mul_epu32 (_mm_srli_epi64 (x, 32), _mm_srli_epi64 (y, 32));
+  return {
+      _mm_or_si128 (_mm_and_si128 (even, low_mask), _mm_slli_epi64 (odd, 32)),
+      _mm_or_si128 (_mm_srli_epi64 (even, 32),
+                    _mm_andnot_si128 (low_mask, odd))};
+}
+/// Multiplies the unsigned 64 bit lanes of \p x and \p y. This is the vector
+/// form of details::multiply(): the product is assembled from four 32 x 32
+/// bit partial products.
+inline wide_product mul_wide_epu64 (__m128i const x, __m128i const y) {
+  auto const low_mask = _mm_set1_epi64x (0xFFFFFFFF);
+  auto const x_hi = _mm_srli_epi64 (x, 32);
+  auto const y_hi = _mm_srli_epi64 (y, 32);
+  auto const lo_lo = _mm_mul_epu32 (x, y);
+  auto const hi_lo = _mm_mul_epu32 (x_hi, y);
+  auto const lo_hi = _mm_mul_epu32 (x, y_hi);
+  auto const hi_hi = _mm_mul_epu32 (x_hi, y_hi);
+  // The sum of the middle terms cannot overflow 64 bits.
+  auto const mid = _mm_add_epi64 (
+      _mm_add_epi64 (_mm_srli_epi64 (lo_lo, 32),
+                     _mm_and_si128 (hi_lo, low_mask)),
+      _mm_and_si128 (lo_hi, low_mask));
+  auto const hi = _mm_add_epi64 (
+      _mm_add_epi64 (hi_hi, _mm_srli_epi64 (mid, 32)),
+      _mm_add_epi64 (_mm_srli_epi64 (hi_lo, 32), _mm_srli_epi64 (lo_hi, 32)));
+  return {_mm_or_si128 (_mm_and_si128 (lo_lo, low_mask),
+                        _mm_slli_epi64 (mid, 32)),
+          hi};
+}
+/// Multiplies the lanes of \p x and \p y. Signed products are derived from the
+/// unsigned product by subtracting y (or x) from the high half where x (or y)
+/// is negative.
+template <size_t N, bool IsUnsigned>
+inline wide_product mul_wide (__m128i const x, __m128i const y) {
+  auto product = wide_product{};
+  if constexpr (N == 32) {
+    product = mul_wide_epu32 (x, y);
+  } else {
+    product = mul_wide_epu64 (x, y);
+  }
+  if constexpr (!IsUnsigned) {
+    product.hi = sub<N> (
+        sub<N> (product.hi, _mm_and_si128 (top_bit_mask<N> (x), y)),
+        _mm_and_si128 (top_bit_mask<N> (y), x));
+  }
+  return product;
+}
+/// Returns a value in which each lane is all ones if the corresponding lanes
+/// of \p x and \p y are equal and zero otherwise.
+template <size_t N>
+inline __m128i equal (__m128i const x, __m128i const y) {
+  auto const eq = _mm_cmpeq_epi32 (x, y);
+  if constexpr (N == 32) {
+    return eq;
+  } else {
+    // There is no 64 bit compare before SSE4.1: both halves must be equal.
+    return _mm_and_si128 (eq, _mm_shuffle_epi32 (eq, _MM_SHUFFLE (2, 3, 0, 1)));
+  }
+}
+/// @}
+
+template <>
+struct lanes<batch_op::mulu, 8> {
+  static constexpr bool available = true;
+  static __m128i apply (__m128i const x, __m128i const y) {
+    // Widen to 16 bits, multiply, then clamp to 255 (as min(p, 255) =
+    // p - subs(p, 255)) before packing back to 8 bits.
+    auto const zero = _mm_setzero_si128 ();
+    auto const limit = _mm_set1_epi16 (0xFF);
+    auto const lo = _mm_mullo_epi16 (_mm_unpacklo_epi8 (x, zero),
+                                     _mm_unpacklo_epi8 (y, zero));
+    auto const hi = _mm_mullo_epi16 (_mm_unpackhi_epi8 (x, zero),
+                                     _mm_unpackhi_epi8 (y, zero));
+    return _mm_packus_epi16 (_mm_sub_epi16 (lo, _mm_subs_epu16 (lo, limit)),
+                             _mm_sub_epi16 (hi, _mm_subs_epu16 (hi, limit)));
+  }
+};
+template <>
+struct lanes<batch_op::muls, 8> {
+  static constexpr bool available = true;
+  static __m128i apply (__m128i const x, __m128i const y) {
+    // Sign-extend to 16 bits (where the product cannot overflow), multiply,
+    // and pack back to 8 bits with signed saturation.
+    auto const x_lo = _mm_srai_epi16 (_mm_unpacklo_epi8 (x, x), 8);
+    auto const y_lo = _mm_srai_epi16 (_mm_unpacklo_epi8 (y, y), 8);
+    auto const x_hi = _mm_srai_epi16 (_mm_unpackhi_epi8 (x, x), 8);
+    auto const y_hi = _mm_srai_epi16 (_mm_unpackhi_epi8 (y, y), 8);
+    auto const lo = _mm_mullo_epi16 (x_lo, y_lo);
+    auto const hi = _mm_mullo_epi16 (x_hi, y_hi);
+    return _mm_packs_epi16 (lo, hi);
+  }
+};
+template <>
+struct lanes<batch_op::mulu, 16> {
+  static constexpr bool available = true;
+  static __m128i apply (__m128i const x, __m128i const y) {
+    // pmullw/pmulhuw yield the low and high halves of the product. Lanes with
+    // a non-zero high half saturate.
+    auto const lo = _mm_mullo_epi16 (x, y);
+    auto const hi = _mm_mulhi_epu16 (x, y);
+    auto const no_overflow = _mm_cmpeq_epi16 (hi, _mm_setzero_si128 ());
+    return select (no_overflow, _mm_set1_epi16 (-1), lo);
+  }
+};
+template <>
+struct lanes<batch_op::muls, 16> {
+  static constexpr bool available = true;
+  static __m128i apply (__m128i const x, __m128i const y) {
+    // pmullw/pmulhw yield the low and high halves of the product. Interleaving
+    // them gives the 32 bit products which packssdw saturates to 16 bits.
+    auto const lo = _mm_mullo_epi16 (x, y);
+    auto const hi = _mm_mulhi_epi16 (x, y);
+    return _mm_packs_epi32 (_mm_unpacklo_epi16 (lo, hi),
+                            _mm_unpackhi_epi16 (lo, hi));
+  }
+};
+template <size_t N>
+struct lanes<batch_op::mulu, N, std::enable_if_t<N == 32 || N == 64>> {
+  static constexpr bool available = true;
+  static __m128i apply (__m128i const x, __m128i const y) {
+    // As mulu<>: lanes with a non-zero high half saturate.
+    auto const product = mul_wide<N, true> (x, y);
+    return select (equal<N> (product.hi, _mm_setzero_si128 ()),
+                   _mm_set1_epi32 (-1), product.lo);
+  }
+};
+template <size_t N>
+struct lanes<batch_op::muls, N, std::enable_if_t<N == 32 || N == 64>> {
+  static constexpr bool available = true;
+  static __m128i apply (__m128i const x, __m128i const y) {
+    // As muls<>: the product fits if the high half is the sign extension of
+    // the low half. If not, the result saturates according to the sign of
+    // x ^ y (see details::overflow_value()).
+    auto const product = mul_wide<N, false> (x, y);
+    return select (equal<N> (product.hi, top_bit_mask<N> (product.lo)),
+                   overflow_value<N> (_mm_xor_si128 (x, y)), product.lo);
+  }
+};
+
+/// \name Division helpers
+/// There are no integer division instructions. Instead, lanes are converted
+/// to floating point, divided, and the quotient truncated. As for
+/// details::divu_double(), this is exact provided that the floating-point
+/// type has at least twice as many significant bits as the integer lanes:
+/// float is used for lanes of up to 16 bits and double for 32 bit lanes.
+/// @{
+
+/// Divides 32 bit lanes holding signed values of no more than 16 bits and
+/// truncates the quotient.
+inline __m128i div_ps (__m128i const x, __m128i const y) {
+  return _mm_cvttps_epi32 (
+      _mm_div_ps (_mm_cvtepi32_ps (x), _mm_cvtepi32_ps (y)));
+}
+/// Sign-extends the low (\p Hi false) or high (\p Hi true) four 16 bit lanes
+/// of \p x to 32 bits.
+template <bool Hi>
+inline __m128i widen_epi16 (__m128i const x) {
+  if constexpr (Hi) {
+    return _mm_srai_epi32 (_mm_unpackhi_epi16 (x, x), 16);
+  } else {
+    return _mm_srai_epi32 (_mm_unpacklo_epi16 (x, x), 16);
+  }
+}
+/// Converts the 32 bit lanes of \p x (holding unsigned values) to double.
+/// Only the low two lanes are converted.
+inline __m128d cvtepu32_pd (__m128i const x) {
+  // Bias the value into the signed range, convert, and remove the bias.
+  auto const bias = _mm_set1_epi32 (slimits<32>::min ());
+  return _mm_add_pd (_mm_cvtepi32_pd (_mm_xor_si128 (x, bias)),
+                     _mm_set1_pd (2147483648.0));
+}
+/// Truncates the unsigned values in the two lanes of \p q to 32 bits. The
+/// results are placed in the low two 32 bit lanes.
+inline __m128i cvttpd_epu32 (__m128d const q) {
+  // cvttpd2dq produces 0x80000000 for values too large to be represented
+  // (that is, 2^31 or more). Those are converted again after subtracting
+  // 2^31.
+  auto const min = _mm_set1_epi32 (slimits<32>::min ());
+  auto const small = _mm_cvttpd_epi32 (q);
+  auto const large = _mm_xor_si128 (
+      _mm_cvttpd_epi32 (_mm_sub_pd (q, _mm_set1_pd (2147483648.0))), min);
+  return select (_mm_cmpeq_epi32 (small, min), small, large);
+}
+/// @}
+
+template <>
+struct lanes<batch_op::divu, 16> {
+  static constexpr bool available = true;
+  static __m128i apply (__m128i const x, __m128i const y) {
+    auto const zero = _mm_setzero_si128 ();
+    auto const lo =
+        div_ps (_mm_unpacklo_epi16 (x, zero), _mm_unpacklo_epi16 (y, zero));
+    auto const hi =
+        div_ps (_mm_unpackhi_epi16 (x, zero), _mm_unpackhi_epi16 (y, zero));
+    // There is no unsigned 32 to 16 bit pack before SSE4.1. Biasing the
+    // quotients into the signed range allows packssdw to be used instead.
+    auto const bias = _mm_set1_epi32 (0x8000);
+    return _mm_xor_si128 (_mm_packs_epi32 (_mm_sub_epi32 (lo, bias),
+                                           _mm_sub_epi32 (hi, bias)),
+                          _mm_set1_epi16 (-0x8000));
+  }
+};
+template <>
+struct lanes<batch_op::divs, 16> {
+  static constexpr bool available = true;
+  static __m128i apply (__m128i const x, __m128i const y) {
+    // The only quotient which does not fit in 16 bits is -2^15 / -1 = 2^15
+    // which packssdw saturates to 2^15-1 as required.
+    auto const lo = div_ps (widen_epi16<false> (x), widen_epi16<false> (y));
+    auto const hi = div_ps (widen_epi16<true> (x), widen_epi16<true> (y));
+    return _mm_packs_epi32 (lo, hi);
+  }
+};
+template <>
+struct lanes<batch_op::divu, 8> {
+  static constexpr bool available = true;
+  static __m128i apply (__m128i const x, __m128i const y) {
+    // Widen to 16 bits and divide. The quotients fit in 8 bits.
+    using divide = lanes<batch_op::divu, 16>;
+    auto const zero = _mm_setzero_si128 ();
+    return _mm_packus_epi16 (divide::apply (_mm_unpacklo_epi8 (x, zero),
+                                            _mm_unpacklo_epi8 (y, zero)),
+                             divide::apply (_mm_unpackhi_epi8 (x, zero),
+                                            _mm_unpackhi_epi8 (y, zero)));
+  }
+};
+template <>
+struct lanes<batch_op::divs, 8> {
+  static constexpr bool available = true;
+  static __m128i apply (__m128i const x, __m128i const y) {
+    // Sign-extend to 16 bits and divide. packsswb saturates -2^7 / -1.
+    using divide = lanes<batch_op::divs, 16>;
+    auto const x_lo = _mm_srai_epi16 (_mm_unpacklo_epi8 (x, x), 8);
+    auto const y_lo = _mm_srai_epi16 (_mm_unpacklo_epi8 (y, y), 8);
+    auto const x_hi = _mm_srai_epi16 (_mm_unpackhi_epi8 (x, x), 8);
+    auto const y_hi = _mm_srai_epi16 (_mm_unpackhi_epi8 (y, y), 8);
+    return _mm_packs_epi16 (divide::apply (x_lo, y_lo),
+                            divide::apply (x_hi, y_hi));
+  }
+};
+template <>
+struct lanes<batch_op::divu, 32> {
+  static constexpr bool available = true;
+  static __m128i apply (__m128i const x, __m128i const y) {
+    auto const x_hi = _mm_shuffle_epi32 (x, _MM_SHUFFLE (3, 2, 3, 2));
+    auto const y_hi = _mm_shuffle_epi32 (y, _MM_SHUFFLE (3, 2, 3, 2));
+    auto const lo =
+        cvttpd_epu32 (_mm_div_pd (cvtepu32_pd (x), cvtepu32_pd (y)));
+    auto const hi =
+        cvttpd_epu32 (_mm_div_pd (cvtepu32_pd (x_hi), cvtepu32_pd (y_hi)));
+    return _mm_unpacklo_epi64 (lo, hi);
+  }
+};
+template <>
+struct lanes<batch_op::divs, 32> {
+  static constexpr bool available = true;
+  static __m128i apply (__m128i const x, __m128i const y) {
+    // -2^31 / -1 = 2^31 is clamped to 2^31-1 before it is converted.
+    auto const max = _mm_set1_pd (slimits<32>::max ());
+    auto const x_hi = _mm_shuffle_epi32 (x, _MM_SHUFFLE (3, 2, 3, 2));
+    auto const y_hi = _mm_shuffle_epi32 (y, _MM_SHUFFLE (3, 2, 3, 2));
+    auto const lo = _mm_cvttpd_epi32 (_mm_min_pd (
+        _mm_div_pd (_mm_cvtepi32_pd (x), _mm_cvtepi32_pd (y)), max));
+    auto const hi = _mm_cvttpd_epi32 (_mm_min_pd (
+        _mm_div_pd (_mm_cvtepi32_pd (x_hi), _mm_cvtepi32_pd (y_hi)), max));
+    return _mm_unpacklo_epi64 (lo, hi);
+  }
+};
+
+/// \name Divide-by-zero helpers
+/// Helper functions for the divide_by_zero::saturate policy which select the
+/// instruction appropriate for lanes of \p N bits where \p N is 8, 16 or 32.
+/// @{
+
+/// Returns a value in which each lane is all ones if the corresponding lane
+/// of \p x is zero and zero otherwise.
+template <size_t N>
+inline __m128i is_zero (__m128i const x) {
+  auto const zero = _mm_setzero_si128 ();
+  if constexpr (N == 8) {
+    return _mm_cmpeq_epi8 (x, zero);
+  } else if constexpr (N == 16) {
+    return _mm_cmpeq_epi16 (x, zero);
+  } else {
+    return _mm_cmpeq_epi32 (x, zero);
+  }
+}
+/// Replaces the lanes of the divisor \p y which are zero (those which are all
+/// ones in \p zero) with 1.
+template <size_t N>
+inline __m128i nonzero (__m128i const y, __m128i const zero) {
+  if constexpr (N == 8) {
+    return _mm_sub_epi8 (y, zero);
+  } else if constexpr (N == 16) {
+    return _mm_sub_epi16 (y, zero);
+  } else {
+    return _mm_sub_epi32 (y, zero);
+  }
+}
+/// Computes the value to which each lane of a signed division by zero
+/// saturates: max, min, or zero depending on the sign of \p x.
+template <size_t N>
+inline __m128i divide_by_zero_value (__m128i const x) {
+  auto const zero = _mm_setzero_si128 ();
+  auto max = __m128i{};
+  auto negative = __m128i{};
+  if constexpr (N == 8) {
+    max = _mm_set1_epi8 (slimits<8>::max ());
+    negative = _mm_cmpgt_epi8 (zero, x);
+  } else if constexpr (N == 16) {
+    max = _mm_set1_epi16 (slimits<16>::max ());
+    negative = _mm_cmpgt_epi16 (zero, x);
+  } else {
+    max = _mm_set1_epi32 (slimits<32>::max ());
+    negative = _mm_cmpgt_epi32 (zero, x);
+  }
+  // max ^ -1 is min.
+  return _mm_andnot_si128 (is_zero<N> (x), _mm_xor_si128 (max, negative));
+}
+/// @}
+
+// Division with the divide_by_zero::saturate policy replaces zero divisors
+// with 1 then overwrites the corresponding quotients.
+template <size_t N>
+struct lanes<batch_op::divu_saturate, N,
+             std::enable_if_t<N == 8 || N == 16 || N == 32>> {
+  static constexpr bool available = true;
+  static __m128i apply (__m128i const x, __m128i const y) {
+    auto const zero = is_zero<N> (y);
+    auto const q = lanes<batch_op::divu, N>::apply (x, nonzero<N> (y, zero));
+    // The quotient is x: OR with all ones unless x is 0.
+    return _mm_or_si128 (q, _mm_andnot_si128 (is_zero<N> (x), zero));
+  }
+};
+template <size_t N>
+struct lanes<batch_op::divs_saturate, N,
+             std::enable_if_t<N == 8 || N == 16 || N == 32>> {
+  static constexpr bool available = true;
+  static __m128i apply (__m128i const x, __m128i const y) {
+    auto const zero = is_zero<N> (y);
+    auto const q = lanes<batch_op::divs, N>::apply (x, nonzero<N> (y, zero));
+    return select (zero, q, divide_by_zero_value<N> (x));
+  }
+};
+
+/// Applies \p Op to \p n pairs of values from \p x and \p y, a full SSE2
+/// register at a time, passing any remaining elements to the scalar
+/// implementation.
+template <batch_op Op, size_t N>
+void run (batch_arg_t<Op, N> const* const x, batch_arg_t<Op, N> const* const y,
+          batch_arg_t<Op, N>* const out, size_t const n) {
+  constexpr auto width = sizeof (__m128i) / sizeof (batch_arg_t<Op, N>);
+  auto i = size_t{0};
+  for (; n - i >= width; i += width) {
+    auto const vx = _mm_loadu_si128 (reinterpret_cast<__m128i const*> (x + i));
+    auto const vy = _mm_loadu_si128 (reinterpret_cast<__m128i const*> (y + i));
+    _mm_storeu_si128 (reinterpret_cast<__m128i*> (out + i),
+                      lanes<Op, N>::apply (vx, vy));
+  }
+  batch_scalar_range<Op, N> (x, y, out, i, n);
+}
+
+/// Returns the SSE2 kernel for \p Op on values of \p N bits or nullptr if
+/// there is none.
+template <batch_op Op, size_t N>
+constexpr batch_kernel_t<Op, N> kernel () {
+  if constexpr (lanes<Op, N>::available) {
+    return &run<Op, N>;
+  } else {
+    return nullptr;
+  }
+}
+
+/// \name Saturation reporting helpers
+/// @{
+
+/// Returns one bit for each lane of \p N bits, set if the corresponding lanes
+/// of \p x and \p y differ. The bit for the first lane is bit 0.
+template <size_t N>
+inline uint64_t not_equal_bits (__m128i const x, __m128i const y) {
+  auto equal_bits = 0U;
+  if constexpr (N == 8) {
+    equal_bits = static_cast<unsigned> (
+        _mm_movemask_epi8 (_mm_cmpeq_epi8 (x, y)));  // pmovmskb
+  } else if constexpr (N == 16) {
+    // packsswb narrows the comparison results to bytes for pmovmskb.
+    auto const eq = _mm_cmpeq_epi16 (x, y);
+    equal_bits = static_cast<unsigned> (
+        _mm_movemask_epi8 (_mm_packs_epi16 (eq, eq)));
+  } else if constexpr (N == 32) {
+    equal_bits = static_cast<unsigned> (
+        _mm_movemask_ps (_mm_castsi128_ps (_mm_cmpeq_epi32 (x, y))));
+  } else {
+    equal_bits = static_cast<unsigned> (
+        _mm_movemask_pd (_mm_castsi128_pd (equal<64> (x, y))));
+  }
+  constexpr auto lanes_mask = (1U << (128U / N)) - 1U;
+  return ~equal_bits & lanes_mask;
+}
+/// Returns the wrapped (modular) result of the addition or subtraction \p Op
+/// on lanes of \p N bits.
+template <batch_op Op, size_t N>
+inline __m128i wrapped (__m128i const x, __m128i const y) {
+  if constexpr (Op == batch_op::addu || Op == batch_op::adds) {
+    return add<N> (x, y);
+  } else {
+    return sub<N> (x, y);
+  }
+}
+/// @}
+
+/// As run() but also records the elements that saturated in \p clipped. An
+/// addition or subtraction saturates exactly where its result differs from
+/// the wrapped result: the wrapped result is either exact (for values which
+/// do not fill their lanes) or, having overflowed, lies at the opposite end
+/// of the range from the limit to which the result is clamped.
+template <batch_op Op, size_t N>
+void run_ovf (batch_arg_t<Op, N> const* const x,
+              batch_arg_t<Op, N> const* const y,
+              batch_arg_t<Op, N>* const out, uint8_t* const clipped,
+              size_t const n) {
+  static_assert (is_add_sub_op (Op));
+  constexpr auto width = sizeof (__m128i) / sizeof (batch_arg_t<Op, N>);
+  constexpr auto lane = lane_width<Op, N> ();
+  auto writer = clip_mask_writer{clipped};
+  auto i = size_t{0};
+  for (; n - i >= width; i += width) {
+    auto const vx = _mm_loadu_si128 (reinterpret_cast<__m128i const*> (x + i));
+    auto const vy = _mm_loadu_si128 (reinterpret_cast<__m128i const*> (y + i));
+    auto const res = lanes<Op, N>::apply (vx, vy);
+    _mm_storeu_si128 (reinterpret_cast<__m128i*> (out + i), res);
+    writer.put (i, width,
+                not_equal_bits<lane> (res, wrapped<Op, lane> (vx, vy)));
+  }
+  batch_scalar_ovf_range<Op, N> (x, y, out, writer, i, n);
+  writer.finish (n);
+}
+
+/// Returns the SSE2 kernel which reports saturation for \p Op on values of
+/// \p N bits or nullptr if there is none. There are kernels for addition and
+/// subtraction.
+template <batch_op Op, size_t N>
+constexpr batch_ovf_kernel_t<Op, N> ovf_kernel () {
+  if constexpr (is_add_sub_op (Op) && lanes<Op, N>::available) {
+    return &run_ovf<Op, N>;
+  } else {
+    return nullptr;
+  }
+}
+
+}  // end namespace sse2
+
+}  // end namespace details
+
+}  // end namespace saturation
+
+#endif  // __GNUC__ && __x86_64__
+#endif  // NO_SIMD
+
+#endif  // SATURATION_BATCH_SSE2_HPP
@@ -0,0 +1,136 @@
+/// \file cpu.hpp
+/// \brief Run-time detection of the instruction set extensions available to
+/// the batch kernels.
+///
+/// The host processor is probed once, on first use. The environment variable
+/// SATURATION_ISA may be set to one of "scalar", "sse2", "avx2", or "avx512"
+/// to restrict the kernels to that level (for example, to benchmark one
+/// implementation against another). A level higher than that supported by the
+/// host is ignored.
+
+#ifndef SATURATION_CPU_HPP
+#define SATURATION_CPU_HPP
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <cpuid.h>
+#endif  // __GNUC__ && (__x86_64__ || __i386__)
+
+namespace saturation {
+
+/// The instruction set levels for which batch kernels may be provided. Each
+/// level implies support for those that precede it.
+enum class isa {
+  scalar,  ///< Portable code only.
+  sse2,    ///< x86-64 SSE2 (always available on x86-64).
+  avx2,    ///< x86-64 AVX2.
+  avx512,  ///< x86-64 AVX-512 F and BW.
+};
+
+/// Returns the name of an instruction set level. This is the string accepted
+/// by the SATURATION_ISA environment variable.
+constexpr char const* to_string (isa const level) noexcept {
+  switch (level) {
+  case isa::scalar: return "scalar";
+  case isa::sse2: return "sse2";
+  case isa::avx2: return "avx2";
+  case isa::avx512: return "avx512";
+  }
+  return "unknown";
+}
+
+namespace details {
+
+/// Probes the host processor for the most capable instruction set level that
+/// it supports.
+inline isa probe_isa () noexcept {
+#if !defined(NO_SIMD) && defined(__GNUC__) && defined(__x86_64__)
+  __builtin_cpu_init ();
+  if (__builtin_cpu_supports ("avx512f") &&
+      __builtin_cpu_supports ("avx512bw")) {
+    return isa::avx512;
+  }
+  if (__builtin_cpu_supports ("avx2")) {
+    return isa::avx2;
+  }
+  return isa::sse2;
+#else
+  return isa::scalar;
+#endif  // !NO_SIMD && __GNUC__ && __x86_64__
+}
+
+/// Applies an instruction set override.
+///
+/// \param value  The override requested by the user (normally the value of
+///   the SATURATION_ISA environment variable) or nullptr if there is none.
+/// \param detected  The instruction set level supported by the host.
+/// \returns  The level named by \p value if that is no greater than
+///   \p detected; otherwise \p detected.
+inline isa apply_isa_override (char const* const value,
+                               isa const detected) noexcept {
+  if (value != nullptr) {
+    for (auto const level :
+         {isa::scalar, isa::sse2, isa::avx2, isa::avx512}) {
+      if (std::strcmp (value, to_string (level)) == 0) {
+        return level < detected ? level : detected;
+      }
+    }
+  }
+  return detected;
+}
+
+}  // end namespace details
+
+/// Returns the most capable instruction set level supported by the host
+/// processor.
+inline isa detected_isa () noexcept {
+  static isa const level = details::probe_isa ();
+  return level;
+}
+
+/// Returns the instruction set level used to select batch kernels. This is
+/// detected_isa() restricted by the SATURATION_ISA environment variable.
+inline isa selected_isa () noexcept {
+#if !defined(NO_SIMD) && defined(__GNUC__) && defined(__x86_64__)
+  static isa const level = details::apply_isa_override (
+      std::getenv ("SATURATION_ISA"), detected_isa ());
+  return level;
+#else
+  return detected_isa ();
+#endif  // !NO_SIMD && __GNUC__ && __x86_64__
+}
+
+/// Returns the host processor's model name (on x86, the brand string reported
+/// by the cpuid instruction) or "unknown" if it cannot be determined.
+inline std::string cpu_model () {
+  std::string result;
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+  unsigned regs[4] = {0U, 0U, 0U, 0U};
+  if (__get_cpuid (0x80000000U, &regs[0], &regs[1], &regs[2], &regs[3]) != 0 &&
+      regs[0] >= 0x80000004U) {
+    for (auto leaf = 0x80000002U; leaf <= 0x80000004U; ++leaf) {
+      __get_cpuid (leaf, &regs[0], &regs[1], &regs[2], &regs[3]);
+      char chars[sizeof (regs)];
+      std::memcpy (chars, regs, sizeof (regs));
+      result.append (chars, sizeof (chars));
+    }
+  }
+#endif  // __GNUC__ && (__x86_64__ || __i386__)
+  // The brand string is padded with spaces and NULs.
+  if (auto const nul = result.find ('\0'); nul != std::string::npos) {
+    result.erase (nul);
+  }
+  auto const first = result.find_first_not_of (' ');
+  auto const last = result.find_last_not_of (' ');
+  if (first == std::string::npos) {
+    return "unknown";
+  }
+  return result.substr (first, last - first + 1U);
+}
+
+}  // end namespace saturation
+
+#endif  // SATURATION_CPU_HPP
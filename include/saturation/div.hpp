@@ -1,17 +1,130 @@
 #ifndef SATURATION_DIV_HPP
 #define SATURATION_DIV_HPP
 
+#include <array>
 #include <cassert>
 
 #include "saturation/types.hpp"
 
 namespace saturation {
 
+namespace details {
+
+// Narrow division
+// ~~~~~~~~~~~~~~~
+// Integer division instructions have both a long latency and low throughput.
+// For narrow types there are cheaper ways to compute an exact quotient with a
+// variable divisor:
+//
+// - For N <= 8 a table holds ceil(2^16 / y) for each possible divisor. The
+//   quotient is then (x * table[y]) >> 16. This is exact because the error in
+//   the reciprocal is less than y and x < 2^8 (Granlund and Montgomery,
+//   theorem 4.2).
+// - For N <= 24 the arguments are converted to double and divided. If x / y
+//   is not an integer it differs from one by at least 1/y; this is more than
+//   the rounding error of a double division when x and y are less than 2^24,
+//   so truncating the result gives the exact quotient.
+//
+// Defining NO_NARROW_DIV disables these paths so that divu<>() and divs<>()
+// always use the integer division instruction.
+
+/// The largest value of N for which the reciprocal table is used.
+constexpr auto narrow_div_table_max = size_t{8};
+/// The largest value of N for which floating-point division is used.
+constexpr auto narrow_div_double_max = size_t{24};
+
+/// Builds the table of reciprocals used to divide values of no more than 8
+/// bits.
+constexpr std::array<uint32_t, 256> make_reciprocal_table () {
+  std::array<uint32_t, 256> result{};
+  for (auto y = uint32_t{1}; y < result.size (); ++y) {
+    result[y] = ((uint32_t{1} << 16U) + y - 1U) / y;
+  }
+  return result;
+}
+/// The table of reciprocals used to divide values of no more than 8 bits:
+/// entry y holds ceil(2^16 / y).
+inline constexpr std::array<uint32_t, 256> reciprocal_table =
+    make_reciprocal_table ();
+
+/// Computes the unsigned result of \p x / \p y using the integer division
+/// instruction.
+template <size_t N>
+constexpr uinteger_t<N> divu_hardware (uinteger_t<N> const x,
+                                       uinteger_t<N> const y) {
+  return x / y;
+}
+/// Computes the unsigned result of \p x / \p y using the reciprocal table.
+template <size_t N, typename = typename std::enable_if_t<(N <= 8)>>
+constexpr uinteger_t<N> divu_table (uinteger_t<N> const x,
+                                    uinteger_t<N> const y) {
+  return static_cast<uinteger_t<N>> ((x * reciprocal_table[y]) >> 16U);
+}
+/// Computes the unsigned result of \p x / \p y using floating-point
+/// division.
+template <size_t N, typename = typename std::enable_if_t<(N <= 24)>>
+constexpr uinteger_t<N> divu_double (uinteger_t<N> const x,
+                                     uinteger_t<N> const y) {
+  return static_cast<uinteger_t<N>> (static_cast<double> (x) /
+                                     static_cast<double> (y));
+}
+
+/// Computes the signed result of \p x / \p y using the integer division
+/// instruction.
+template <size_t N>
+constexpr sinteger_t<N> divs_hardware (sinteger_t<N> const x,
+                                       sinteger_t<N> const y) {
+  using uint = uinteger_t<N>;
+  using ubits = details::nbit_scalar<N, true>;
+  // x is incremented if y = -1 and x = min.
+  return (x + !(ubits{static_cast<uint> (y + 1)} |
+                ubits{static_cast<uint> (
+                    static_cast<uint> (x) +
+                    static_cast<uint> (slimits<N>::min ()))})) /
+         y;
+}
+/// Computes the signed result of \p x / \p y using the reciprocal table.
+template <size_t N, typename = typename std::enable_if_t<(N <= 8)>>
+constexpr sinteger_t<N> divs_table (sinteger_t<N> const x,
+                                    sinteger_t<N> const y) {
+  // Divide the magnitudes and then apply the sign. The only quotient which
+  // is out of range is min / -1 = max + 1.
+  auto const abs_x = static_cast<uint32_t> (x < 0 ? -x : x);
+  auto const abs_y = static_cast<uint32_t> (y < 0 ? -y : y);
+  auto const q = static_cast<int> ((abs_x * reciprocal_table[abs_y]) >> 16U);
+  auto const signed_q = (x < 0) != (y < 0) ? -q : q;
+  return static_cast<sinteger_t<N>> (
+      signed_q > slimits<N>::max () ? slimits<N>::max () : signed_q);
+}
+/// Computes the signed result of \p x / \p y using floating-point division.
+template <size_t N, typename = typename std::enable_if_t<(N <= 24)>>
+constexpr sinteger_t<N> divs_double (sinteger_t<N> const x,
+                                     sinteger_t<N> const y) {
+  // The conversion to integer truncates towards zero. The only quotient
+  // which is out of range is min / -1 = max + 1.
+  auto const q = static_cast<double> (x) / static_cast<double> (y);
+  constexpr auto max = static_cast<double> (slimits<N>::max ());
+  return static_cast<sinteger_t<N>> (q > max ? max : q);
+}
+
+}  // end namespace details
+
+/// Selects the behavior of division when the divisor is zero.
+enum class divide_by_zero {
+  /// Division by zero is undefined. This is the behavior of divu<N>() and
+  /// divs<N>() without a policy argument.
+  undefined,
+  /// Division by zero saturates: a positive dividend yields the maximum
+  /// value, a negative dividend the minimum value, and zero yields zero. The
+  /// result is computed without branching.
+  saturate,
+};
+
 // divu
 // ~~~~
 /// \name Unsigned Division
 /// Functions that perform saturating division of unsigned integral
-/// quantities from 4 to 64 bits.
+/// quantities from 4 to 64 bits (128 bits if HAVE_INT128 is enabled).
 /// @{
 
 /// \brief Computes the unsigned result of \p x / \p y.
@@ -20,15 +133,24 @@ namespace saturation {
 ///   symmetry and completeness.
 ///
 /// \tparam N The number of bits for the arguments and result. May be any
-///   in the range \f$ [4, 64] \f$.
+///   in the range \f$ [4, 64] \f$ (\f$ [4, 128] \f$ if HAVE_INT128 is
+///   enabled).
 /// \param x  The unsigned dividend.
 /// \param y  The unsigned divisor.
 /// \returns  \p x / \p y.
-template <size_t N, typename = typename std::enable_if_t<(N >= 4 && N <= 64)>>
+template <size_t N,
+          typename = typename std::enable_if_t<(N >= 4 && N <= max_width)>>
 constexpr uinteger_t<N> divu (uinteger_t<N> const x, uinteger_t<N> const y) {
   assert (x <= ulimits<N>::max ());  // divu<> x value out of range
   assert (y <= ulimits<N>::max ());  // divu<> y value out of range
-  return x / y;
+#ifndef NO_NARROW_DIV
+  if constexpr (N <= details::narrow_div_table_max) {
+    return details::divu_table<N> (x, y);
+  } else if constexpr (N <= details::narrow_div_double_max) {
+    return details::divu_double<N> (x, y);
+  }
+#endif  // NO_NARROW_DIV
+  return details::divu_hardware<N> (x, y);
 }
 /// \brief Computes the unsigned result of \p x / \p y.
 ///
@@ -63,13 +185,41 @@ constexpr uint16_t divu16 (uint16_t const x, uint16_t const y) {
 constexpr uint8_t divu8 (uint8_t const x, uint8_t const y) {
   return divu<8> (x, y);
 }
+/// \brief Computes the unsigned result of \p x / \p y with a policy for
+///   division by zero.
+///
+/// \tparam N The number of bits for the arguments and result. May be any
+///   in the range \f$ [4, 64] \f$ (\f$ [4, 128] \f$ if HAVE_INT128 is
+///   enabled).
+/// \tparam Policy  The behavior if \p y is zero.
+/// \param x  The unsigned dividend.
+/// \param y  The unsigned divisor.
+/// \returns  \p x / \p y. If \p Policy is divide_by_zero::saturate and \p y
+///   is zero, 0 if \p x is zero or \f$ 2^N-1 \f$
+///   (saturation::ulimits<N>::max()) otherwise.
+template <size_t N, divide_by_zero Policy,
+          typename = typename std::enable_if_t<(N >= 4 && N <= max_width)>>
+constexpr uinteger_t<N> divu (uinteger_t<N> const x, uinteger_t<N> const y) {
+  if constexpr (Policy == divide_by_zero::undefined) {
+    return divu<N> (x, y);
+  } else {
+    using uint = uinteger_t<N>;
+    // A zero divisor is replaced by 1 so that the quotient is x. ORing with
+    // max then gives max if x is non-zero.
+    auto const zero = static_cast<uint> (y == 0U);
+    auto const q = divu<N> (x, static_cast<uint> (y + zero));
+    auto const saturate =
+        static_cast<uint> (0U - static_cast<uint> (zero & (x != 0U)));
+    return static_cast<uint> (q | (saturate & ulimits<N>::max ()));
+  }
+}
 /// @}
 
 // divs
 // ~~~~
 /// \name Signed Division
 /// Functions that perform saturating division of signed integral
-/// quantities from 4 to 64 bits.
+/// quantities from 4 to 64 bits (128 bits if HAVE_INT128 is enabled).
 /// @{
 
 /// \brief Computes the signed result of \p x / \p y.
@@ -79,26 +229,29 @@ constexpr uint8_t divu8 (uint8_t const x, uint8_t const y) {
 ///   represented is \f$ 2^{N-1}-1 \f$.
 ///
 /// \tparam N The number of bits for the twos complement arguments and
-///   result. May be in the range \f$ [4, 64] \f$.
+///   result. May be in the range \f$ [4, 64] \f$ (\f$ [4, 128] \f$ if
+///   HAVE_INT128 is enabled).
 /// \param x  The signed dividend.
 /// \param y  The signed divisor.
 /// \returns  \p x / \p y. If the result would be too large and positive,
 ///   \f$ 2^{N-1}-1 \f$ (saturation::slimits<N>::max()); if the result
 ///   would be too large and negative, \f$ -2^{N-1} \f$
 ///   (saturation::slimits<N>::min()).
-template <size_t N, typename = typename std::enable_if_t<(N >= 4 && N <= 64)>>
+template <size_t N,
+          typename = typename std::enable_if_t<(N >= 4 && N <= max_width)>>
 constexpr sinteger_t<N> divs (sinteger_t<N> const x, sinteger_t<N> const y) {
   assert (x >= slimits<N>::min () &&
           x <= slimits<N>::max ());  // divs<> x value out of range
   assert (y >= slimits<N>::min () &&
           y <= slimits<N>::max ());  // divs<> y value out of range
-  using uint = uinteger_t<N>;
-  using ubits = details::nbit_scalar<N, true>;
-  return (x + !(ubits{static_cast<uint> (y + 1)} |
-                ubits{static_cast<uint> (
-                    static_cast<uint> (x) +
-                    static_cast<uint> (slimits<N>::min ()))})) /
-         y;
+#ifndef NO_NARROW_DIV
+  if constexpr (N <= details::narrow_div_table_max) {
+    return details::divs_table<N> (x, y);
+  } else if constexpr (N <= details::narrow_div_double_max) {
+    return details::divs_double<N> (x, y);
+  }
+#endif  // NO_NARROW_DIV
+  return details::divs_hardware<N> (x, y);
 }
 /// \brief Computes the 32 bit signed result of \p x / \p y.
 ///
@@ -142,6 +295,39 @@ constexpr int16_t divs16 (int16_t const x, int16_t const y) {
 constexpr int8_t divs8 (int8_t const x, int8_t const y) {
   return divs<8> (x, y);
 }
+/// \brief Computes the signed result of \p x / \p y with a policy for
+///   division by zero.
+///
+/// \tparam N The number of bits for the twos complement arguments and
+///   result. May be in the range \f$ [4, 64] \f$ (\f$ [4, 128] \f$ if
+///   HAVE_INT128 is enabled).
+/// \tparam Policy  The behavior if \p y is zero.
+/// \param x  The signed dividend.
+/// \param y  The signed divisor.
+/// \returns  As divs<N>(). If \p Policy is divide_by_zero::saturate and \p y
+///   is zero, \f$ 2^{N-1}-1 \f$ (saturation::slimits<N>::max()) if \p x is
+///   positive, \f$ -2^{N-1} \f$ (saturation::slimits<N>::min()) if \p x is
+///   negative, or 0 if \p x is zero.
+template <size_t N, divide_by_zero Policy,
+          typename = typename std::enable_if_t<(N >= 4 && N <= max_width)>>
+constexpr sinteger_t<N> divs (sinteger_t<N> const x, sinteger_t<N> const y) {
+  if constexpr (Policy == divide_by_zero::undefined) {
+    return divs<N> (x, y);
+  } else {
+    using sint = sinteger_t<N>;
+    using uint = uinteger_t<N>;
+    // A zero divisor is replaced by 1 and the quotient by the limit
+    // corresponding to the sign of x.
+    auto const zero = y == 0;
+    auto const q = divs<N> (x, static_cast<sint> (y + zero));
+    auto const limit = static_cast<uint> (
+        static_cast<uint> (x > 0) * static_cast<uint> (slimits<N>::max ()) +
+        static_cast<uint> (x < 0) * static_cast<uint> (slimits<N>::min ()));
+    auto const mask = static_cast<uint> (0U - static_cast<uint> (zero));
+    return static_cast<sint> (
+        (static_cast<uint> (q) & static_cast<uint> (~mask)) | (limit & mask));
+  }
+}
 /// @}
 
 }  // end namespace saturation
@@ -0,0 +1,247 @@
+/// \file div_round.hpp
+/// \brief Saturating division with a choice of rounding mode.
+///
+/// divu<N>() and divs<N>() truncate the quotient towards zero. The functions
+/// in this file instead round it as selected by a saturation::rounding
+/// value. The truncated quotient and its remainder are computed once and the
+/// quotient corrected by at most one without branching, so that (for
+/// example) rounding to nearest does not need a separate (and possibly
+/// overflowing) "x + y / 2" before the division.
+
+#ifndef SATURATION_DIV_ROUND_HPP
+#define SATURATION_DIV_ROUND_HPP
+
+#include <cassert>
+
+#include "saturation/div.hpp"
+#include "saturation/divider.hpp"
+#include "saturation/span.hpp"
+#include "saturation/types.hpp"
+
+namespace saturation {
+
+/// The rounding modes available to divu_round<>() and divs_round<>().
+enum class rounding {
+  /// Round towards zero (truncate). This is the behavior of divu<N>() and
+  /// divs<N>().
+  toward_zero,
+  /// Round towards negative infinity.
+  floor,
+  /// Round towards positive infinity.
+  ceil,
+  /// Round away from zero.
+  away_from_zero,
+  /// Round to the nearest integer with ties rounded away from zero.
+  nearest,
+};
+
+namespace details {
+
+/// Returns 1 if the magnitude of a truncated quotient must be increased by
+/// one to round it according to \p Mode or 0 otherwise.
+///
+/// \param r  The magnitude of the remainder.
+/// \param y  The magnitude of the divisor.
+/// \param negative  True if the exact quotient is negative.
+template <rounding Mode, typename T>
+constexpr T round_increment (T const r, T const y, bool const negative) {
+  static_assert (std::is_unsigned_v<T>);
+  if constexpr (Mode == rounding::toward_zero) {
+    (void)r;
+    (void)y;
+    (void)negative;
+    return T{0};
+  } else if constexpr (Mode == rounding::floor) {
+    (void)y;
+    return static_cast<T> (negative && r != 0U);
+  } else if constexpr (Mode == rounding::ceil) {
+    (void)y;
+    return static_cast<T> (!negative && r != 0U);
+  } else if constexpr (Mode == rounding::away_from_zero) {
+    (void)y;
+    (void)negative;
+    return static_cast<T> (r != 0U);
+  } else {
+    // r >= y / 2 without the loss of the low bit of y. r < y so y - r cannot
+    // wrap.
+    (void)negative;
+    return static_cast<T> (r >= y - r);
+  }
+}
+
+/// The unsigned type in which the remainder and rounding of \p N bit values
+/// are computed. This is at least as wide as unsigned int so that the
+/// products do not undergo promotion to a signed type.
+template <size_t N>
+using round_work_t = decltype (uinteger_t<N>{0} + 0U);
+
+/// Rounds the truncated unsigned quotient \p q of \p x / \p y.
+template <size_t N, rounding Mode>
+constexpr uinteger_t<N> round_quotient (uinteger_t<N> const x,
+                                        uinteger_t<N> const y,
+                                        uinteger_t<N> const q) {
+  using work = round_work_t<N>;
+  auto const r = static_cast<work> (work{x} - work{q} * work{y});
+  // An increment cannot overflow: if q is the maximum value then y is 1 and
+  // the remainder 0.
+  return static_cast<uinteger_t<N>> (
+      q + round_increment<Mode> (r, work{y}, false));
+}
+/// Rounds the truncated signed quotient \p q of \p x / \p y. The quotient
+/// may have been saturated (when \p x is min and \p y is -1).
+template <size_t N, rounding Mode>
+constexpr sinteger_t<N> round_quotient (sinteger_t<N> const x,
+                                        sinteger_t<N> const y,
+                                        sinteger_t<N> const q) {
+  using work = round_work_t<N>;
+  auto const ux = static_cast<work> (x);
+  auto const uy = static_cast<work> (y);
+  // The remainder has the sign of x. Division by -1 is always exact but the
+  // saturated quotient of min / -1 would give a remainder of -1, so it is
+  // forced to zero.
+  auto const r = static_cast<work> ((ux - static_cast<work> (q) * uy) *
+                                    static_cast<work> (y != -1));
+  // The magnitudes of the remainder and divisor. These are at most 2^(N-1)
+  // and so representable in work.
+  auto const x_sign = static_cast<work> (0U - static_cast<work> (x < 0));
+  auto const y_sign = static_cast<work> (0U - static_cast<work> (y < 0));
+  auto const abs_r = static_cast<work> ((r ^ x_sign) - x_sign);
+  auto const abs_y = static_cast<work> ((uy ^ y_sign) - y_sign);
+  // The increment is applied in the direction of the exact quotient. It
+  // cannot overflow: |q| only reaches the limits when the remainder is 0.
+  auto const sign = x_sign ^ y_sign;
+  auto const increment =
+      round_increment<Mode> (abs_r, abs_y, static_cast<bool> (sign & 1U));
+  return static_cast<sinteger_t<N>> (static_cast<work> (
+      static_cast<work> (q) + ((increment ^ sign) - sign)));
+}
+
+}  // end namespace details
+
+/// \name Division with Rounding
+/// Functions that perform saturating division of integral quantities from 4
+/// to 64 bits, rounding the quotient according to a saturation::rounding
+/// mode.
+/// @{
+
+/// \brief Computes the unsigned result of \p x / \p y rounded according to
+///   \p Mode.
+///
+/// \tparam N The number of bits for the arguments and result. May be any
+///   in the range \f$ [4, 64] \f$.
+/// \tparam Mode  The rounding mode. Since the quotient is not negative,
+///   rounding::floor is equivalent to rounding::toward_zero and
+///   rounding::ceil to rounding::away_from_zero.
+/// \param x  The unsigned dividend.
+/// \param y  The unsigned divisor. Must not be 0.
+/// \returns  \p x / \p y rounded according to \p Mode.
+template <size_t N, rounding Mode,
+          typename = typename std::enable_if_t<(N >= 4 && N <= 64)>>
+constexpr uinteger_t<N> divu_round (uinteger_t<N> const x,
+                                    uinteger_t<N> const y) {
+  return details::round_quotient<N, Mode> (x, y, divu<N> (x, y));
+}
+/// \brief Computes the signed result of \p x / \p y rounded according to
+///   \p Mode.
+///
+/// \tparam N The number of bits for the twos complement arguments and
+///   result. May be in the range \f$ [4, 64] \f$.
+/// \tparam Mode  The rounding mode.
+/// \param x  The signed dividend.
+/// \param y  The signed divisor. Must not be 0.
+/// \returns  \p x / \p y rounded according to \p Mode. If the result would be
+///   too large and positive (that is, \p x is saturation::slimits<N>::min()
+///   and \p y is -1), saturation::slimits<N>::max().
+template <size_t N, rounding Mode,
+          typename = typename std::enable_if_t<(N >= 4 && N <= 64)>>
+constexpr sinteger_t<N> divs_round (sinteger_t<N> const x,
+                                    sinteger_t<N> const y) {
+  return details::round_quotient<N, Mode> (x, y, divs<N> (x, y));
+}
+
+/// \brief Computes the unsigned result of \p x / \p d rounded according to
+///   \p Mode.
+///
+/// \param x  The unsigned dividend.
+/// \param d  A divider holding the unsigned divisor.
+/// \returns  The same value as saturation::divu_round<N, Mode>(x,
+///   d.divisor()).
+template <size_t N, rounding Mode>
+constexpr uinteger_t<N> divu_round (uinteger_t<N> const x,
+                                    divider<N, false> const& d) {
+  return details::round_quotient<N, Mode> (x, d.divisor (), d (x));
+}
+/// \brief Computes the signed result of \p x / \p d rounded according to
+///   \p Mode.
+///
+/// \param x  The signed dividend.
+/// \param d  A divider holding the signed divisor.
+/// \returns  The same value as saturation::divs_round<N, Mode>(x,
+///   d.divisor()).
+template <size_t N, rounding Mode>
+constexpr sinteger_t<N> divs_round (sinteger_t<N> const x,
+                                    divider<N, true> const& d) {
+  return details::round_quotient<N, Mode> (x, d.divisor (), d (x));
+}
+/// @}
+
+namespace batch {
+
+/// \name Batch Division with Rounding by an Invariant Divisor
+/// @{
+
+/// \brief Divides an array of unsigned values each \p N bits wide by a
+///   single divisor and rounds the quotients.
+///
+/// For each i, sets out[i] to saturation::divu_round<N, Mode>(x[i],
+/// d.divisor()). The loop is free of branches and division instructions so
+/// that the compiler is able to vectorize it.
+///
+/// \param x  The dividends.
+/// \param d  A divider holding the unsigned divisor.
+/// \param out  The array to which the results are written. May be the same
+///   as \p x.
+template <size_t N, rounding Mode>
+void divu_round (span<uinteger_t<N> const> const x, divider<N, false> const& d,
+                 span<uinteger_t<N>> const out) {
+  assert (x.size () == out.size ());  // batch x and out sizes must match
+  auto const* const src = x.data ();
+  auto* const dest = out.data ();
+  auto const divide = d;
+  auto const divisor = d.divisor ();
+  for (auto ctr = size_t{0}, size = out.size (); ctr < size; ++ctr) {
+    dest[ctr] = details::round_quotient<N, Mode> (src[ctr], divisor,
+                                                  divide (src[ctr]));
+  }
+}
+/// \brief Divides an array of signed values each \p N bits wide by a single
+///   divisor and rounds the quotients.
+///
+/// For each i, sets out[i] to saturation::divs_round<N, Mode>(x[i],
+/// d.divisor()). The loop is free of branches and division instructions so
+/// that the compiler is able to vectorize it.
+///
+/// \param x  The dividends.
+/// \param d  A divider holding the signed divisor.
+/// \param out  The array to which the results are written. May be the same
+///   as \p x.
+template <size_t N, rounding Mode>
+void divs_round (span<sinteger_t<N> const> const x, divider<N, true> const& d,
+                 span<sinteger_t<N>> const out) {
+  assert (x.size () == out.size ());  // batch x and out sizes must match
+  auto const* const src = x.data ();
+  auto* const dest = out.data ();
+  auto const divide = d;
+  auto const divisor = d.divisor ();
+  for (auto ctr = size_t{0}, size = out.size (); ctr < size; ++ctr) {
+    dest[ctr] = details::round_quotient<N, Mode> (src[ctr], divisor,
+                                                  divide (src[ctr]));
+  }
+}
+/// @}
+
+}  // end namespace batch
+
+}  // end namespace saturation
+
+#endif  // SATURATION_DIV_ROUND_HPP
@@ -0,0 +1,481 @@
+/// \file divider.hpp
+/// \brief Saturating division by a divisor which is fixed at run time.
+///
+/// Integer division instructions are slow (tens of cycles for 64 bit
+/// operands). When the same divisor is used repeatedly, a divider object
+/// computes a "magic" multiplier and shift once so that each subsequent
+/// division is reduced to a multiply-high, an add, and shifts. (See Granlund
+/// and Montgomery, "Division by Invariant Integers using Multiplication", and
+/// Warren, "Hacker's Delight", chapter 10.)
+
+#ifndef SATURATION_DIVIDER_HPP
+#define SATURATION_DIVIDER_HPP
+
+#include <cassert>
+#include <climits>
+#include <utility>
+
+#include "saturation/mul.hpp"
+#include "saturation/span.hpp"
+#include "saturation/types.hpp"
+
+namespace saturation {
+
+namespace details {
+
+/// Returns the high-order half of the double-width product of \p u and \p v.
+///
+/// \tparam T  A standard integer type.
+template <typename T>
+constexpr T multiply_high (T const u, T const v) {
+  constexpr auto bits = sizeof (T) * CHAR_BIT;
+  if constexpr (bits <= 32) {
+    using wide_type =
+        std::conditional_t<std::is_unsigned_v<T>, uinteger_t<bits * 2>,
+                           sinteger_t<bits * 2>>;
+    return static_cast<T> ((wide_type{u} * wide_type{v}) >> bits);
+#if HAVE_INT128
+  } else if constexpr (bits == 64) {
+    using wide_type = std::conditional_t<std::is_unsigned_v<T>,
+                                         uinteger_t<128>, sinteger_t<128>>;
+    return static_cast<T> ((wide_type{u} * wide_type{v}) >> bits);
+#endif  // HAVE_INT128
+  } else {
+    return multiply (u, v).first;
+  }
+}
+
+/// Computes \f$ \lfloor (r \times 2^W + lo) / d \rfloor \f$ and the
+/// corresponding remainder where W is the number of bits in \p T. The
+/// division is performed one bit at a time so that no double-width type is
+/// required.
+///
+/// \tparam T  An unsigned standard integer type.
+/// \param r  The high-order half of the dividend. Must be less than \p d so
+///   that the quotient fits in \p T.
+/// \param d  The divisor.
+/// \param lo  The low-order half of the dividend.
+/// \returns  A pair consisting of the quotient and remainder respectively.
+template <typename T,
+          typename = typename std::enable_if_t<std::is_unsigned_v<T>>>
+constexpr std::pair<T, T> divide_wide (T r, T const d, T lo = 0U) {
+  assert (r < d);
+  constexpr auto bits = sizeof (T) * CHAR_BIT;
+  auto q = T{0};
+  for (auto ctr = size_t{0}; ctr < bits; ++ctr) {
+    bool const carry = (r >> (bits - 1U)) != 0U;
+    r = static_cast<T> ((r << 1U) | (lo >> (bits - 1U)));
+    lo = static_cast<T> (lo << 1U);
+    q = static_cast<T> (q << 1U);
+    if (carry || r >= d) {
+      r = static_cast<T> (r - d);
+      q |= 1U;
+    }
+  }
+  return std::make_pair (q, r);
+}
+
+/// Returns \f$ \lceil \log_2 d \rceil \f$.
+///
+/// \tparam T  An unsigned standard integer type.
+/// \param d  A value which must be greater than 0.
+template <typename T,
+          typename = typename std::enable_if_t<std::is_unsigned_v<T>>>
+constexpr unsigned ceil_log2 (T const d) {
+  assert (d > 0U);
+  auto result = 0U;
+  while (result < sizeof (T) * CHAR_BIT &&
+         static_cast<T> (d - 1U) >> result != 0U) {
+    ++result;
+  }
+  return result;
+}
+
+}  // end namespace details
+
+/// \brief Divides by a value which is fixed when the divider is constructed.
+///
+/// Constructing a divider performs the (relatively) expensive computation of
+/// a multiplier and shift amounts. Each subsequent division then requires
+/// only multiplication and shifts and produces exactly the same result as
+/// saturation::divu<N>() or saturation::divs<N>().
+///
+/// \tparam N  The number of bits for the arguments and results. May be in the
+///   range \f$ [4, 64] \f$.
+/// \tparam IsSigned  True if the divider operates on signed values; false
+///   otherwise.
+template <size_t N, bool IsSigned,
+          typename = typename std::enable_if_t<(N >= 4 && N <= 64)>>
+class divider;
+
+/// \brief Divides unsigned values by a value which is fixed when the divider
+///   is constructed.
+template <size_t N>
+class divider<N, false> {
+public:
+  /// The type of the dividend, divisor, and result.
+  using type = uinteger_t<N>;
+
+  /// \param d  The unsigned divisor. Must not be 0.
+  explicit constexpr divider (type const d) : d_{d} {
+    assert (d > 0U);                    // divider<> divisor must not be zero
+    assert (d <= ulimits<N>::max ());  // divider<> divisor out of range
+    // With l = ceil(log2(d)):
+    //   m = floor(2^W * (2^l - d) / d) + 1
+    //   q = (((x - mulhi(m, x)) >> min(l, 1)) + mulhi(m, x)) >> max(l - 1, 0)
+    auto const l = details::ceil_log2 (d);
+    auto const pow2 = l == bits ? type{0} : static_cast<type> (type{1} << l);
+    multiplier_ = static_cast<type> (
+        details::divide_wide (static_cast<type> (pow2 - d), d).first + 1U);
+    shift1_ = l > 0U ? 1U : 0U;
+    shift2_ = l > 0U ? l - 1U : 0U;
+  }
+
+  /// Returns the divisor.
+  constexpr type divisor () const noexcept { return d_; }
+
+  /// \brief Computes the unsigned result of \p x divided by the divisor.
+  ///
+  /// \param x  The unsigned dividend.
+  /// \returns  The same value as saturation::divu<N>(x, divisor()).
+  constexpr type operator() (type const x) const {
+    assert (x <= ulimits<N>::max ());  // divider<> x value out of range
+    auto const q = details::multiply_high (multiplier_, x);
+    auto const t =
+        static_cast<type> ((static_cast<type> (x - q) >> shift1_) + q);
+    return static_cast<type> (t >> shift2_);
+  }
+
+private:
+  static constexpr auto bits = unsigned{sizeof (type) * CHAR_BIT};
+  type d_;
+  type multiplier_ = 0;
+  unsigned shift1_ = 0;
+  unsigned shift2_ = 0;
+};
+
+/// \brief Divides signed values by a value which is fixed when the divider is
+///   constructed.
+template <size_t N>
+class divider<N, true> {
+public:
+  /// The type of the dividend, divisor, and result.
+  using type = sinteger_t<N>;
+
+  /// \param d  The signed divisor. Must not be 0.
+  explicit constexpr divider (type const d) : d_{d} {
+    assert (d != 0);  // divider<> divisor must not be zero
+    assert (d >= slimits<N>::min () &&
+            d <= slimits<N>::max ());  // divider<> divisor out of range
+    auto const ud = static_cast<utype> (d);
+    auto const abs_d = d < 0 ? static_cast<utype> (0U - ud) : ud;
+    sign_ = d < 0 ? static_cast<utype> (~utype{0}) : utype{0};
+    negative_one_ = d == -1;
+    if (abs_d == 1U) {
+      // x / 1 and x / -1 need no multiplication. The rounding correction must
+      // also be suppressed.
+      round_ = 0U;
+      return;
+    }
+    // With l = ceil(log2(|d|)):
+    //   m = floor(2^(W+l-1) / |d|) + 1 - 2^W
+    //   q = mulhi(m, x) + x
+    //   q = (q >> (l - 1)) + (q < 0)
+    // and the quotient is negated if d is negative.
+    auto const l = details::ceil_log2 (abs_d);
+    multiplier_ = static_cast<utype> (
+        details::divide_wide (static_cast<utype> (utype{1} << (l - 1U)), abs_d)
+            .first +
+        1U);
+    shift_ = l - 1U;
+    round_ = 1U;
+  }
+
+  /// Returns the divisor.
+  constexpr type divisor () const noexcept { return d_; }
+
+  /// \brief Computes the signed result of \p x divided by the divisor.
+  ///
+  /// \param x  The signed dividend.
+  /// \returns  The same value as saturation::divs<N>(x, divisor()). If the
+  ///   result would be too large and positive (that is, x is
+  ///   saturation::slimits<N>::min() and the divisor is -1),
+  ///   saturation::slimits<N>::max().
+  constexpr type operator() (type const x) const {
+    assert (x >= slimits<N>::min () &&
+            x <= slimits<N>::max ());  // divider<> x value out of range
+    // As divs<>, -2^(N-1) / -1 is computed as (-2^(N-1) + 1) / -1.
+    auto const ux = static_cast<utype> (
+        static_cast<utype> (x) +
+        static_cast<utype> (negative_one_ && x == slimits<N>::min ()));
+    auto q = static_cast<utype> (
+        static_cast<utype> (details::multiply_high (
+            static_cast<type> (multiplier_), static_cast<type> (ux))) +
+        ux);
+    q = static_cast<utype> (static_cast<type> (q) >> shift_);
+    q = static_cast<utype> (q + ((q >> (bits - 1U)) & round_));
+    return static_cast<type> (static_cast<utype> ((q ^ sign_) - sign_));
+  }
+
+private:
+  using utype = std::make_unsigned_t<type>;
+  static constexpr auto bits = unsigned{sizeof (type) * CHAR_BIT};
+  type d_;
+  utype multiplier_ = 0;
+  unsigned shift_ = 0;
+  utype round_ = 0;
+  utype sign_ = 0;
+  bool negative_one_ = false;
+};
+
+/// \brief Computes the unsigned result of \p x / \p d.
+///
+/// \param x  The unsigned dividend.
+/// \param d  A divider holding the unsigned divisor.
+/// \returns  The same value as saturation::divu<N>(x, d.divisor()).
+template <size_t N>
+constexpr uinteger_t<N> divu (uinteger_t<N> const x,
+                              divider<N, false> const& d) {
+  return d (x);
+}
+/// \brief Computes the signed result of \p x / \p d.
+///
+/// \param x  The signed dividend.
+/// \param d  A divider holding the signed divisor.
+/// \returns  The same value as saturation::divs<N>(x, d.divisor()).
+template <size_t N>
+constexpr sinteger_t<N> divs (sinteger_t<N> const x,
+                              divider<N, true> const& d) {
+  return d (x);
+}
+
+namespace details {
+
+/// Describes the multiplication which replaces division by a constant.
+struct constant_magic {
+  uint64_t multiplier;  ///< The multiplier, m.
+  unsigned shift;       ///< The shift, p: the quotient is floor(x m / 2^p).
+  bool valid;           ///< False if m does not fit in 64 bits.
+};
+
+/// Finds the smallest p no less than \p precision for which
+/// \f$ m = \lceil 2^p / d \rceil \f$ satisfies
+/// \f$ \lfloor x m / 2^p \rfloor = \lfloor x / d \rfloor \f$ for every x
+/// less than \f$ 2^{precision} \f$. This holds if
+/// \f$ m d - 2^p \le 2^{p - precision} \f$ (Granlund and Montgomery, theorem
+/// 4.2).
+///
+/// \param d  The divisor. Must not be a power of 2.
+/// \param precision  The number of bits in the dividend.
+constexpr constant_magic find_constant_magic (uint64_t const d,
+                                              unsigned const precision) {
+  auto const l = ceil_log2 (d);
+  for (auto p = precision; p <= precision + l; ++p) {
+    if (p >= 64U && p - 64U >= l) {
+      break;  // The multiplier would need more than 64 bits.
+    }
+    auto const hi = p >= 64U ? uint64_t{1} << (p - 64U) : uint64_t{0};
+    auto const lo = p >= 64U ? uint64_t{0} : uint64_t{1} << p;
+    auto const [q, r] = divide_wide (hi, d, lo);
+    if (r != 0U && q == ~uint64_t{0}) {
+      break;
+    }
+    auto const m = q + (r != 0U ? 1U : 0U);
+    auto const error = r != 0U ? d - r : uint64_t{0};
+    if (p - precision >= 64U || error <= uint64_t{1} << (p - precision)) {
+      return {m, p, true};
+    }
+  }
+  return {0U, 0U, false};
+}
+
+/// Returns the number of trailing zero bits in \p x, which must not be 0.
+constexpr unsigned trailing_zeros (uint64_t const x) {
+  assert (x != 0U);
+  auto result = 0U;
+  while ((x >> result & 1U) == 0U) {
+    ++result;
+  }
+  return result;
+}
+
+/// Computes \p x / \p D where \p x has no more than \p Precision significant
+/// bits and \p D is a constant which is not a power of 2.
+template <unsigned Precision, uint64_t D>
+constexpr uint64_t divide_by_constant (uint64_t const x) {
+  constexpr auto magic = find_constant_magic (D, Precision);
+  if constexpr (!magic.valid) {
+    if constexpr (D % 2U == 0U) {
+      // Shifting out the factors of 2 from both dividend and divisor reduces
+      // the precision required of the multiplier.
+      constexpr auto k = trailing_zeros (D);
+      return divide_by_constant<Precision - k, (D >> k)> (x >> k);
+    } else {
+      constexpr divider<64, false> divide{D};
+      return divide (x);
+    }
+  } else if constexpr (Precision < 64U && magic.shift < 64U &&
+                       magic.multiplier <=
+                           ~uint64_t{0} >> (Precision % 64U)) {
+    // The full product fits in 64 bits.
+    return x * magic.multiplier >> magic.shift;
+  } else if constexpr (magic.shift >= 64U) {
+    return multiply_high (x, magic.multiplier) >> (magic.shift - 64U);
+  } else {
+    return multiply_high (x, magic.multiplier << (64U - magic.shift));
+  }
+}
+
+/// Computes \p x / \p D rounded towards zero where \p x has no more than
+/// \p Precision significant bits (excluding the sign) and \p D is a positive
+/// constant which is not a power of 2.
+template <unsigned Precision, uint64_t D>
+constexpr int64_t divide_by_constant (int64_t const x) {
+  constexpr auto magic = find_constant_magic (D, Precision);
+  static_assert (magic.valid);
+  // The arithmetic shift rounds towards negative infinity; subtracting the
+  // sign of x (-1 or 0) corrects this for negative dividends.
+  auto const sign = x >> 63U;
+  if constexpr (magic.multiplier <= uint64_t{1} << (63U - Precision)) {
+    // The full product fits in 64 bits.
+    return (x * static_cast<int64_t> (magic.multiplier) >> magic.shift) - sign;
+  } else if constexpr (magic.multiplier < uint64_t{1} << 63U) {
+    constexpr auto m = static_cast<int64_t> (
+        magic.shift >= 64U ? magic.multiplier
+                           : magic.multiplier << (64U - magic.shift));
+    constexpr auto post_shift = magic.shift >= 64U ? magic.shift - 64U : 0U;
+    return (multiply_high (x, m) >> post_shift) - sign;
+  } else {
+    constexpr divider<64, true> divide{static_cast<int64_t> (D)};
+    return divide (x);
+  }
+}
+
+}  // end namespace details
+
+/// \brief Computes the unsigned result of \p x / \p D where \p D is a
+///   constant.
+///
+/// Division by a constant is replaced by multiplication and shifts which are
+/// chosen at compile time.
+///
+/// \tparam N The number of bits for the argument and result. May be any
+///   in the range \f$ [4, 64] \f$.
+/// \tparam D  The unsigned divisor. Must not be 0.
+/// \param x  The unsigned dividend.
+/// \returns  \p x / \p D.
+template <size_t N, uinteger_t<N> D,
+          typename = typename std::enable_if_t<(N >= 4 && N <= 64)>>
+constexpr uinteger_t<N> divu (uinteger_t<N> const x) {
+  static_assert (D != 0U, "divu<> divisor must not be zero");
+  static_assert (D <= ulimits<N>::max (), "divu<> divisor out of range");
+  assert (x <= ulimits<N>::max ());  // divu<> x value out of range
+  if constexpr ((D & (D - 1U)) == 0U) {
+    return static_cast<uinteger_t<N>> (x >> details::ceil_log2 (D));
+  } else {
+    return static_cast<uinteger_t<N>> (
+        details::divide_by_constant<N, D> (uint64_t{x}));
+  }
+}
+/// \brief Computes the signed result of \p x / \p D where \p D is a
+///   constant.
+///
+/// Division by a constant is replaced by multiplication and shifts which are
+/// chosen at compile time. Only division by -1 can overflow and it is only
+/// in that case that the check for saturation is made.
+///
+/// \tparam N The number of bits for the twos complement argument and result.
+///   May be in the range \f$ [4, 64] \f$.
+/// \tparam D  The signed divisor. Must not be 0.
+/// \param x  The signed dividend.
+/// \returns  \p x / \p D. If the result would be too large and positive
+///   (that is, \p x is \f$ -2^{N-1} \f$ and \p D is -1),
+///   \f$ 2^{N-1}-1 \f$ (saturation::slimits<N>::max()).
+template <size_t N, sinteger_t<N> D,
+          typename = typename std::enable_if_t<(N >= 4 && N <= 64)>>
+constexpr sinteger_t<N> divs (sinteger_t<N> const x) {
+  static_assert (D != 0, "divs<> divisor must not be zero");
+  static_assert (D >= slimits<N>::min () && D <= slimits<N>::max (),
+                 "divs<> divisor out of range");
+  assert (x >= slimits<N>::min () &&
+          x <= slimits<N>::max ());  // divs<> x value out of range
+  using sint = sinteger_t<N>;
+  if constexpr (D == 1) {
+    return x;
+  } else if constexpr (D == -1) {
+    return x == slimits<N>::min () ? slimits<N>::max ()
+                                   : static_cast<sint> (-x);
+  } else {
+    constexpr auto abs_d = D < 0 ? uint64_t{0} - static_cast<uint64_t> (D)
+                                 : static_cast<uint64_t> (D);
+    auto q = int64_t{0};
+    if constexpr ((abs_d & (abs_d - 1U)) == 0U) {
+      // Negative dividends are biased by |D|-1 so that the arithmetic shift
+      // rounds towards zero.
+      constexpr auto k = details::ceil_log2 (abs_d);
+      auto const bias = static_cast<int64_t> (
+          static_cast<uint64_t> (int64_t{x} >> 63U) >> (64U - k));
+      q = (int64_t{x} + bias) >> k;
+    } else {
+      q = details::divide_by_constant<N - 1U, abs_d> (int64_t{x});
+    }
+    return static_cast<sint> (D < 0 ? -q : q);
+  }
+}
+
+namespace batch {
+
+/// \name Batch Division by an Invariant Divisor
+/// @{
+
+/// \brief Divides an array of unsigned values each \p N bits wide by a
+///   single divisor.
+///
+/// For each i, sets out[i] to saturation::divu<N>(x[i], d.divisor()). The
+/// loop is free of branches and division instructions so that the compiler
+/// is able to vectorize it.
+///
+/// \param x  The dividends.
+/// \param d  A divider holding the unsigned divisor.
+/// \param out  The array to which the results are written. May be the same
+///   as \p x.
+template <size_t N>
+void divu (span<uinteger_t<N> const> const x, divider<N, false> const& d,
+           span<uinteger_t<N>> const out) {
+  assert (x.size () == out.size ());  // batch x and out sizes must match
+  auto const* const src = x.data ();
+  auto* const dest = out.data ();
+  auto const divide = d;
+  for (auto ctr = size_t{0}, size = out.size (); ctr < size; ++ctr) {
+    dest[ctr] = divide (src[ctr]);
+  }
+}
+/// \brief Divides an array of signed values each \p N bits wide by a single
+///   divisor.
+///
+/// For each i, sets out[i] to saturation::divs<N>(x[i], d.divisor()). The
+/// loop is free of branches and division instructions so that the compiler
+/// is able to vectorize it.
+///
+/// \param x  The dividends.
+/// \param d  A divider holding the signed divisor.
+/// \param out  The array to which the results are written. May be the same
+///   as \p x.
+template <size_t N>
+void divs (span<sinteger_t<N> const> const x, divider<N, true> const& d,
+           span<sinteger_t<N>> const out) {
+  assert (x.size () == out.size ());  // batch x and out sizes must match
+  auto const* const src = x.data ();
+  auto* const dest = out.data ();
+  auto const divide = d;
+  for (auto ctr = size_t{0}, size = out.size (); ctr < size; ++ctr) {
+    dest[ctr] = divide (src[ctr]);
+  }
+}
+/// @}
+
+}  // end namespace batch
+
+}  // end namespace saturation
+
+#endif  // SATURATION_DIVIDER_HPP
@@ -0,0 +1,289 @@
+/// \file expr.hpp
+/// \brief Expression templates which fuse chains of saturating elementwise
+/// operations on arrays into a single pass.
+///
+/// Writing a gain-and-mix step with the batch functions:
+///
+///     batch::muls<16> (a, gain, tmp);
+///     batch::adds<16> (tmp, b, out);
+///
+/// reads and writes an intermediate array for each step. With the types in
+/// this file the same computation is described by an expression:
+///
+///     expr::assign (out, expr::input<16> (a) * gain + expr::input<16> (b));
+///
+/// which is evaluated lazily: assign() makes one pass over the arrays, a
+/// block of elements at a time. Each operation in the expression is applied
+/// to the block by the same (SIMD where available) kernel as the
+/// corresponding batch function, so the results are identical to calling the
+/// scalar functions (here muls<16>() then adds<16>()) for each element. The
+/// intermediate blocks are small enough to remain in the L1 cache: only the
+/// input arrays and the output are streamed through memory.
+
+#ifndef SATURATION_EXPR_HPP
+#define SATURATION_EXPR_HPP
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#include "saturation/batch.hpp"
+#include "saturation/span.hpp"
+#include "saturation/types.hpp"
+
+namespace saturation {
+
+namespace expr {
+
+/// The size reported by an expression with no intrinsic size (a constant).
+constexpr auto any_size = std::numeric_limits<size_t>::max ();
+/// The number of elements evaluated at a time.
+constexpr auto block_size = size_t{256};
+
+/// \brief An expression leaf which reads the elements of an array.
+///
+/// \tparam N  The number of bits in each element.
+/// \tparam IsSigned  True if the elements are signed; false otherwise.
+template <size_t N, bool IsSigned>
+class array {
+public:
+  using value_type = std::conditional_t<IsSigned, sinteger_t<N>, uinteger_t<N>>;
+  static constexpr auto bits = N;
+  static constexpr auto is_signed = IsSigned;
+
+  explicit constexpr array (span<value_type const> const values) noexcept
+      : values_{values} {}
+
+  constexpr size_t size () const noexcept { return values_.size (); }
+  /// Returns a pointer to the \p n elements starting at \p first.
+  value_type const* block (size_t const first, size_t,
+                           value_type*) const noexcept {
+    return values_.data () + first;
+  }
+
+private:
+  span<value_type const> values_;
+};
+
+/// \brief An expression leaf which has the same value for every element.
+///
+/// \tparam N  The number of bits in the value.
+/// \tparam IsSigned  True if the value is signed; false otherwise.
+template <size_t N, bool IsSigned>
+class constant {
+public:
+  using value_type = std::conditional_t<IsSigned, sinteger_t<N>, uinteger_t<N>>;
+  static constexpr auto bits = N;
+  static constexpr auto is_signed = IsSigned;
+
+  explicit constexpr constant (value_type const v) noexcept : v_{v} {}
+
+  constexpr size_t size () const noexcept { return any_size; }
+  /// Fills \p n elements of \p scratch with the value and returns it.
+  value_type const* block (size_t, size_t const n,
+                           value_type* const scratch) const noexcept {
+    std::fill_n (scratch, n, v_);
+    return scratch;
+  }
+
+private:
+  value_type v_;
+};
+
+/// \brief An expression node which applies the saturating operation \p Op
+/// to the corresponding elements of the expressions \p Lhs and \p Rhs.
+template <details::batch_op Op, typename Lhs, typename Rhs>
+class binary {
+public:
+  static_assert (Lhs::bits == Rhs::bits,
+                 "operands of an expression must have the same width");
+  static_assert (Lhs::is_signed == Rhs::is_signed,
+                 "operands of an expression must have the same signedness");
+  using value_type = typename Lhs::value_type;
+  static constexpr auto bits = Lhs::bits;
+  static constexpr auto is_signed = Lhs::is_signed;
+
+  constexpr binary (Lhs const& lhs, Rhs const& rhs) noexcept
+      : lhs_{lhs}, rhs_{rhs} {
+    assert (lhs.size () == rhs.size () || lhs.size () == any_size ||
+            rhs.size () == any_size);  // expression sizes must match
+  }
+
+  constexpr size_t size () const noexcept {
+    return lhs_.size () == any_size ? rhs_.size () : lhs_.size ();
+  }
+  /// Evaluates the \p n elements starting at \p first, writing them to
+  /// \p scratch, and returns a pointer to them. \p scratch may be the
+  /// corresponding elements of an array read by the expression.
+  value_type const* block (size_t const first, size_t const n,
+                           value_type* const scratch) const {
+    assert (n <= block_size);  // expression block too large
+    std::array<value_type, block_size> lbuffer;
+    std::array<value_type, block_size> rbuffer;
+    auto const* const l = lhs_.block (first, n, lbuffer.data ());
+    auto const* const r = rhs_.block (first, n, rbuffer.data ());
+    details::dispatch<Op, bits>::get () (l, r, scratch, n);
+    return scratch;
+  }
+
+private:
+  // The leaves are small (a span or a value) so the whole expression is held
+  // by value.
+  Lhs lhs_;
+  Rhs rhs_;
+};
+
+}  // end namespace expr
+
+namespace details {
+
+/// True if \p T is one of the expression types.
+template <typename T>
+struct is_expression : std::false_type {};
+template <size_t N, bool IsSigned>
+struct is_expression<expr::array<N, IsSigned>> : std::true_type {};
+template <size_t N, bool IsSigned>
+struct is_expression<expr::constant<N, IsSigned>> : std::true_type {};
+template <batch_op Op, typename Lhs, typename Rhs>
+struct is_expression<expr::binary<Op, Lhs, Rhs>> : std::true_type {};
+template <typename T>
+inline constexpr bool is_expression_v = is_expression<T>::value;
+
+/// Returns the integer \p v clamped to the range of the values of the
+/// expression \p Other so that an out-of-range constant saturates rather
+/// than wrapping.
+template <typename Other, typename T>
+constexpr typename Other::value_type saturate_constant (T const v) noexcept {
+  using value_type = typename Other::value_type;
+  constexpr auto bits = Other::bits;
+  if constexpr (std::is_signed_v<T>) {
+    if (v < 0) {
+      if constexpr (Other::is_signed) {
+        constexpr auto min = slimits<bits>::min ();
+        return static_cast<intmax_t> (v) < static_cast<intmax_t> (min)
+                   ? min
+                   : static_cast<value_type> (v);
+      } else {
+        return value_type{0};
+      }
+    }
+  }
+  constexpr auto max = Other::is_signed
+                           ? static_cast<uintmax_t> (slimits<bits>::max ())
+                           : static_cast<uintmax_t> (ulimits<bits>::max ());
+  return static_cast<uintmax_t> (v) > max ? static_cast<value_type> (max)
+                                          : static_cast<value_type> (v);
+}
+
+/// Converts an expression to itself and a value to a constant<> matching
+/// the expression \p Other.
+template <typename Other, typename T>
+constexpr auto expr_operand (T const& v) noexcept {
+  if constexpr (is_expression_v<T>) {
+    return v;
+  } else {
+    return expr::constant<Other::bits, Other::is_signed>{
+        saturate_constant<Other> (v)};
+  }
+}
+
+/// Builds the node for \p SignedOp or \p UnsignedOp (according to the
+/// signedness of the operands) from \p lhs and \p rhs, at least one of which
+/// must be an expression.
+template <batch_op UnsignedOp, batch_op SignedOp, typename Lhs, typename Rhs>
+constexpr auto make_expr_binary (Lhs const& lhs, Rhs const& rhs) noexcept {
+  using expression = std::conditional_t<is_expression_v<Lhs>, Lhs, Rhs>;
+  auto const l = expr_operand<expression> (lhs);
+  auto const r = expr_operand<expression> (rhs);
+  constexpr auto op = expression::is_signed ? SignedOp : UnsignedOp;
+  return expr::binary<op, std::remove_const_t<decltype (l)>,
+                      std::remove_const_t<decltype (r)>>{l, r};
+}
+
+/// Enables the operators if at least one of \p Lhs and \p Rhs is an
+/// expression and the other is either an expression or an integer.
+template <typename Lhs, typename Rhs>
+using enable_expr_operator_t = std::enable_if_t<
+    (is_expression_v<Lhs> &&
+     (is_expression_v<Rhs> || std::is_integral_v<Rhs>)) ||
+    (std::is_integral_v<Lhs> && is_expression_v<Rhs>)>;
+
+}  // end namespace details
+
+namespace expr {
+
+/// \name Expression Construction
+/// Functions that create the leaves of an expression from arrays and combine
+/// expressions with saturating operators. Either operand of +, -, or * may be
+/// an integer, which is treated as a constant of the same width and
+/// signedness as the other operand. A constant outside the range of that
+/// type is saturated to it.
+/// @{
+
+/// Returns an expression leaf which reads the signed \p N bit values in
+/// \p values.
+template <size_t N, typename = typename std::enable_if_t<(N >= 4 && N <= 64)>>
+constexpr array<N, true> input (span<sinteger_t<N> const> const values) {
+  return array<N, true>{values};
+}
+/// Returns an expression leaf which reads the unsigned \p N bit values in
+/// \p values.
+template <size_t N, typename = typename std::enable_if_t<(N >= 4 && N <= 64)>>
+constexpr array<N, false> input (span<uinteger_t<N> const> const values) {
+  return array<N, false>{values};
+}
+
+template <typename Lhs, typename Rhs,
+          typename = details::enable_expr_operator_t<Lhs, Rhs>>
+constexpr auto operator+ (Lhs const& lhs, Rhs const& rhs) noexcept {
+  return details::make_expr_binary<details::batch_op::addu,
+                                   details::batch_op::adds> (lhs, rhs);
+}
+template <typename Lhs, typename Rhs,
+          typename = details::enable_expr_operator_t<Lhs, Rhs>>
+constexpr auto operator- (Lhs const& lhs, Rhs const& rhs) noexcept {
+  return details::make_expr_binary<details::batch_op::subu,
+                                   details::batch_op::subs> (lhs, rhs);
+}
+template <typename Lhs, typename Rhs,
+          typename = details::enable_expr_operator_t<Lhs, Rhs>>
+constexpr auto operator* (Lhs const& lhs, Rhs const& rhs) noexcept {
+  return details::make_expr_binary<details::batch_op::mulu,
+                                   details::batch_op::muls> (lhs, rhs);
+}
+/// @}
+
+/// \brief Evaluates the expression \p e for each element and writes the
+/// results to \p out in a single pass.
+///
+/// \p out must have the same number of elements as the arrays in \p e. It
+/// may be the same as one of those arrays (so that, for example, a buffer
+/// can be scaled in place) but must not otherwise overlap them.
+template <typename Expression,
+          typename = std::enable_if_t<details::is_expression_v<Expression>>>
+void assign (span<typename Expression::value_type> const out,
+             Expression const& e) {
+  assert (e.size () == out.size () ||
+          e.size () == any_size);  // expression and out sizes must match
+  auto* const dest = out.data ();
+  for (auto first = size_t{0}, size = out.size (); first < size;
+       first += block_size) {
+    auto const n = std::min (block_size, size - first);
+    // The final operation writes directly to out. A leaf returns its own
+    // elements instead, which must then be copied.
+    auto const* const block = e.block (first, n, dest + first);
+    if (block != dest + first) {
+      std::copy_n (block, n, dest + first);
+    }
+  }
+}
+
+}  // end namespace expr
+
+}  // end namespace saturation
+
+#endif  // SATURATION_EXPR_HPP
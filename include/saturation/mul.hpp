@@ -122,15 +122,125 @@ private:
   }
 };
 
+#if HAVE_INT128
+/// Computes the product of two unsigned 128 bit values or reports that it
+/// does not fit in 128 bits.
+///
+/// The values are split into 64 bit halves. If both high halves are
+/// non-zero, the product is at least \f$ 2^{128} \f$ and overflow is
+/// reported without performing any multiplication. Otherwise at most one of
+/// the cross products is non-zero so that only two 64 &times; 64 bit
+/// multiplications are needed rather than the four of a full 256 bit
+/// product.
+///
+/// \param x  The first of the two values to be multiplied.
+/// \param y  The second of the two values to be multiplied.
+/// \return  A pair consisting of a flag which is true if the product
+///   overflowed and the low 128 bits of the product respectively.
+constexpr std::pair<bool, uinteger_t<128>> multiply128 (
+    uinteger_t<128> const x, uinteger_t<128> const y) {
+  using u128 = uinteger_t<128>;
+  auto const x_hi = static_cast<uint64_t> (x >> 64U);
+  auto const x_lo = static_cast<uint64_t> (x);
+  auto const y_hi = static_cast<uint64_t> (y >> 64U);
+  auto const y_lo = static_cast<uint64_t> (y);
+  if (x_hi != 0U && y_hi != 0U) {
+    return std::make_pair (true, u128{0});
+  }
+  // One of x_hi and y_hi is zero so at most one term of the sum is non-zero
+  // and it cannot wrap.
+  auto const cross = u128{x_hi} * y_lo + u128{y_hi} * x_lo;
+  if ((cross >> 64U) != 0U) {
+    return std::make_pair (true, u128{0});
+  }
+  auto const lo = u128{x_lo} * y_lo;
+  auto const res = lo + (cross << 64U);
+  return std::make_pair (res < lo, res);
+}
+
+/// Computes the saturating product of two unsigned values of more than 64
+/// bits and reports whether it saturated.
+template <size_t N>
+constexpr ovf_result<uinteger_t<N>> mulu_wide (uinteger_t<N> const x,
+                                               uinteger_t<N> const y) {
+  static_assert (N > 64 && N <= 128);
+  auto const [overflow, res] = multiply128 (x, y);
+  if (overflow || res > mask_v<N>) {
+    return {mask_v<N>, true};
+  }
+  return {res, false};
+}
+/// Computes the saturating product of two signed values of more than 64 bits
+/// and reports whether it saturated. The product of the magnitudes is
+/// compared with the largest magnitude which can be represented with the
+/// sign of the result.
+template <size_t N>
+constexpr ovf_result<sinteger_t<N>> muls_wide (sinteger_t<N> const x,
+                                               sinteger_t<N> const y) {
+  static_assert (N > 64 && N <= 128);
+  using u128 = uinteger_t<128>;
+  auto const negative = (x < 0) != (y < 0);
+  auto const abs_x = x < 0 ? u128{0} - static_cast<u128> (x)
+                           : static_cast<u128> (x);
+  auto const abs_y = y < 0 ? u128{0} - static_cast<u128> (y)
+                           : static_cast<u128> (y);
+  auto const limit = static_cast<u128> (slimits<N>::max ()) + negative;
+  auto const [overflow, res] = multiply128 (abs_x, abs_y);
+  if (overflow || res > limit) {
+    return {negative ? slimits<N>::min () : slimits<N>::max (), true};
+  }
+  return {static_cast<sinteger_t<N>> (negative ? u128{0} - res : res), false};
+}
+#endif  // HAVE_INT128
+
+#if SATURATION_BUILTIN_OVERFLOW
+/// An implementation of saturating unsigned multiply for register-sized
+/// values of \p N which is visible to the optimizer. Values of up to 32 bits
+/// are multiplied in a type of twice the width (which the compiler can
+/// vectorize); 64 bit values use __builtin_mul_overflow().
+template <size_t N>
+constexpr uinteger_t<N> mulu_builtin (uinteger_t<N> const x,
+                                      uinteger_t<N> const y) {
+  if constexpr (N <= 32) {
+    auto const res = static_cast<uinteger_t<N * 2>> (uinteger_t<N * 2>{x} * y);
+    return res > ulimits<N>::max () ? ulimits<N>::max ()
+                                    : static_cast<uinteger_t<N>> (res);
+  } else {
+    uinteger_t<N> res = 0;
+    return __builtin_mul_overflow (x, y, &res) ? ulimits<N>::max () : res;
+  }
+}
+#endif  // SATURATION_BUILTIN_OVERFLOW
+
 }  // end namespace details
 
 // mulu
 // ~~~~
 /// \name Unsigned Multiplication
 /// Functions that perform saturating multiplication of unsigned
-/// integral quantities from 4 to 64 bits.
+/// integral quantities from 4 to 64 bits (128 bits if HAVE_INT128 is enabled).
 /// @{
 
+namespace details {
+
+/// The portable implementation of mulu<N>(). It is also used to constant
+/// evaluate those widths for which mulu<N>() is specialized.
+template <size_t N>
+constexpr uinteger_t<N> mulu_generic (uinteger_t<N> const x,
+                                      uinteger_t<N> const y) {
+#if HAVE_INT128
+  if constexpr (N > 64) {
+    return details::mulu_wide<N> (x, y).value;
+  } else
+#endif  // HAVE_INT128
+  {
+    auto const [hi, lo] = details::multiplier<N, true>{}(x, y);
+    return (lo | -!!hi) & mask_v<N>;
+  }
+}
+
+}  // end namespace details
+
 /// \brief Computes the value of \p x &times; \p y.
 ///
 /// If the result overflows --- that is, the correct answer is too large to be
@@ -138,24 +248,34 @@ private:
 /// is \f$ 2^N-1 \f$.
 ///
 /// \tparam N The number of bits for the unsigned arguments and result. May
-///   be in the range \f$ [4, 64] \f$.
+///   be in the range \f$ [4, 64] \f$ (\f$ [4, 128] \f$ if HAVE_INT128 is
+///   enabled).
 /// \param x  The first value to be multiplied.
 /// \param y  The second value to be multiplied.
 /// \returns  \p x &times; \p y. If the result would be too large,
 ///   \f$ 2^N-1 \f$ (saturation::slimits<N>::max()).
-template <size_t N, typename = typename std::enable_if_t<(N >= 4 && N <= 64)>>
+template <size_t N,
+          typename = typename std::enable_if_t<(N >= 4 && N <= max_width)>>
 constexpr uinteger_t<N> mulu (uinteger_t<N> const x, uinteger_t<N> const y) {
   assert (x <= ulimits<N>::max ());  // mulu<> x value out of range
   assert (y <= ulimits<N>::max ());  // mulu<> y value out of range
-  auto const [hi, lo] = details::multiplier<N, true>{}(x, y);
-  return (lo | -!!hi) & mask_v<N>;
+#if SATURATION_BUILTIN_OVERFLOW
+  if constexpr (details::is_register_width (N) && N <= 64) {
+    return details::mulu_builtin<N> (x, y);
+  }
+#endif  // SATURATION_BUILTIN_OVERFLOW
+  return details::mulu_generic<N> (x, y);
 }
 
 #ifndef NO_INLINE_ASM
 #if defined(__GNUC__) && defined(__x86_64__)
+#if !SATURATION_BUILTIN_OVERFLOW
 template <>
-inline uinteger_t<8> mulu<8, std::enable_if_t<true>> (uinteger_t<8> x,
-                                                      uinteger_t<8> y) {
+SATURATION_ASM_CONSTEXPR uinteger_t<8> mulu<8, std::enable_if_t<true>> (
+    uinteger_t<8> x, uinteger_t<8> y) {
+  if (details::is_constant_evaluated ()) {
+    return details::mulu_generic<8> (x, y);
+  }
   uinteger_t<8> t;
   __asm__(
       // %al = x
@@ -169,8 +289,11 @@ inline uinteger_t<8> mulu<8, std::enable_if_t<true>> (uinteger_t<8> x,
   return x;
 }
 template <>
-inline uinteger_t<16> mulu<16, std::enable_if_t<true>> (uinteger_t<16> x,
-                                                        uinteger_t<16> y) {
+SATURATION_ASM_CONSTEXPR uinteger_t<16> mulu<16, std::enable_if_t<true>> (
+    uinteger_t<16> x, uinteger_t<16> y) {
+  if (details::is_constant_evaluated ()) {
+    return details::mulu_generic<16> (x, y);
+  }
   uinteger_t<16> t;
   __asm__(
       // %ax = x
@@ -184,8 +307,11 @@ inline uinteger_t<16> mulu<16, std::enable_if_t<true>> (uinteger_t<16> x,
   return x;
 }
 template <>
-inline uinteger_t<32> mulu<32, std::enable_if_t<true>> (uinteger_t<32> x,
-                                                        uinteger_t<32> y) {
+SATURATION_ASM_CONSTEXPR uinteger_t<32> mulu<32, std::enable_if_t<true>> (
+    uinteger_t<32> x, uinteger_t<32> y) {
+  if (details::is_constant_evaluated ()) {
+    return details::mulu_generic<32> (x, y);
+  }
   uinteger_t<32> t;
   __asm__(
       // %eax = x
@@ -198,9 +324,13 @@ inline uinteger_t<32> mulu<32, std::enable_if_t<true>> (uinteger_t<32> x,
   );
   return x;
 }
+#endif  // !SATURATION_BUILTIN_OVERFLOW
 template <>
-inline uinteger_t<64> mulu<64, std::enable_if_t<true>> (uinteger_t<64> x,
-                                                        uinteger_t<64> y) {
+SATURATION_ASM_CONSTEXPR uinteger_t<64> mulu<64, std::enable_if_t<true>> (
+    uinteger_t<64> x, uinteger_t<64> y) {
+  if (details::is_constant_evaluated ()) {
+    return details::mulu_generic<64> (x, y);
+  }
   uinteger_t<64> t;
   __asm__(
       // %rax = x
@@ -226,7 +356,7 @@ inline uinteger_t<64> mulu<64, std::enable_if_t<true>> (uinteger_t<64> x,
 /// \param y  The second unsigned 32 bit value to be multiplied.
 /// \returns  \p x &times; \p y. If the result would be too large,
 ///   \f$ 2^{32}-1 \f$ (`std::numeric_limits<uint32_t>::max()`).
-inline uint32_t mulu32 (uint32_t const x, uint32_t const y) {
+SATURATION_ASM_CONSTEXPR uint32_t mulu32 (uint32_t const x, uint32_t const y) {
   return mulu<32> (x, y);
 }
 /// \brief Computes the unsigned 16 bit value of \p x &times; \p y.
@@ -239,7 +369,7 @@ inline uint32_t mulu32 (uint32_t const x, uint32_t const y) {
 /// \param y  The second unsigned 16 bit value to be multiplied.
 /// \returns  \p x &times; \p y. If the result would be too large,
 ///   \f$ 2^{16}-1 \f$ (`std::numeric_limits<uint16_t>::max()`).
-inline uint16_t mulu16 (uint16_t const x, uint16_t const y) {
+SATURATION_ASM_CONSTEXPR uint16_t mulu16 (uint16_t const x, uint16_t const y) {
   return mulu<16> (x, y);
 }
 /// \brief Computes the unsigned 8 bit value of \p x &times; \p y.
@@ -252,7 +382,7 @@ inline uint16_t mulu16 (uint16_t const x, uint16_t const y) {
 /// \param y  The second unsigned 8 bit value to be multiplied.
 /// \returns  \p x &times; \p y. If the result would be too large,
 ///   \f$ 2^{8}-1 \f$ (`std::numeric_limits<uint8_t>::max()`).
-inline uint8_t mulu8 (uint8_t const x, uint8_t const y) {
+SATURATION_ASM_CONSTEXPR uint8_t mulu8 (uint8_t const x, uint8_t const y) {
   return mulu<8> (x, y);
 }
 /// @}
@@ -261,7 +391,7 @@ inline uint8_t mulu8 (uint8_t const x, uint8_t const y) {
 // ~~~~
 /// \name Signed Multiplication
 /// Functions that perform saturating multiplication of signed integral
-/// quantities from 4 to 64 bits.
+/// quantities from 4 to 64 bits (128 bits if HAVE_INT128 is enabled).
 /// @{
 
 namespace details {
@@ -281,35 +411,77 @@ constexpr sinteger_t<N> overflow_value (sinteger_t<N> const x,
       static_cast<uint> (slimits<N>::max ()))})};
 }
 
+#if SATURATION_BUILTIN_OVERFLOW
+/// An implementation of saturating signed multiply for register-sized values
+/// of \p N which is visible to the optimizer. Values of up to 32 bits are
+/// multiplied in a type of twice the width (which the compiler can
+/// vectorize); 64 bit values use __builtin_mul_overflow().
+template <size_t N>
+constexpr sinteger_t<N> muls_builtin (sinteger_t<N> const x,
+                                      sinteger_t<N> const y) {
+  if constexpr (N <= 32) {
+    auto const res = static_cast<sinteger_t<N * 2>> (sinteger_t<N * 2>{x} * y);
+    return res > slimits<N>::max ()   ? slimits<N>::max ()
+           : res < slimits<N>::min () ? slimits<N>::min ()
+                                      : static_cast<sinteger_t<N>> (res);
+  } else {
+    sinteger_t<N> res = 0;
+    return __builtin_mul_overflow (x, y, &res) ? overflow_value<N> (x, y)
+                                               : res;
+  }
+}
+#endif  // SATURATION_BUILTIN_OVERFLOW
+
+/// The portable implementation of muls<N>(). It is also used to constant
+/// evaluate those widths for which muls<N>() is specialized.
+template <size_t N>
+constexpr sinteger_t<N> muls_generic (sinteger_t<N> const x,
+                                      sinteger_t<N> const y) {
+#if HAVE_INT128
+  if constexpr (N > 64) {
+    return details::muls_wide<N> (x, y).value;
+  } else
+#endif  // HAVE_INT128
+  {
+    using sbits = details::nbit_scalar<N, false>;
+    using sint = typename sbits::type;
+
+    auto const [hi, lo] = details::multiplier<N, false>{}(x, y);
+    if (hi != lo >> (N - 1)) {
+      auto const v = details::overflow_value<N> (x, y);
+      assert (v == (hi < 0 ? slimits<N>::min () : slimits<N>::max ()));
+      return v;
+    }
+    return static_cast<sint> (lo);
+  }
+}
+
 }  // end namespace details
 
 /// \brief Computes the signed result of multiplying \p x by \p y.
 ///
 /// \tparam N The number of bits for the twos complement arguments and
-///   result. May be in the range \f$ [4, 32] \f$.
+///   result. May be in the range \f$ [4, 64] \f$ (\f$ [4, 128] \f$ if
+///   HAVE_INT128 is enabled).
 /// \param x  The first value to be multiplied.
 /// \param y  The second value to be multiplied.
 /// \returns  \p x &times; \p y. If the result would be too large and positive,
 ///   \f$ 2^{N-1}-1 \f$ (saturation::slimits<N>::max()); if the result
 ///   would be too large and negative, \f$ -2^{N-1} \f$
 ///   (saturation::slimits<N>::min()).
-template <size_t N, typename = typename std::enable_if_t<(N >= 4 && N <= 64)>>
+template <size_t N,
+          typename = typename std::enable_if_t<(N >= 4 && N <= max_width)>>
 constexpr sinteger_t<N> muls (sinteger_t<N> const x, sinteger_t<N> const y) {
   assert (x >= slimits<N>::min () &&
           x <= slimits<N>::max ());  // muls<> x value out of range
   assert (y >= slimits<N>::min () &&
           y <= slimits<N>::max ());  // muls<> y value out of range
-
-  using sbits = details::nbit_scalar<N, false>;
-  using sint = typename sbits::type;
-
-  auto const [hi, lo] = details::multiplier<N, false>{}(x, y);
-  if (hi != lo >> (N - 1)) {
-    auto const v = details::overflow_value<N> (x, y);
-    assert (v == (hi < 0 ? slimits<N>::min () : slimits<N>::max ()));
-    return v;
+#if SATURATION_BUILTIN_OVERFLOW
+  if constexpr (details::is_register_width (N) && N <= 64) {
+    return details::muls_builtin<N> (x, y);
   }
-  return static_cast<sint> (lo);
+#endif  // SATURATION_BUILTIN_OVERFLOW
+  return details::muls_generic<N> (x, y);
 }
 
 #ifndef NO_INLINE_ASM
@@ -331,19 +503,30 @@ inline sinteger_t<N> muls_asm (sinteger_t<N> x, sinteger_t<N> y) {
 
 }  // end namespace details
 
+#if !SATURATION_BUILTIN_OVERFLOW
 template <>
-inline sinteger_t<16> muls<16, std::enable_if_t<true>> (
+SATURATION_ASM_CONSTEXPR sinteger_t<16> muls<16, std::enable_if_t<true>> (
     sinteger_t<16> const x, sinteger_t<16> const y) {
+  if (details::is_constant_evaluated ()) {
+    return details::muls_generic<16> (x, y);
+  }
   return details::muls_asm<16> (x, y);
 }
 template <>
-inline sinteger_t<32> muls<32, std::enable_if_t<true>> (
+SATURATION_ASM_CONSTEXPR sinteger_t<32> muls<32, std::enable_if_t<true>> (
     sinteger_t<32> const x, sinteger_t<32> const y) {
+  if (details::is_constant_evaluated ()) {
+    return details::muls_generic<32> (x, y);
+  }
   return details::muls_asm<32> (x, y);
 }
+#endif  // !SATURATION_BUILTIN_OVERFLOW
 template <>
-inline sinteger_t<64> muls<64, std::enable_if_t<true>> (
+SATURATION_ASM_CONSTEXPR sinteger_t<64> muls<64, std::enable_if_t<true>> (
     sinteger_t<64> const x, sinteger_t<64> const y) {
+  if (details::is_constant_evaluated ()) {
+    return details::muls_generic<64> (x, y);
+  }
   return details::muls_asm<64> (x, y);
 }
 #endif  // __GNUC__ && __x86_64__
@@ -357,7 +540,7 @@ inline sinteger_t<64> muls<64, std::enable_if_t<true>> (
 ///   \f$ 2^{31}-1 \f$ (`std::numeric_limits<int32_t>::max()`); if the result
 ///   would be too large and negative, \f$ -2^{31} \f$
 ///   (`std::numeric_limits<int32_t>::min()`).
-inline int32_t muls32 (int32_t const x, int32_t const y) {
+SATURATION_ASM_CONSTEXPR int32_t muls32 (int32_t const x, int32_t const y) {
   return muls<32> (x, y);
 }
 /// \brief Computes the signed 16 bit result of multiplying \p x by \p y.
@@ -368,7 +551,7 @@ inline int32_t muls32 (int32_t const x, int32_t const y) {
 ///   \f$ 2^{15}-1 \f$ (`std::numeric_limits<int16_t>::max()`); if the result
 ///   would be too large and negative, \f$ -2^{15} \f$
 ///   (`std::numeric_limits<int16_t>::min()`).
-inline int16_t muls16 (int16_t const x, int16_t const y) {
+SATURATION_ASM_CONSTEXPR int16_t muls16 (int16_t const x, int16_t const y) {
   return muls<16> (x, y);
 }
 /// \brief Computes the signed 8 bit result of multiplying \p x by \p y.
@@ -384,6 +567,196 @@ constexpr int8_t muls8 (int8_t const x, int8_t const y) {
 }
 /// @}
 
+/// \name Multiplication with Overflow Reporting
+/// Functions that perform saturating multiplication and also report whether
+/// the result was clamped. The report is the condition which the saturating
+/// functions test internally: the carry flag of mul or imul where inline
+/// assembler is used and the high half of the product otherwise.
+/// @{
+
+namespace details {
+
+/// The portable implementation of mulu_ovf<N>().
+template <size_t N>
+constexpr ovf_result<uinteger_t<N>> mulu_ovf_generic (uinteger_t<N> const x,
+                                                      uinteger_t<N> const y) {
+#if HAVE_INT128
+  if constexpr (N > 64) {
+    return details::mulu_wide<N> (x, y);
+  } else
+#endif  // HAVE_INT128
+  {
+    auto const [hi, lo] = details::multiplier<N, true>{}(x, y);
+    if (hi != 0U) {
+      return {ulimits<N>::max (), true};
+    }
+    return {static_cast<uinteger_t<N>> (lo & mask_v<N>), false};
+  }
+}
+/// The portable implementation of muls_ovf<N>().
+template <size_t N>
+constexpr ovf_result<sinteger_t<N>> muls_ovf_generic (sinteger_t<N> const x,
+                                                      sinteger_t<N> const y) {
+#if HAVE_INT128
+  if constexpr (N > 64) {
+    return details::muls_wide<N> (x, y);
+  } else
+#endif  // HAVE_INT128
+  {
+    auto const [hi, lo] = details::multiplier<N, false>{}(x, y);
+    if (hi != lo >> (N - 1)) {
+      return {details::overflow_value<N> (x, y), true};
+    }
+    return {static_cast<sinteger_t<N>> (lo), false};
+  }
+}
+
+#if SATURATION_BUILTIN_OVERFLOW
+/// An implementation of mulu_ovf<N>() for register-sized values of \p N. As
+/// for mulu_builtin<N>(), values of up to 32 bits are multiplied in a type
+/// of twice the width.
+template <size_t N>
+constexpr ovf_result<uinteger_t<N>> mulu_ovf_builtin (uinteger_t<N> const x,
+                                                      uinteger_t<N> const y) {
+  if constexpr (N <= 32) {
+    auto const res = static_cast<uinteger_t<N * 2>> (uinteger_t<N * 2>{x} * y);
+    bool const saturated = res > ulimits<N>::max ();
+    return {saturated ? ulimits<N>::max () : static_cast<uinteger_t<N>> (res),
+            saturated};
+  } else {
+    uinteger_t<N> res = 0;
+    bool const saturated = __builtin_mul_overflow (x, y, &res);
+    return {saturated ? ulimits<N>::max () : res, saturated};
+  }
+}
+/// An implementation of muls_ovf<N>() for register-sized values of \p N.
+template <size_t N>
+constexpr ovf_result<sinteger_t<N>> muls_ovf_builtin (sinteger_t<N> const x,
+                                                      sinteger_t<N> const y) {
+  if constexpr (N <= 32) {
+    auto const res = static_cast<sinteger_t<N * 2>> (sinteger_t<N * 2>{x} * y);
+    if (res > slimits<N>::max ()) {
+      return {slimits<N>::max (), true};
+    }
+    if (res < slimits<N>::min ()) {
+      return {slimits<N>::min (), true};
+    }
+    return {static_cast<sinteger_t<N>> (res), false};
+  } else {
+    sinteger_t<N> res = 0;
+    bool const saturated = __builtin_mul_overflow (x, y, &res);
+    return {saturated ? overflow_value<N> (x, y) : res, saturated};
+  }
+}
+#endif  // SATURATION_BUILTIN_OVERFLOW
+
+#if SATURATION_ASM_FLAG_OUTPUTS
+/// An x86-only implementation of mulu_ovf<N>() for register-sized values of
+/// \p N. mul sets the carry flag if the high half of the product is non-zero.
+template <size_t N>
+inline ovf_result<uinteger_t<N>> mulu_ovf_asm (uinteger_t<N> x,
+                                               uinteger_t<N> const y) {
+  bool carry;
+  if constexpr (N == 8) {
+    __asm__(
+        // %al = x
+        "mul %[y]"                           // %ax = %al * y (sets carry C)
+        : [x] "+a"(x), [c] "=@ccc"(carry)  // output
+        : [y] "r"(y)                         // input
+    );
+  } else {
+    uinteger_t<N> hi;
+    __asm__(
+        // %rax = x
+        "mul %[y]"  // %rdx:%rax = %rax * y (sets carry C on overflow)
+        : [x] "+a"(x), [hi] "=d"(hi), [c] "=@ccc"(carry)  // output
+        : [y] "r"(y)                                      // input
+    );
+  }
+  return {carry ? ulimits<N>::max () : x, carry};
+}
+/// An x86-only implementation of muls_ovf<N>() for register-sized values of
+/// \p N of at least 16 bits. As muls_asm<N>() but the carry flag, which imul
+/// sets if the product was truncated, is also returned.
+template <size_t N>
+inline ovf_result<sinteger_t<N>> muls_ovf_asm (sinteger_t<N> x,
+                                               sinteger_t<N> const y) {
+  sinteger_t<N> const v = overflow_value<N> (x, y);
+  bool carry;
+  __asm__(
+      "imul   {%[y],%[x] | %[x],%[y]}\n\t"  // x *= y (sets C on overflow)
+      "cmovc  {%[v],%[x] | %[x],%[v]}"      // if C, x = v
+      : [x] "+&r"(x), [c] "=@ccc"(carry)  // output
+      : [y] "r"(y), [v] "r"(v)            // input
+  );
+  return {x, carry};
+}
+#endif  // SATURATION_ASM_FLAG_OUTPUTS
+
+}  // end namespace details
+
+/// \brief Multiplies two unsigned values each \p N bits wide and reports
+///   whether the result saturated.
+///
+/// \tparam N  The number of bits for the unsigned arguments and result. May
+///   be in the range \f$ [4, 64] \f$ (\f$ [4, 128] \f$ if HAVE_INT128 is
+///   enabled).
+/// \param x  The first value to be multiplied.
+/// \param y  The second value to be multiplied.
+/// \result  The value mulu<N>(\p x, \p y) and true if \p x &times; \p y
+///   could not be represented in \p N bits.
+template <size_t N,
+          typename = typename std::enable_if_t<(N >= 4 && N <= max_width)>>
+constexpr ovf_result<uinteger_t<N>> mulu_ovf (uinteger_t<N> const x,
+                                              uinteger_t<N> const y) {
+  assert (x <= ulimits<N>::max ());  // mulu_ovf<> x value out of range
+  assert (y <= ulimits<N>::max ());  // mulu_ovf<> y value out of range
+#if SATURATION_BUILTIN_OVERFLOW
+  if constexpr (details::is_register_width (N) && N <= 64) {
+    return details::mulu_ovf_builtin<N> (x, y);
+  }
+#elif SATURATION_ASM_FLAG_OUTPUTS
+  if constexpr (details::is_register_width (N) && N <= 64) {
+    if (!details::is_constant_evaluated ()) {
+      return details::mulu_ovf_asm<N> (x, y);
+    }
+  }
+#endif  // SATURATION_BUILTIN_OVERFLOW
+  return details::mulu_ovf_generic<N> (x, y);
+}
+/// \brief Multiplies two signed values each \p N bits wide and reports
+///   whether the result saturated.
+///
+/// \tparam N  The number of bits for the signed arguments and result. May be
+///   in the range \f$ [4, 64] \f$ (\f$ [4, 128] \f$ if HAVE_INT128 is
+///   enabled).
+/// \param x  The first value to be multiplied.
+/// \param y  The second value to be multiplied.
+/// \result  The value muls<N>(\p x, \p y) and true if \p x &times; \p y
+///   could not be represented in \p N bits.
+template <size_t N,
+          typename = typename std::enable_if_t<(N >= 4 && N <= max_width)>>
+constexpr ovf_result<sinteger_t<N>> muls_ovf (sinteger_t<N> const x,
+                                              sinteger_t<N> const y) {
+  assert (x >= slimits<N>::min () &&
+          x <= slimits<N>::max ());  // muls_ovf<> x value out of range
+  assert (y >= slimits<N>::min () &&
+          y <= slimits<N>::max ());  // muls_ovf<> y value out of range
+#if SATURATION_BUILTIN_OVERFLOW
+  if constexpr (details::is_register_width (N) && N <= 64) {
+    return details::muls_ovf_builtin<N> (x, y);
+  }
+#elif SATURATION_ASM_FLAG_OUTPUTS
+  if constexpr (details::is_register_width (N) && N >= 16 && N <= 64) {
+    if (!details::is_constant_evaluated ()) {
+      return details::muls_ovf_asm<N> (x, y);
+    }
+  }
+#endif  // SATURATION_BUILTIN_OVERFLOW
+  return details::muls_ovf_generic<N> (x, y);
+}
+/// @}
+
 }  // end namespace saturation
 
 #endif  // SATURATION_MUL_HPP
@@ -0,0 +1,239 @@
+/// \file packed_array.hpp
+/// \brief A densely bit-packed array of N bit values and the saturating bulk
+/// operations which act upon it.
+///
+/// An array of (say) 12 bit values held in a std::vector<uint16_t> wastes a
+/// quarter of its memory and of the bandwidth needed to stream it.
+/// packed_array<N, IsSigned> stores its elements end to end in 64 bit words
+/// so that each uses exactly N bits. The bulk operations unpack a block of
+/// elements into a small local buffer, apply the batch kernel (SIMD where
+/// available) and repack the results.
+
+#ifndef SATURATION_PACKED_ARRAY_HPP
+#define SATURATION_PACKED_ARRAY_HPP
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+
+#include "saturation/batch.hpp"
+#include "saturation/span.hpp"
+#include "saturation/types.hpp"
+
+namespace saturation {
+
+/// \brief A fixed-size array of \p N bit integers packed end to end.
+///
+/// Element i occupies bits [i * N, (i + 1) * N) of a little-endian sequence of
+/// 64 bit words. A block of 64 consecutive elements starting at a multiple of
+/// 64 therefore always begins on a word boundary and occupies exactly \p N
+/// words.
+///
+/// \tparam N  The number of bits in each element. May be in the range
+///   \f$ [4, 64] \f$.
+/// \tparam IsSigned  True if the elements are signed (twos complement);
+///   false otherwise.
+template <size_t N, bool IsSigned,
+          typename = typename std::enable_if_t<(N >= 4 && N <= 64)>>
+class packed_array {
+public:
+  /// The type used to pass individual elements into and out of the array.
+  using value_type = std::conditional_t<IsSigned, sinteger_t<N>, uinteger_t<N>>;
+  using size_type = size_t;
+
+  /// The number of elements unpacked at a time by the bulk operations.
+  static constexpr auto block_size = size_t{64};
+
+  /// Constructs an empty array.
+  packed_array () = default;
+  /// Constructs an array of \p size elements, each of which is zero.
+  explicit packed_array (size_type const size)
+      : size_{size}, words_ (word_count (size), std::uint64_t{0}) {}
+  /// Constructs an array holding a copy of the values in \p values.
+  explicit packed_array (span<value_type const> const values)
+      : packed_array (values.size ()) {
+    pack (0U, values);
+  }
+  packed_array (std::initializer_list<value_type> const values)
+      : packed_array (span<value_type const>{values.begin (), values.size ()}) {
+  }
+
+  /// Returns the number of elements in the array.
+  constexpr size_type size () const noexcept { return size_; }
+  /// Returns true if the array has no elements.
+  constexpr bool empty () const noexcept { return size_ == 0U; }
+  /// Returns the number of bytes used to store the elements.
+  size_type storage_bytes () const noexcept {
+    return words_.size () * sizeof (std::uint64_t);
+  }
+
+  /// Returns the element at index \p pos.
+  value_type get (size_type const pos) const {
+    assert (pos < size_);  // packed_array<> index out of range
+    return extend (extract (words_.data (), pos * N));
+  }
+  /// Replaces the element at index \p pos with \p value.
+  void set (size_type const pos, value_type const value) {
+    assert (pos < size_);  // packed_array<> index out of range
+    insert (words_.data (), pos * N, truncate (value));
+  }
+
+  /// Copies out.size() elements starting at index \p first to \p out.
+  void unpack (size_type const first, span<value_type> const out) const {
+    assert (first <= size_ &&
+            out.size () <= size_ - first);  // packed_array<> unpack range
+    auto const* const words = words_.data ();
+    auto bit = first * N;
+    for (auto& v : out) {
+      v = extend (extract (words, bit));
+      bit += N;
+    }
+  }
+  /// Replaces values.size() elements starting at index \p first with the
+  /// contents of \p values.
+  void pack (size_type const first, span<value_type const> const values) {
+    assert (first <= size_ &&
+            values.size () <= size_ - first);  // packed_array<> pack range
+    auto* const words = words_.data ();
+    auto bit = first * N;
+    for (auto const v : values) {
+      insert (words, bit, truncate (v));
+      bit += N;
+    }
+  }
+
+private:
+  static constexpr auto mask = std::uint64_t{mask_v<N>};
+
+  /// Returns the number of words needed to store \p size elements. An extra
+  /// word is always allocated so that an element may be read or written as
+  /// a pair of adjacent words without first checking whether it straddles a
+  /// word boundary.
+  static constexpr size_type word_count (size_type const size) {
+    return (size * N + 63U) / 64U + 1U;
+  }
+  /// Returns the \p N bits of \p words starting at bit \p bit.
+  static std::uint64_t extract (std::uint64_t const* const words,
+                                size_type const bit) {
+    auto const index = bit / 64U;
+    auto const offset = static_cast<unsigned> (bit % 64U);
+    // The second shift is split in two so that no shift is by 64 bits.
+    return ((words[index] >> offset) |
+            ((words[index + 1U] << 1U) << (63U - offset))) &
+           mask;
+  }
+  /// Replaces the \p N bits of \p words starting at bit \p bit with \p raw.
+  static void insert (std::uint64_t* const words, size_type const bit,
+                      std::uint64_t const raw) {
+    auto const index = bit / 64U;
+    auto const offset = static_cast<unsigned> (bit % 64U);
+    words[index] = (words[index] & ~(mask << offset)) | (raw << offset);
+    auto const high_shift = 63U - offset;
+    words[index + 1U] = (words[index + 1U] & ~((mask >> 1U) >> high_shift)) |
+                        ((raw >> 1U) >> high_shift);
+  }
+  /// Converts the raw bits of an element to its value.
+  static value_type extend (std::uint64_t const raw) {
+    if constexpr (IsSigned) {
+      // Sign-extend from bit N-1.
+      constexpr auto sign = std::uint64_t{1} << (N - 1U);
+      return static_cast<value_type> (
+          static_cast<std::int64_t> ((raw ^ sign) - sign));
+    } else {
+      return static_cast<value_type> (raw);
+    }
+  }
+  /// Converts an element value to its raw bits.
+  static std::uint64_t truncate (value_type const value) {
+    if constexpr (IsSigned) {
+      assert (value >= slimits<N>::min () &&
+              value <= slimits<N>::max ());  // packed_array<> value range
+    } else {
+      assert (value <= ulimits<N>::max ());  // packed_array<> value range
+    }
+    return static_cast<std::uint64_t> (value) & mask;
+  }
+
+  size_type size_ = 0;
+  std::vector<std::uint64_t> words_ = std::vector<std::uint64_t> (1U);
+};
+
+namespace details {
+
+/// Applies the elementwise operation \p Op to the packed arrays \p x and
+/// \p y, writing the results to \p out. Each block of elements is unpacked
+/// into local buffers, processed by the batch kernel for \p Op, and the
+/// results packed into \p out. \p out may be the same object as \p x or \p y.
+template <batch_op Op, size_t N>
+void packed_apply (packed_array<N, !is_unsigned_op (Op)> const& x,
+                   packed_array<N, !is_unsigned_op (Op)> const& y,
+                   packed_array<N, !is_unsigned_op (Op)>& out) {
+  assert (x.size () == out.size ());  // batch x and out sizes must match
+  assert (y.size () == out.size ());  // batch y and out sizes must match
+  using value_type = batch_arg_t<Op, N>;
+  constexpr auto block_size = packed_array<N, !is_unsigned_op (Op)>::block_size;
+  auto const kernel = dispatch<Op, N>::get ();
+  std::array<value_type, block_size> bx;
+  std::array<value_type, block_size> by;
+  std::array<value_type, block_size> bout;
+  for (auto first = size_t{0}, size = out.size (); first < size;
+       first += block_size) {
+    auto const n = std::min (block_size, size - first);
+    x.unpack (first, span<value_type>{bx.data (), n});
+    y.unpack (first, span<value_type>{by.data (), n});
+    kernel (bx.data (), by.data (), bout.data (), n);
+    out.pack (first, span<value_type const>{bout.data (), n});
+  }
+}
+
+}  // end namespace details
+
+namespace batch {
+
+/// \name Packed Array Operations
+/// Functions that apply a saturating operation to each pair of elements of
+/// two packed arrays. For each i, out[i] is set to the result of the
+/// corresponding scalar function applied to x[i] and y[i]. The arrays must
+/// have the same size. \p out may be the same object as \p x or \p y.
+/// @{
+
+template <size_t N>
+void addu (packed_array<N, false> const& x, packed_array<N, false> const& y,
+           packed_array<N, false>& out) {
+  details::packed_apply<details::batch_op::addu, N> (x, y, out);
+}
+template <size_t N>
+void adds (packed_array<N, true> const& x, packed_array<N, true> const& y,
+           packed_array<N, true>& out) {
+  details::packed_apply<details::batch_op::adds, N> (x, y, out);
+}
+template <size_t N>
+void subu (packed_array<N, false> const& x, packed_array<N, false> const& y,
+           packed_array<N, false>& out) {
+  details::packed_apply<details::batch_op::subu, N> (x, y, out);
+}
+template <size_t N>
+void subs (packed_array<N, true> const& x, packed_array<N, true> const& y,
+           packed_array<N, true>& out) {
+  details::packed_apply<details::batch_op::subs, N> (x, y, out);
+}
+template <size_t N>
+void mulu (packed_array<N, false> const& x, packed_array<N, false> const& y,
+           packed_array<N, false>& out) {
+  details::packed_apply<details::batch_op::mulu, N> (x, y, out);
+}
+template <size_t N>
+void muls (packed_array<N, true> const& x, packed_array<N, true> const& y,
+           packed_array<N, true>& out) {
+  details::packed_apply<details::batch_op::muls, N> (x, y, out);
+}
+/// @}
+
+}  // end namespace batch
+
+}  // end namespace saturation
+
+#endif  // SATURATION_PACKED_ARRAY_HPP
@@ -0,0 +1,191 @@
+/// \file sat.hpp
+/// \brief A value type holding an \p N bit integer whose arithmetic operators
+/// saturate.
+///
+/// sat<N, IsSigned> wraps a single sinteger_t<N> or uinteger_t<N> which is
+/// always in the range of an \p N bit value. Its operators call the free
+/// functions (adds<N>(), mulu<N>(), and so on) directly, so that
+///
+///     auto const y = a * gain + b;
+///
+/// compiles to the same code as
+///
+///     auto const y = adds<24> (muls<24> (a, gain), b);
+///
+/// while the type system keeps values of different widths apart. A value may
+/// be implicitly converted to a sat<> of the same or greater range; narrowing
+/// conversions must be written explicitly with sat<>::clamp().
+
+#ifndef SATURATION_SAT_HPP
+#define SATURATION_SAT_HPP
+
+#include <cassert>
+#include <type_traits>
+
+#include "saturation/add.hpp"
+#include "saturation/div.hpp"
+#include "saturation/mul.hpp"
+#include "saturation/sub.hpp"
+#include "saturation/types.hpp"
+
+namespace saturation {
+
+/// \brief An \p N bit integer with saturating arithmetic operators.
+///
+/// \tparam N  The number of bits in the value. May be in the range
+///   \f$ [4, 64] \f$ (\f$ [4, 128] \f$ if HAVE_INT128 is enabled).
+/// \tparam IsSigned  True if the value is signed (twos complement); false
+///   otherwise.
+template <size_t N, bool IsSigned,
+          typename = typename std::enable_if_t<(N >= 4 && N <= max_width)>>
+class sat {
+public:
+  /// The standard integer type used to hold the value.
+  using value_type = std::conditional_t<IsSigned, sinteger_t<N>, uinteger_t<N>>;
+
+  /// Constructs a value of zero.
+  constexpr sat () noexcept = default;
+  /// Constructs from a value of the underlying type which must be in the
+  /// range of an \p N bit value.
+  explicit constexpr sat (value_type const v) noexcept : v_{v} {
+    assert (v >= min_value () && v <= max_value ());  // sat<> value range
+  }
+  /// Implicit conversion from a sat<> whose range lies within this one: one
+  /// of the same signedness and no more bits, or an unsigned value with fewer
+  /// bits.
+  template <size_t M, bool S,
+            typename = std::enable_if_t<(S == IsSigned && M <= N) ||
+                                        (!S && IsSigned && M < N)>>
+  constexpr sat (sat<M, S> const& other) noexcept
+      : v_{static_cast<value_type> (other.get ())} {}
+
+  /// Returns \p v clamped to the range of an \p N bit value.
+  template <typename T, typename = std::enable_if_t<std::is_integral_v<T>>>
+  static constexpr sat clamp (T const v) noexcept {
+    if constexpr (std::is_signed_v<T>) {
+      if (v < 0) {
+        if constexpr (IsSigned) {
+          return v < min_value () ? min () : sat{static_cast<value_type> (v)};
+        } else {
+          return sat{};
+        }
+      }
+    }
+    using unsigned_t = std::make_unsigned_t<T>;
+    return static_cast<unsigned_t> (v) >
+                   static_cast<uinteger_t<N>> (max_value ())
+               ? max ()
+               : sat{static_cast<value_type> (v)};
+  }
+  /// Returns \p v clamped to the range of an \p N bit value.
+  template <size_t M, bool S>
+  static constexpr sat clamp (sat<M, S> const& v) noexcept {
+    return clamp (v.get ());
+  }
+
+  /// The largest value.
+  static constexpr sat max () noexcept { return sat{max_value ()}; }
+  /// The smallest value.
+  static constexpr sat min () noexcept { return sat{min_value ()}; }
+
+  /// Returns the value.
+  constexpr value_type get () const noexcept { return v_; }
+  /// Explicit conversion to the underlying type.
+  explicit constexpr operator value_type () const noexcept { return v_; }
+
+  /// \name Arithmetic Operators
+  /// Saturating arithmetic: each is equivalent to the corresponding free
+  /// function (for example, x + y computes adds<N>(x, y) or addu<N>(x, y)).
+  /// @{
+  friend constexpr sat operator+ (sat const x, sat const y) noexcept {
+    if constexpr (IsSigned) {
+      return sat{adds<N> (x.v_, y.v_), raw{}};
+    } else {
+      return sat{addu<N> (x.v_, y.v_), raw{}};
+    }
+  }
+  friend constexpr sat operator- (sat const x, sat const y) noexcept {
+    if constexpr (IsSigned) {
+      return sat{subs<N> (x.v_, y.v_), raw{}};
+    } else {
+      return sat{subu<N> (x.v_, y.v_), raw{}};
+    }
+  }
+  friend constexpr sat operator* (sat const x, sat const y) noexcept {
+    if constexpr (IsSigned) {
+      return sat{muls<N> (x.v_, y.v_), raw{}};
+    } else {
+      return sat{mulu<N> (x.v_, y.v_), raw{}};
+    }
+  }
+  /// \p y must not be zero.
+  friend constexpr sat operator/ (sat const x, sat const y) noexcept {
+    if constexpr (IsSigned) {
+      return sat{divs<N> (x.v_, y.v_), raw{}};
+    } else {
+      return sat{divu<N> (x.v_, y.v_), raw{}};
+    }
+  }
+  /// Negation: -min() saturates to max(); an unsigned value saturates to 0.
+  friend constexpr sat operator- (sat const x) noexcept { return sat{} - x; }
+  friend constexpr sat operator+ (sat const x) noexcept { return x; }
+
+  constexpr sat& operator+= (sat const y) noexcept { return *this = *this + y; }
+  constexpr sat& operator-= (sat const y) noexcept { return *this = *this - y; }
+  constexpr sat& operator*= (sat const y) noexcept { return *this = *this * y; }
+  constexpr sat& operator/= (sat const y) noexcept { return *this = *this / y; }
+  /// @}
+
+  friend constexpr bool operator== (sat const x, sat const y) noexcept {
+    return x.v_ == y.v_;
+  }
+  friend constexpr bool operator!= (sat const x, sat const y) noexcept {
+    return x.v_ != y.v_;
+  }
+  friend constexpr bool operator< (sat const x, sat const y) noexcept {
+    return x.v_ < y.v_;
+  }
+  friend constexpr bool operator<= (sat const x, sat const y) noexcept {
+    return x.v_ <= y.v_;
+  }
+  friend constexpr bool operator> (sat const x, sat const y) noexcept {
+    return x.v_ > y.v_;
+  }
+  friend constexpr bool operator>= (sat const x, sat const y) noexcept {
+    return x.v_ >= y.v_;
+  }
+
+private:
+  /// A tag for the private constructor used to wrap results which are known
+  /// to be in range.
+  struct raw {};
+  constexpr sat (value_type const v, raw) noexcept : v_{v} {}
+
+  static constexpr value_type max_value () noexcept {
+    if constexpr (IsSigned) {
+      return slimits<N>::max ();
+    } else {
+      return ulimits<N>::max ();
+    }
+  }
+  static constexpr value_type min_value () noexcept {
+    if constexpr (IsSigned) {
+      return slimits<N>::min ();
+    } else {
+      return value_type{0};
+    }
+  }
+
+  value_type v_ = 0;
+};
+
+/// An unsigned \p N bit integer with saturating arithmetic operators.
+template <size_t N>
+using sat_uint = sat<N, false>;
+/// A signed \p N bit integer with saturating arithmetic operators.
+template <size_t N>
+using sat_int = sat<N, true>;
+
+}  // end namespace saturation
+
+#endif  // SATURATION_SAT_HPP
@@ -11,6 +11,8 @@
 
 #include "saturation/add.hpp"
 #include "saturation/div.hpp"
+#include "saturation/div_round.hpp"
+#include "saturation/divider.hpp"
 #include "saturation/mul.hpp"
 #include "saturation/sub.hpp"
 
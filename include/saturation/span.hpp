@@ -0,0 +1,102 @@
+#ifndef SATURATION_SPAN_HPP
+#define SATURATION_SPAN_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+namespace saturation {
+
+/// \brief A non-owning view of a contiguous sequence of objects.
+///
+/// This is a minimal stand-in for C++20 std::span<> (with dynamic extent
+/// only) so that the batch functions can be used with C++17. A span may be
+/// constructed from a pointer and a count, from a built-in array, or from any
+/// container that provides data() and size() members (such as std::vector<>,
+/// std::array<>, or std::span<>).
+///
+/// \tparam T  The element type. May be const-qualified.
+template <typename T>
+class span {
+  template <typename Container>
+  using data_type = decltype (std::data (std::declval<Container&> ()));
+
+  /// True if an object of type \p U can be viewed as an object of type T.
+  template <typename U>
+  static constexpr bool is_compatible_element_v =
+      std::is_convertible_v<U (*)[], T (*)[]>;
+
+public:
+  using element_type = T;
+  using value_type = std::remove_cv_t<T>;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using pointer = T*;
+  using const_pointer = T const*;
+  using reference = T&;
+  using iterator = T*;
+
+  constexpr span () noexcept = default;
+  /// Constructs a span which views \p count objects starting at \p data.
+  constexpr span (pointer const data, size_type const count) noexcept
+      : data_{data}, size_{count} {}
+  /// Constructs a span which views the elements of the array \p arr.
+  template <size_t Size>
+  constexpr span (element_type (&arr)[Size]) noexcept
+      : data_{arr}, size_{Size} {}
+  /// Constructs a span which views the elements of the contiguous container
+  /// \p c.
+  template <typename Container,
+            typename = std::enable_if_t<is_compatible_element_v<
+                std::remove_pointer_t<data_type<Container>>>>>
+  constexpr span (Container& c) noexcept (noexcept (std::data (c)))
+      : data_{std::data (c)}, size_{std::size (c)} {}
+  /// Converting constructor permitting (for example) span<int> to
+  /// span<int const>.
+  template <typename U,
+            typename = std::enable_if_t<is_compatible_element_v<U>>>
+  constexpr span (span<U> const& other) noexcept
+      : data_{other.data ()}, size_{other.size ()} {}
+
+  constexpr span (span const&) noexcept = default;
+  constexpr span& operator= (span const&) noexcept = default;
+
+  constexpr pointer data () const noexcept { return data_; }
+  constexpr size_type size () const noexcept { return size_; }
+  constexpr bool empty () const noexcept { return size_ == 0U; }
+
+  constexpr iterator begin () const noexcept { return data_; }
+  constexpr iterator end () const noexcept { return data_ + size_; }
+
+  constexpr reference operator[] (size_type const idx) const {
+    assert (idx < size_);  // span<> index out of range
+    return data_[idx];
+  }
+
+  /// Returns a span which views \p count elements of this span starting at
+  /// \p offset.
+  constexpr span subspan (size_type const offset,
+                          size_type const count) const {
+    assert (offset <= size_ && count <= size_ - offset);  // span<> subspan
+    return {data_ + offset, count};
+  }
+  /// Returns a span which views the first \p count elements of this span.
+  constexpr span first (size_type const count) const {
+    return subspan (0U, count);
+  }
+
+private:
+  pointer data_ = nullptr;
+  size_type size_ = 0U;
+};
+
+template <typename T, size_t Size>
+span (T (&)[Size]) -> span<T>;
+template <typename Container>
+span (Container&) -> span<std::remove_pointer_t<
+    decltype (std::data (std::declval<Container&> ()))>>;
+
+}  // end namespace saturation
+
+#endif  // SATURATION_SPAN_HPP
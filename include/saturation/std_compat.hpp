@@ -0,0 +1,150 @@
+/// \file std_compat.hpp
+/// \brief Type-driven saturating arithmetic with the names and signatures of
+/// the C++26 standard library functions (std::add_sat(), std::sub_sat(),
+/// std::mul_sat(), std::div_sat(), and std::saturate_cast()).
+///
+/// Code can be written against the standard names while still using this
+/// library's implementations: saturation::add_sat<T>() on a 32 bit type, for
+/// example, calls saturation::adds<32>() or saturation::addu<32>().
+
+#ifndef SATURATION_STD_COMPAT_HPP
+#define SATURATION_STD_COMPAT_HPP
+
+#include <cassert>
+#include <climits>
+#include <limits>
+#include <type_traits>
+
+#include "saturation/add.hpp"
+#include "saturation/div.hpp"
+#include "saturation/mul.hpp"
+#include "saturation/sub.hpp"
+#include "saturation/types.hpp"
+
+namespace saturation {
+
+namespace details {
+
+/// True if \p T is one of the types accepted by the standard saturation
+/// functions: a signed or unsigned integer type other than bool or a
+/// character type, whose width is supported by this library.
+template <typename T>
+struct is_sat_integer
+    : std::bool_constant<
+          std::is_integral_v<T> && !std::is_same_v<T, bool> &&
+          !std::is_same_v<T, char> && !std::is_same_v<T, wchar_t> &&
+#ifdef __cpp_char8_t
+          !std::is_same_v<T, char8_t> &&
+#endif  // __cpp_char8_t
+          !std::is_same_v<T, char16_t> && !std::is_same_v<T, char32_t> &&
+          sizeof (T) * CHAR_BIT <= max_width> {};
+template <typename T>
+inline constexpr bool is_sat_integer_v =
+    is_sat_integer<std::remove_cv_t<T>>::value;
+
+/// The number of bits in a value of type \p T.
+template <typename T>
+inline constexpr auto bits_v = sizeof (T) * CHAR_BIT;
+
+}  // end namespace details
+
+/// \name Standard Library Compatible Operations
+/// Saturating arithmetic with the signatures of the C++26 standard library.
+/// The width and signedness of each operation are taken from the argument
+/// type \p T.
+/// @{
+
+/// \brief Computes \p x + \p y, saturating at the limits of \p T.
+template <typename T, typename = std::enable_if_t<details::is_sat_integer_v<T>>>
+constexpr T add_sat (T const x, T const y) noexcept {
+  constexpr auto n = details::bits_v<T>;
+  if constexpr (std::is_signed_v<T>) {
+    return static_cast<T> (adds<n> (x, y));
+  } else {
+    return static_cast<T> (addu<n> (x, y));
+  }
+}
+/// \brief Computes \p x - \p y, saturating at the limits of \p T.
+template <typename T, typename = std::enable_if_t<details::is_sat_integer_v<T>>>
+constexpr T sub_sat (T const x, T const y) noexcept {
+  constexpr auto n = details::bits_v<T>;
+  if constexpr (std::is_signed_v<T>) {
+    return static_cast<T> (subs<n> (x, y));
+  } else {
+    return static_cast<T> (subu<n> (x, y));
+  }
+}
+/// \brief Computes \p x &times; \p y, saturating at the limits of \p T.
+template <typename T, typename = std::enable_if_t<details::is_sat_integer_v<T>>>
+constexpr T mul_sat (T const x, T const y) noexcept {
+  constexpr auto n = details::bits_v<T>;
+  if constexpr (std::is_signed_v<T>) {
+    return static_cast<T> (muls<n> (x, y));
+  } else {
+    return static_cast<T> (mulu<n> (x, y));
+  }
+}
+/// \brief Computes \p x / \p y, saturating at the limits of \p T.
+///
+/// Only the division of the most negative value of a signed type by -1 can
+/// overflow. \p y must not be zero.
+template <typename T, typename = std::enable_if_t<details::is_sat_integer_v<T>>>
+constexpr T div_sat (T const x, T const y) noexcept {
+  assert (y != 0);  // div_sat<> divisor must not be zero
+  constexpr auto n = details::bits_v<T>;
+  if constexpr (std::is_signed_v<T>) {
+    return static_cast<T> (divs<n> (x, y));
+  } else {
+    return static_cast<T> (divu<n> (x, y));
+  }
+}
+
+/// \brief Converts \p x to type \p R, clamping it to the range of \p R.
+///
+/// \tparam R  The result type.
+/// \tparam T  The argument type.
+/// \param x  The value to be converted.
+/// \returns  \p x if it can be represented by \p R; otherwise the largest or
+///   smallest value of \p R.
+template <typename R, typename T,
+          typename = std::enable_if_t<details::is_sat_integer_v<R> &&
+                                      details::is_sat_integer_v<T>>>
+constexpr R saturate_cast (T const x) noexcept {
+  using rlimits = std::numeric_limits<R>;
+  using tlimits = std::numeric_limits<T>;
+  if constexpr (std::is_signed_v<T> == std::is_signed_v<R>) {
+    if constexpr (tlimits::digits <= rlimits::digits) {
+      return static_cast<R> (x);
+    } else {
+      // T is the wider type so the limits of R can be converted to it.
+      constexpr auto max = static_cast<T> (rlimits::max ());
+      constexpr auto min = static_cast<T> (rlimits::min ());
+      return static_cast<R> (x > max ? max : (x < min ? min : x));
+    }
+  } else if constexpr (std::is_signed_v<T>) {
+    // Signed to unsigned: negative values clamp to zero; the positive range
+    // is compared as unsigned.
+    if (x < 0) {
+      return R{0};
+    }
+    if constexpr (tlimits::digits > rlimits::digits) {
+      if (static_cast<std::make_unsigned_t<T>> (x) > rlimits::max ()) {
+        return rlimits::max ();
+      }
+    }
+    return static_cast<R> (x);
+  } else {
+    // Unsigned to signed: only the maximum can be exceeded.
+    if constexpr (tlimits::digits > rlimits::digits) {
+      if (x > static_cast<std::make_unsigned_t<R>> (rlimits::max ())) {
+        return rlimits::max ();
+      }
+    }
+    return static_cast<R> (x);
+  }
+}
+/// @}
+
+}  // end namespace saturation
+
+#endif  // SATURATION_STD_COMPAT_HPP
@@ -11,28 +11,64 @@ namespace saturation {
 // ~~~~
 /// \name Unsigned Subtraction
 /// Functions that perform saturating subtraction of unsigned integral
-/// quantities from 4 to 64 bits.
+/// quantities from 4 to 64 bits (128 bits if HAVE_INT128 is enabled).
 /// @{
 
+#if SATURATION_BUILTIN_OVERFLOW
+namespace details {
+
+/// An implementation of saturating unsigned subtract for register-sized
+/// values of \p N which the compiler recognizes as an overflow check (and,
+/// in a loop, can vectorize).
+template <size_t N>
+constexpr uinteger_t<N> subu_builtin (uinteger_t<N> const x,
+                                      uinteger_t<N> const y) {
+  auto const res = static_cast<uinteger_t<N>> (x - y);
+  // The difference wrapped if it is greater than x.
+  return res > x ? uinteger_t<N>{0} : res;
+}
+
+}  // end namespace details
+#endif  // SATURATION_BUILTIN_OVERFLOW
+
+namespace details {
+
+/// The portable implementation of subu<N>(). It is also used to constant
+/// evaluate those widths for which subu<N>() is specialized.
+template <size_t N>
+constexpr uinteger_t<N> subu_generic (uinteger_t<N> const x,
+                                      uinteger_t<N> const y) {
+  constexpr auto maxu = mask_v<N>;
+  uinteger_t<N> res = x - y;
+  res &= -(res <= x);
+  res &= maxu;
+  return res;
+}
+
+}  // end namespace details
+
 /// Computes the result of \p x - \p y. If the result overflows --- that is, the
 /// result is too large to be representable with an unsigned integer of
 /// \p N bits --- the returned value is \f$ 2^N-1 \f$.
 ///
 /// \tparam N The number of bits for the unsigned arguments and result. May
-///   be in the range \f$ [4, 64] \f$.
+///   be in the range \f$ [4, 64] \f$ (\f$ [4, 128] \f$ if HAVE_INT128 is
+///   enabled).
 /// \param x  The value from which \p y is deducted.
 /// \param y  The value deducted from \p x.
 /// \returns  \p x - \p y. If the result would be too large,
 ///   \f$ 2^N-1 \f$ (saturation::limits<N>::max()).
-template <size_t N, typename = typename std::enable_if_t<(N >= 4 && N <= 64)>>
+template <size_t N,
+          typename = typename std::enable_if_t<(N >= 4 && N <= max_width)>>
 constexpr uinteger_t<N> subu (uinteger_t<N> const x, uinteger_t<N> const y) {
   assert (x <= ulimits<N>::max ());  // subu<> x value out of range
   assert (y <= ulimits<N>::max ());  // subu<> y value out of range
-  constexpr auto maxu = mask_v<N>;
-  uinteger_t<N> res = x - y;
-  res &= -(res <= x);
-  res &= maxu;
-  return res;
+#if SATURATION_BUILTIN_OVERFLOW
+  if constexpr (details::is_register_width (N) && N <= 64) {
+    return details::subu_builtin<N> (x, y);
+  }
+#endif  // SATURATION_BUILTIN_OVERFLOW
+  return details::subu_generic<N> (x, y);
 }
 #ifndef NO_INLINE_ASM
 #if defined(__GNUC__) && defined(__x86_64__)
@@ -67,23 +103,71 @@ inline uinteger_t<N> subu_asm (uinteger_t<N> x, uinteger_t<N> y) {
   return x;
 }
 
+#if HAVE_INT128
+/// An x86-only implementation of saturating unsigned subtract for 128 bit
+/// values. The 64 bit halves are subtracted with sub and sbb so that the
+/// final borrow reports overflow of the full value.
+///
+/// \param x  The value from which \p y is deducted.
+/// \param y  The value deducted from \p x.
+/// \result  \p x - \p y or 0 if the result would be negative.
+inline uinteger_t<128> subu_asm128 (uinteger_t<128> const x,
+                                    uinteger_t<128> const y) {
+  auto const yl = static_cast<uint64_t> (y);
+  auto const yh = static_cast<uint64_t> (y >> 64U);
+  auto lo = static_cast<uint64_t> (x);
+  auto hi = static_cast<uint64_t> (x >> 64U);
+  uint64_t t;
+  __asm__(
+      "sub {%[yl],%[lo] | %[lo],%[yl]}\n\t"         // lo -= yl (sets borrow C)
+      "sbb {%[yh],%[hi] | %[hi],%[yh]}\n\t"         // hi -= yh + C (sets C)
+      "sbb %[t],%[t]"                               // t = 0 or ~0 from C.
+      : [lo] "+&r"(lo), [hi] "+&r"(hi), [t] "=&r"(t)  // output
+      : [yl] "r"(yl), [yh] "r"(yh)                    // input
+      : "cc"                                          // clobber
+  );
+  return uinteger_t<128>{hi & ~t} << 64U | (lo & ~t);
+}
+#endif  // HAVE_INT128
+
 }  // end namespace details
 
+#if !SATURATION_BUILTIN_OVERFLOW
 template <>
-inline uinteger_t<16> subu<16, std::enable_if_t<true>> (
+SATURATION_ASM_CONSTEXPR uinteger_t<16> subu<16, std::enable_if_t<true>> (
     uinteger_t<16> const x, uinteger_t<16> const y) {
+  if (details::is_constant_evaluated ()) {
+    return details::subu_generic<16> (x, y);
+  }
   return details::subu_asm<16> (x, y);
 }
 template <>
-inline uinteger_t<32> subu<32, std::enable_if_t<true>> (
+SATURATION_ASM_CONSTEXPR uinteger_t<32> subu<32, std::enable_if_t<true>> (
     uinteger_t<32> const x, uinteger_t<32> const y) {
+  if (details::is_constant_evaluated ()) {
+    return details::subu_generic<32> (x, y);
+  }
   return details::subu_asm<32> (x, y);
 }
+#endif  // !SATURATION_BUILTIN_OVERFLOW
 template <>
-inline uinteger_t<64> subu<64, std::enable_if_t<true>> (
+SATURATION_ASM_CONSTEXPR uinteger_t<64> subu<64, std::enable_if_t<true>> (
     uinteger_t<64> const x, uinteger_t<64> const y) {
+  if (details::is_constant_evaluated ()) {
+    return details::subu_generic<64> (x, y);
+  }
   return details::subu_asm<64> (x, y);
 }
+#if HAVE_INT128
+template <>
+SATURATION_ASM_CONSTEXPR uinteger_t<128> subu<128, std::enable_if_t<true>> (
+    uinteger_t<128> const x, uinteger_t<128> const y) {
+  if (details::is_constant_evaluated ()) {
+    return details::subu_generic<128> (x, y);
+  }
+  return details::subu_asm128 (x, y);
+}
+#endif  // HAVE_INT128
 #endif  // __GNUC__ && __x86_64__
 #endif  // NO_INLINE_ASM
 
@@ -96,7 +180,7 @@ inline uinteger_t<64> subu<64, std::enable_if_t<true>> (
 /// \param y  The 32 bit unsigned value deducted from \p x.
 /// \returns  \p x - \p y. If the result would be too large,
 ///   \f$ 2^{32}-1 \f$ (`std::numeric_limits<uint32_t>::max()`).
-inline uint32_t subu32 (uint32_t const x, uint32_t const y) {
+SATURATION_ASM_CONSTEXPR uint32_t subu32 (uint32_t const x, uint32_t const y) {
   return subu<32> (x, y);
 }
 /// \brief Computes the 16 bit unsigned result of \p x - \p y.
@@ -108,7 +192,7 @@ inline uint32_t subu32 (uint32_t const x, uint32_t const y) {
 /// \param y  The 16 bit unsigned value deducted from \p x.
 /// \returns  \p x - \p y. If the result would be too large,
 ///   \f$ 2^{16}-1 \f$ (`std::numeric_limits<uint16_t>::max()`).
-inline uint16_t subu16 (uint16_t const x, uint16_t const y) {
+SATURATION_ASM_CONSTEXPR uint16_t subu16 (uint16_t const x, uint16_t const y) {
   return subu<16> (x, y);
 }
 /// \brief Computes the 8 bit unsigned result of \p x - \p y.
@@ -120,7 +204,7 @@ inline uint16_t subu16 (uint16_t const x, uint16_t const y) {
 /// \param y  The 8 bit unsigned value deducted from \p x.
 /// \returns  \p x - \p y. If the result would be too large,
 ///   \f$ 2^{8}-1 \f$ (`std::numeric_limits<uint8_t>::max()`).
-inline uint8_t subu8 (uint8_t const x, uint8_t const y) {
+SATURATION_ASM_CONSTEXPR uint8_t subu8 (uint8_t const x, uint8_t const y) {
   return subu<8> (x, y);
 }
 /// @}
@@ -129,28 +213,42 @@ inline uint8_t subu8 (uint8_t const x, uint8_t const y) {
 // ~~~~
 /// \name Signed Subtraction
 /// Functions that perform saturating subtraction of signed integral
-/// quantities from 4 to 64 bits.
+/// quantities from 4 to 64 bits (128 bits if HAVE_INT128 is enabled).
 /// @{
 
-/// \brief Computes the signed result of \p x - \p y.
-///
-/// If the result overflows --- that is, the result is either too large or too
-/// small to be representable with a twos-complement integer of \p N bits
-/// --- the result is \f$ 2^{N-1}-1 \f$ or \f$ -2^{N-1} \f$ respectively.
-///
-/// \tparam N  The number of bits for the twos complement arguments and
-///   result. May be in the range \f$ [4, 64] \f$.
-/// \param x  The value from which \p y is deducted.
-/// \param y  The value deducted from \p x.
-/// \returns  \p x - \p y. If the result would be too small, \f$ -2^{N-1} \f$
-///   (saturation::slimits<N>::min()); if the result would be too large,
-///   \f$ 2^{N-1}-1 \f$ (saturation::slimits<N>::max()).
-template <size_t N, typename = typename std::enable_if_t<(N >= 4 && N <= 64)>>
-constexpr sinteger_t<N> subs (sinteger_t<N> const x, sinteger_t<N> const y) {
-  assert (x >= slimits<N>::min () &&
-          x <= slimits<N>::max ());  // subs<> x value out of range
-  assert (y >= slimits<N>::min () &&
-          y <= slimits<N>::max ());  // subs<> y value out of range
+#if SATURATION_BUILTIN_OVERFLOW
+namespace details {
+
+/// An implementation of saturating signed subtract for register-sized values
+/// of \p N which the compiler recognizes as an overflow check (and, in a
+/// loop, can vectorize).
+template <size_t N>
+constexpr sinteger_t<N> subs_builtin (sinteger_t<N> const x,
+                                      sinteger_t<N> const y) {
+  using uint = uinteger_t<N>;
+  using sint = sinteger_t<N>;
+  auto const ux = static_cast<uint> (x);
+  auto const uy = static_cast<uint> (y);
+  auto const res = static_cast<uint> (ux - uy);
+  // Overflow if x and y have different signs and the sign of res differs
+  // from that of x.
+  auto const overflow = static_cast<sint> ((ux ^ uy) & (ux ^ res)) < 0;
+  // The saturated value takes the sign of x.
+  auto const v = static_cast<sint> ((ux >> (N - 1U)) +
+                                    static_cast<uint> (slimits<N>::max ()));
+  return overflow ? v : static_cast<sint> (res);
+}
+
+}  // end namespace details
+#endif  // SATURATION_BUILTIN_OVERFLOW
+
+namespace details {
+
+/// The portable implementation of subs<N>(). It is also used to constant
+/// evaluate those widths for which subs<N>() is specialized.
+template <size_t N>
+constexpr sinteger_t<N> subs_generic (sinteger_t<N> const x,
+                                      sinteger_t<N> const y) {
   using uint = uinteger_t<N>;
   using sint = sinteger_t<N>;
   using ubits = details::nbit_scalar<N, true>;
@@ -174,6 +272,89 @@ constexpr sinteger_t<N> subs (sinteger_t<N> const x, sinteger_t<N> const y) {
   // There was no overflow: return the proper result.
   return sbits{static_cast<sint> (res)};
 }
+
+}  // end namespace details
+
+/// \brief Computes the signed result of \p x - \p y.
+///
+/// If the result overflows --- that is, the result is either too large or too
+/// small to be representable with a twos-complement integer of \p N bits
+/// --- the result is \f$ 2^{N-1}-1 \f$ or \f$ -2^{N-1} \f$ respectively.
+///
+/// \tparam N  The number of bits for the twos complement arguments and
+///   result. May be in the range \f$ [4, 64] \f$ (\f$ [4, 128] \f$ if
+///   HAVE_INT128 is enabled).
+/// \param x  The value from which \p y is deducted.
+/// \param y  The value deducted from \p x.
+/// \returns  \p x - \p y. If the result would be too small, \f$ -2^{N-1} \f$
+///   (saturation::slimits<N>::min()); if the result would be too large,
+///   \f$ 2^{N-1}-1 \f$ (saturation::slimits<N>::max()).
+template <size_t N,
+          typename = typename std::enable_if_t<(N >= 4 && N <= max_width)>>
+constexpr sinteger_t<N> subs (sinteger_t<N> const x, sinteger_t<N> const y) {
+  assert (x >= slimits<N>::min () &&
+          x <= slimits<N>::max ());  // subs<> x value out of range
+  assert (y >= slimits<N>::min () &&
+          y <= slimits<N>::max ());  // subs<> y value out of range
+#if SATURATION_BUILTIN_OVERFLOW
+  if constexpr (details::is_register_width (N) && N <= 64) {
+    return details::subs_builtin<N> (x, y);
+  }
+#endif  // SATURATION_BUILTIN_OVERFLOW
+  return details::subs_generic<N> (x, y);
+}
+
+#ifndef NO_INLINE_ASM
+#if defined(__GNUC__) && defined(__x86_64__) && HAVE_INT128
+namespace details {
+
+/// An x86-only implementation of saturating signed subtract for 128 bit
+/// values. The 64 bit halves are subtracted with sub and sbb. The overflow
+/// flag from the second applies to the full value and selects both halves of
+/// the saturated result.
+///
+/// \param x  The value from which \p y is deducted.
+/// \param y  The value deducted from \p x.
+/// \result  \p x - \p y or \f$ 2^{127}-1 \f$ if the result is positive but
+///   cannot be represented in 128 bits; \f$ -2^{127} \f$ if the result is
+///   negative but cannot be represented in 128 bits.
+inline sinteger_t<128> subs_asm128 (sinteger_t<128> const x,
+                                    sinteger_t<128> const y) {
+  using u128 = uinteger_t<128>;
+  // The saturated result has the sign of x.
+  auto const v = static_cast<u128> ((static_cast<u128> (x) >> 127U) +
+                                    static_cast<u128> (slimits<128>::max ()));
+  auto const yl = static_cast<uint64_t> (y);
+  auto const yh = static_cast<uint64_t> (static_cast<u128> (y) >> 64U);
+  auto const vl = static_cast<uint64_t> (v);
+  auto const vh = static_cast<uint64_t> (v >> 64U);
+  auto lo = static_cast<uint64_t> (x);
+  auto hi = static_cast<uint64_t> (static_cast<u128> (x) >> 64U);
+  __asm__(
+      "sub   {%[yl],%[lo] | %[lo],%[yl]}\n\t"  // lo -= yl (sets borrow C)
+      "sbb   {%[yh],%[hi] | %[hi],%[yh]}\n\t"  // hi -= yh + C (sets O)
+      "cmovo {%[vl],%[lo] | %[lo],%[vl]}\n\t"  // if O, lo = vl
+      "cmovo {%[vh],%[hi] | %[hi],%[vh]}"      // if O, hi = vh
+      : [lo] "+&r"(lo), [hi] "+&r"(hi)         // output
+      : [yl] "r"(yl), [yh] "r"(yh), [vl] "r"(vl), [vh] "r"(vh)  // input
+      : "cc"                                                    // clobber
+  );
+  return static_cast<sinteger_t<128>> (u128{hi} << 64U | lo);
+}
+
+}  // end namespace details
+
+template <>
+SATURATION_ASM_CONSTEXPR sinteger_t<128> subs<128, std::enable_if_t<true>> (
+    sinteger_t<128> const x, sinteger_t<128> const y) {
+  if (details::is_constant_evaluated ()) {
+    return details::subs_generic<128> (x, y);
+  }
+  return details::subs_asm128 (x, y);
+}
+#endif  // __GNUC__ && __x86_64__ && HAVE_INT128
+#endif  // NO_INLINE_ASM
+
 /// \brief Computes the 32 bit signed result of \p x - \p y.
 ///
 /// If the result overflows --- that is, the result is either too large or too
@@ -218,6 +399,181 @@ constexpr int8_t subs8 (int8_t const x, int8_t const y) {
 }
 /// @}
 
+/// \name Subtraction with Overflow Reporting
+/// Functions that perform saturating subtraction and also report whether the
+/// result was clamped. The report is the condition which the saturating
+/// functions test internally: the carry (borrow) or overflow flag of the
+/// subtraction where inline assembler or the compiler's overflow builtins
+/// are used.
+/// @{
+
+namespace details {
+
+/// Calculates the value to which signed subtraction saturates: max or min
+/// depending on the sign of x.
+template <size_t N>
+constexpr sinteger_t<N> subs_overflow_value (sinteger_t<N> const x) {
+  using uint = uinteger_t<N>;
+  return static_cast<sinteger_t<N>> (
+      static_cast<uint> (static_cast<uint> (x) >> (N - 1U)) +
+      static_cast<uint> (slimits<N>::max ()));
+}
+
+/// The portable implementation of subu_ovf<N>().
+template <size_t N>
+constexpr ovf_result<uinteger_t<N>> subu_ovf_generic (uinteger_t<N> const x,
+                                                      uinteger_t<N> const y) {
+  if (y > x) {
+    return {uinteger_t<N>{0}, true};
+  }
+  return {static_cast<uinteger_t<N>> (x - y), false};
+}
+/// The portable implementation of subs_ovf<N>().
+template <size_t N>
+constexpr ovf_result<sinteger_t<N>> subs_ovf_generic (sinteger_t<N> const x,
+                                                      sinteger_t<N> const y) {
+  using uint = uinteger_t<N>;
+  using sint = sinteger_t<N>;
+  if constexpr (N < sizeof (sint) * CHAR_BIT) {
+    // The difference is exact in the wider type.
+    auto const res = static_cast<sint> (x - y);
+    if (res > slimits<N>::max ()) {
+      return {slimits<N>::max (), true};
+    }
+    if (res < slimits<N>::min ()) {
+      return {slimits<N>::min (), true};
+    }
+    return {res, false};
+  } else {
+    auto const ux = static_cast<uint> (x);
+    auto const uy = static_cast<uint> (y);
+    auto const res = static_cast<uint> (ux - uy);
+    // Overflow if x and y have different signs and the sign of res differs
+    // from that of x.
+    bool const saturated = static_cast<sint> ((ux ^ uy) & (ux ^ res)) < 0;
+    return {saturated ? subs_overflow_value<N> (x) : static_cast<sint> (res),
+            saturated};
+  }
+}
+
+#if SATURATION_BUILTIN_OVERFLOW
+/// An implementation of subu_ovf<N>() for register-sized values of \p N.
+template <size_t N>
+constexpr ovf_result<uinteger_t<N>> subu_ovf_builtin (uinteger_t<N> const x,
+                                                      uinteger_t<N> const y) {
+  uinteger_t<N> res = 0;
+  bool const saturated = __builtin_sub_overflow (x, y, &res);
+  return {saturated ? uinteger_t<N>{0} : res, saturated};
+}
+/// An implementation of subs_ovf<N>() for register-sized values of \p N.
+template <size_t N>
+constexpr ovf_result<sinteger_t<N>> subs_ovf_builtin (sinteger_t<N> const x,
+                                                      sinteger_t<N> const y) {
+  sinteger_t<N> res = 0;
+  bool const saturated = __builtin_sub_overflow (x, y, &res);
+  return {saturated ? subs_overflow_value<N> (x) : res, saturated};
+}
+#endif  // SATURATION_BUILTIN_OVERFLOW
+
+#if SATURATION_ASM_FLAG_OUTPUTS
+/// An x86-only implementation of subu_ovf<N>() for register-sized values of
+/// \p N of at least 16 bits. As subu_asm<N>() but the carry flag is also
+/// returned.
+template <size_t N>
+inline ovf_result<uinteger_t<N>> subu_ovf_asm (uinteger_t<N> x,
+                                               uinteger_t<N> const y) {
+  uinteger_t<N> const t = 0;
+  bool carry;
+  __asm__(
+      "sub   {%[y],%[x] | %[x],%[y]}\n\t"  // x -= y (sets carry C on overflow)
+      "cmovc {%[t],%[x] | %[x],%[t]}"      // if C, x = 0.
+      : [x] "+&r"(x), [c] "=@ccc"(carry)   // output
+      : [y] "r"(y), [t] "r"(t)             // input
+  );
+  return {x, carry};
+}
+/// An x86-only implementation of subs_ovf<N>() for register-sized values of
+/// \p N of at least 16 bits. The overflow flag of the subtraction selects the
+/// saturated value and is also returned.
+template <size_t N>
+inline ovf_result<sinteger_t<N>> subs_ovf_asm (sinteger_t<N> x,
+                                               sinteger_t<N> const y) {
+  sinteger_t<N> const v = subs_overflow_value<N> (x);
+  bool overflow;
+  __asm__(
+      "sub   {%[y],%[x] | %[x],%[y]}\n\t"  // x -= y (sets O on overflow)
+      "cmovo {%[v],%[x] | %[x],%[v]}"      // if O, x = v
+      : [x] "+&r"(x), [o] "=@cco"(overflow)  // output
+      : [y] "r"(y), [v] "r"(v)               // input
+  );
+  return {x, overflow};
+}
+#endif  // SATURATION_ASM_FLAG_OUTPUTS
+
+}  // end namespace details
+
+/// \brief Subtracts two unsigned values each \p N bits wide and reports
+///   whether the result saturated.
+///
+/// \tparam N  The number of bits for the unsigned arguments and result. May
+///   be in the range \f$ [4, 64] \f$ (\f$ [4, 128] \f$ if HAVE_INT128 is
+///   enabled).
+/// \param x  The value from which \p y is deducted.
+/// \param y  The value deducted from \p x.
+/// \result  The value subu<N>(\p x, \p y) and true if \p y is greater than
+///   \p x.
+template <size_t N,
+          typename = typename std::enable_if_t<(N >= 4 && N <= max_width)>>
+constexpr ovf_result<uinteger_t<N>> subu_ovf (uinteger_t<N> const x,
+                                              uinteger_t<N> const y) {
+  assert (x <= ulimits<N>::max ());  // subu_ovf<> x value out of range
+  assert (y <= ulimits<N>::max ());  // subu_ovf<> y value out of range
+#if SATURATION_BUILTIN_OVERFLOW
+  if constexpr (details::is_register_width (N) && N <= 64) {
+    return details::subu_ovf_builtin<N> (x, y);
+  }
+#elif SATURATION_ASM_FLAG_OUTPUTS
+  if constexpr (details::is_register_width (N) && N >= 16 && N <= 64) {
+    if (!details::is_constant_evaluated ()) {
+      return details::subu_ovf_asm<N> (x, y);
+    }
+  }
+#endif  // SATURATION_BUILTIN_OVERFLOW
+  return details::subu_ovf_generic<N> (x, y);
+}
+/// \brief Subtracts two signed values each \p N bits wide and reports
+///   whether the result saturated.
+///
+/// \tparam N  The number of bits for the signed arguments and result. May be
+///   in the range \f$ [4, 64] \f$ (\f$ [4, 128] \f$ if HAVE_INT128 is
+///   enabled).
+/// \param x  The value from which \p y is deducted.
+/// \param y  The value deducted from \p x.
+/// \result  The value subs<N>(\p x, \p y) and true if \p x - \p y could not
+///   be represented in \p N bits.
+template <size_t N,
+          typename = typename std::enable_if_t<(N >= 4 && N <= max_width)>>
+constexpr ovf_result<sinteger_t<N>> subs_ovf (sinteger_t<N> const x,
+                                              sinteger_t<N> const y) {
+  assert (x >= slimits<N>::min () &&
+          x <= slimits<N>::max ());  // subs_ovf<> x value out of range
+  assert (y >= slimits<N>::min () &&
+          y <= slimits<N>::max ());  // subs_ovf<> y value out of range
+#if SATURATION_BUILTIN_OVERFLOW
+  if constexpr (details::is_register_width (N) && N <= 64) {
+    return details::subs_ovf_builtin<N> (x, y);
+  }
+#elif SATURATION_ASM_FLAG_OUTPUTS
+  if constexpr (details::is_register_width (N) && N >= 16 && N <= 64) {
+    if (!details::is_constant_evaluated ()) {
+      return details::subs_ovf_asm<N> (x, y);
+    }
+  }
+#endif  // SATURATION_BUILTIN_OVERFLOW
+  return details::subs_ovf_generic<N> (x, y);
+}
+/// @}
+
 }  // end namespace saturation
 
 #endif  // SATURATION_SUB_HPP
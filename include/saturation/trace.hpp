@@ -0,0 +1,440 @@
+/// \file trace.hpp
+/// \brief Opt-in recording of the places at which saturating arithmetic
+/// clamps its result.
+///
+/// The functions in the traced namespace have the same names and arguments
+/// as the saturating functions addu<N>(), adds<N>(), subu<N>(), subs<N>(),
+/// mulu<N>(), and muls<N>():
+///
+///     auto const y = traced::adds<16> (traced::muls<16> (x, gain), offset);
+///
+/// If the macro SATURATION_TRACE is defined, each call whose result is
+/// clamped is counted against its operation, width, and source location. If
+/// it is not defined, the traced functions are the saturating functions
+/// themselves so that tracing costs nothing. The macro must have the same
+/// setting in every translation unit of a program.
+///
+/// Events are first counted in a small table belonging to the calling
+/// thread. The table is merged into a process-wide registry when it fills,
+/// when the thread exits, and when trace::flush() is called (which a
+/// long-lived thread should do from time to time). The registry is a
+/// fixed-size hash table whose slots are claimed and counted with atomic
+/// operations: no locks are taken. Its contents are reported by
+/// trace::snapshot(), trace::dump_text(), and trace::dump_json().
+
+#ifndef SATURATION_TRACE_HPP
+#define SATURATION_TRACE_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <type_traits>
+#include <vector>
+
+#include "saturation/add.hpp"
+#include "saturation/mul.hpp"
+#include "saturation/sub.hpp"
+#include "saturation/types.hpp"
+
+namespace saturation {
+
+namespace trace {
+
+/// The operations which may be traced.
+enum class op {
+  addu,
+  adds,
+  subu,
+  subs,
+  mulu,
+  muls,
+};
+
+/// Returns the name of an operation.
+constexpr char const* to_string (op const o) noexcept {
+  switch (o) {
+  case op::addu: return "addu";
+  case op::adds: return "adds";
+  case op::subu: return "subu";
+  case op::subs: return "subs";
+  case op::mulu: return "mulu";
+  case op::muls: return "muls";
+  }
+  return "unknown";
+}
+
+/// A position in the source code.
+struct location {
+  char const* file = "";
+  char const* function = "";
+  unsigned line = 0;
+
+  /// Returns the location of the expression which calls this function or, if
+  /// called from a default argument, of the call which uses that argument.
+  static constexpr location current (
+      char const* const file = __builtin_FILE (),
+      char const* const function = __builtin_FUNCTION (),
+      int const line = __builtin_LINE ()) noexcept {
+    return {file, function, static_cast<unsigned> (line)};
+  }
+};
+
+/// The number of times that one operation at one source location saturated.
+struct record {
+  op operation = op::addu;
+  size_t bits = 0;
+  location where;
+  uint64_t count = 0;
+};
+
+}  // end namespace trace
+
+namespace details {
+
+/// True if \p x and \p y record the same operation and width at the same
+/// source location.
+inline bool same_trace_site (trace::record const& x,
+                             trace::record const& y) noexcept {
+  return x.operation == y.operation && x.bits == y.bits &&
+         x.where.line == y.where.line &&
+         std::strcmp (x.where.file, y.where.file) == 0 &&
+         std::strcmp (x.where.function, y.where.function) == 0;
+}
+
+/// \brief The process-wide table of saturation counts.
+///
+/// Slots are found by open addressing. A thread adding a new site claims an
+/// empty slot with a compare-and-swap, fills it in, then publishes it. A
+/// thread which meets a slot that is still being filled in does not wait but
+/// moves on to the next, so the same site may (rarely) occupy two slots:
+/// snapshot() merges them.
+class trace_registry {
+public:
+  static constexpr auto capacity = size_t{1024};
+
+  /// Adds \p r.count events to the site described by \p r.
+  void add (trace::record const& r) noexcept {
+    auto const h = hash (r);
+    for (auto probe = size_t{0}; probe < capacity; ++probe) {
+      auto& s = slots_[(h + probe) % capacity];
+      auto state = s.state.load (std::memory_order_acquire);
+      if (state == empty) {
+        if (s.state.compare_exchange_strong (state, claimed,
+                                             std::memory_order_acquire)) {
+          s.site = r;
+          s.count.fetch_add (r.count, std::memory_order_relaxed);
+          s.state.store (ready, std::memory_order_release);
+          return;
+        }
+      }
+      if (state == ready && same_trace_site (s.site, r)) {
+        s.count.fetch_add (r.count, std::memory_order_relaxed);
+        return;
+      }
+    }
+    dropped_.fetch_add (r.count, std::memory_order_relaxed);
+  }
+
+  /// Returns the sites with a non-zero count, in descending order of count.
+  std::vector<trace::record> snapshot () const {
+    std::vector<trace::record> result;
+    for (auto const& s : slots_) {
+      if (s.state.load (std::memory_order_acquire) != ready) {
+        continue;
+      }
+      auto r = s.site;
+      r.count = s.count.load (std::memory_order_relaxed);
+      auto const pos = std::find_if (
+          result.begin (), result.end (),
+          [&r] (trace::record const& x) { return same_trace_site (x, r); });
+      if (pos != result.end ()) {
+        pos->count += r.count;
+      } else if (r.count > 0U) {
+        result.push_back (r);
+      }
+    }
+    std::sort (result.begin (), result.end (),
+               [] (trace::record const& x, trace::record const& y) {
+                 return x.count > y.count;
+               });
+    return result;
+  }
+
+  /// Returns the number of events which could not be recorded because every
+  /// slot was in use.
+  uint64_t dropped () const noexcept {
+    return dropped_.load (std::memory_order_relaxed);
+  }
+
+  /// Sets every count to zero. The sites remain in the table.
+  void reset () noexcept {
+    for (auto& s : slots_) {
+      s.count.store (0U, std::memory_order_relaxed);
+    }
+    dropped_.store (0U, std::memory_order_relaxed);
+  }
+
+private:
+  static constexpr unsigned empty = 0U;
+  static constexpr unsigned claimed = 1U;
+  static constexpr unsigned ready = 2U;
+
+  struct slot {
+    std::atomic<unsigned> state{empty};
+    /// The site. Written once, before the state becomes ready.
+    trace::record site;
+    std::atomic<uint64_t> count{0U};
+  };
+
+  /// Returns a hash of a site's contents. Identical file names at different
+  /// addresses (from different translation units) have the same hash.
+  static size_t hash (trace::record const& r) noexcept {
+    // FNV-1a.
+    auto h = uint64_t{0xCBF29CE484222325};
+    auto const mix = [&h] (uint64_t const v) {
+      h = (h ^ v) * uint64_t{0x100000001B3};
+    };
+    for (auto const* p = r.where.file; *p != '\0'; ++p) {
+      mix (static_cast<unsigned char> (*p));
+    }
+    mix (r.where.line);
+    mix (static_cast<uint64_t> (r.operation));
+    mix (r.bits);
+    return static_cast<size_t> (h);
+  }
+
+  std::array<slot, capacity> slots_;
+  std::atomic<uint64_t> dropped_{0U};
+};
+
+/// Returns the process-wide registry.
+inline trace_registry& global_trace_registry () noexcept {
+  static trace_registry registry;
+  return registry;
+}
+
+/// \brief The saturation counts of a single thread.
+///
+/// Sites are identified by the address of their file name so that counting
+/// an event does not need to compare strings.
+class trace_buffer {
+public:
+  static constexpr auto capacity = size_t{64};
+
+  trace_buffer () = default;
+  trace_buffer (trace_buffer const&) = delete;
+  trace_buffer& operator= (trace_buffer const&) = delete;
+  ~trace_buffer () noexcept { flush (); }
+
+  /// Counts an event for operation \p o on \p bits bit values at \p where.
+  void add (trace::op const o, size_t const bits,
+            trace::location const& where) noexcept {
+    auto const h = (reinterpret_cast<uintptr_t> (where.file) >> 3U) ^
+                   (uintptr_t{where.line} * 31U) ^
+                   (static_cast<uintptr_t> (o) << 8U) ^ bits;
+    for (;;) {
+      for (auto probe = size_t{0}; probe < capacity; ++probe) {
+        auto& e = entries_[(h + probe) % capacity];
+        if (e.count == 0U) {
+          e = trace::record{o, bits, where, 1U};
+          return;
+        }
+        if (e.where.file == where.file && e.where.line == where.line &&
+            e.operation == o && e.bits == bits) {
+          ++e.count;
+          return;
+        }
+      }
+      flush ();
+    }
+  }
+
+  /// Adds the counts to the global registry and empties the table.
+  void flush () noexcept {
+    auto& registry = global_trace_registry ();
+    for (auto& e : entries_) {
+      if (e.count > 0U) {
+        registry.add (e);
+        e.count = 0U;
+      }
+    }
+  }
+
+private:
+  std::array<trace::record, capacity> entries_{};
+};
+
+/// Returns the calling thread's table.
+inline trace_buffer& local_trace_buffer () noexcept {
+  static thread_local trace_buffer buffer;
+  return buffer;
+}
+
+/// Records the result \p r of operation \p Op on \p N bit values called
+/// from \p where.
+template <trace::op Op, size_t N, typename T>
+inline T traced (ovf_result<T> const& r, trace::location const& where) {
+  if (r.saturated) {
+    local_trace_buffer ().add (Op, N, where);
+  }
+  return r.value;
+}
+
+/// Writes \p str to \p os as a JSON string.
+inline void write_json_string (std::ostream& os, char const* str) {
+  os << '"';
+  for (; *str != '\0'; ++str) {
+    auto const c = static_cast<unsigned char> (*str);
+    if (c == '"' || c == '\\') {
+      os << '\\' << *str;
+    } else if (c < 0x20U) {
+      constexpr auto hex = "0123456789abcdef";
+      os << "\\u00" << hex[c >> 4U] << hex[c & 0xFU];
+    } else {
+      os << *str;
+    }
+  }
+  os << '"';
+}
+
+}  // end namespace details
+
+namespace trace {
+
+/// \name Trace Reporting
+/// Functions that report the saturation events recorded by the functions in
+/// the traced namespace. They are available whether or not SATURATION_TRACE
+/// is defined; without it, nothing is recorded.
+/// @{
+
+/// Merges the calling thread's counts into the process-wide registry.
+inline void flush () noexcept {
+  details::local_trace_buffer ().flush ();
+}
+
+/// Returns the number of events recorded for each site, in descending
+/// order of count. The calling thread's counts are flushed first; those of
+/// other threads are included only once they have been flushed.
+inline std::vector<record> snapshot () {
+  flush ();
+  return details::global_trace_registry ().snapshot ();
+}
+
+/// Returns the number of events which were discarded because the registry
+/// was full.
+inline uint64_t dropped () noexcept {
+  return details::global_trace_registry ().dropped ();
+}
+
+/// Discards the counts of the calling thread and the registry.
+inline void reset () noexcept {
+  flush ();
+  details::global_trace_registry ().reset ();
+}
+
+/// Writes the snapshot() to \p os as text, one line per site in the form
+/// "file:line: function: op<bits> saturated count times".
+inline void dump_text (std::ostream& os) {
+  for (auto const& r : snapshot ()) {
+    os << r.where.file << ':' << r.where.line << ": " << r.where.function
+       << ": " << to_string (r.operation) << '<' << r.bits << "> saturated "
+       << r.count << " times\n";
+  }
+  if (auto const d = dropped (); d > 0U) {
+    os << d << " events dropped\n";
+  }
+}
+
+/// Writes the snapshot() to \p os as a JSON object of the form
+/// {"sites":[{"op":"adds","bits":16,"file":"a.cpp","line":10,
+/// "function":"f","count":3}],"dropped":0}.
+inline void dump_json (std::ostream& os) {
+  os << "{\"sites\":[";
+  auto separator = "";
+  for (auto const& r : snapshot ()) {
+    os << separator << "{\"op\":\"" << to_string (r.operation)
+       << "\",\"bits\":" << r.bits << ",\"file\":";
+    details::write_json_string (os, r.where.file);
+    os << ",\"line\":" << r.where.line << ",\"function\":";
+    details::write_json_string (os, r.where.function);
+    os << ",\"count\":" << r.count << '}';
+    separator = ",";
+  }
+  os << "],\"dropped\":" << dropped () << "}\n";
+}
+/// @}
+
+}  // end namespace trace
+
+namespace traced {
+
+/// \name Traced Arithmetic
+/// The saturating functions, which also record the calls whose results are
+/// clamped if SATURATION_TRACE is defined.
+/// @{
+
+#ifdef SATURATION_TRACE
+
+template <size_t N,
+          typename = typename std::enable_if_t<(N >= 4 && N <= max_width)>>
+inline uinteger_t<N> addu (
+    uinteger_t<N> const x, uinteger_t<N> const y,
+    trace::location const& where = trace::location::current ()) {
+  return details::traced<trace::op::addu, N> (addu_ovf<N> (x, y), where);
+}
+template <size_t N,
+          typename = typename std::enable_if_t<(N >= 4 && N <= max_width)>>
+inline sinteger_t<N> adds (
+    sinteger_t<N> const x, sinteger_t<N> const y,
+    trace::location const& where = trace::location::current ()) {
+  return details::traced<trace::op::adds, N> (adds_ovf<N> (x, y), where);
+}
+template <size_t N,
+          typename = typename std::enable_if_t<(N >= 4 && N <= max_width)>>
+inline uinteger_t<N> subu (
+    uinteger_t<N> const x, uinteger_t<N> const y,
+    trace::location const& where = trace::location::current ()) {
+  return details::traced<trace::op::subu, N> (subu_ovf<N> (x, y), where);
+}
+template <size_t N,
+          typename = typename std::enable_if_t<(N >= 4 && N <= max_width)>>
+inline sinteger_t<N> subs (
+    sinteger_t<N> const x, sinteger_t<N> const y,
+    trace::location const& where = trace::location::current ()) {
+  return details::traced<trace::op::subs, N> (subs_ovf<N> (x, y), where);
+}
+template <size_t N,
+          typename = typename std::enable_if_t<(N >= 4 && N <= max_width)>>
+inline uinteger_t<N> mulu (
+    uinteger_t<N> const x, uinteger_t<N> const y,
+    trace::location const& where = trace::location::current ()) {
+  return details::traced<trace::op::mulu, N> (mulu_ovf<N> (x, y), where);
+}
+template <size_t N,
+          typename = typename std::enable_if_t<(N >= 4 && N <= max_width)>>
+inline sinteger_t<N> muls (
+    sinteger_t<N> const x, sinteger_t<N> const y,
+    trace::location const& where = trace::location::current ()) {
+  return details::traced<trace::op::muls, N> (muls_ovf<N> (x, y), where);
+}
+
+#else
+
+using ::saturation::adds;
+using ::saturation::addu;
+using ::saturation::muls;
+using ::saturation::mulu;
+using ::saturation::subs;
+using ::saturation::subu;
+
+#endif  // SATURATION_TRACE
+/// @}
+
+}  // end namespace traced
+
+}  // end namespace saturation
+
+#endif  // SATURATION_TRACE_HPP
@@ -12,6 +12,49 @@
 #define HAVE_INT128 0
 #endif
 
+// Register-sized operations are by default written with
+// __builtin_mul_overflow() and the compare-and-select idioms that compilers
+// recognize as overflow checks. Unlike inline assembler these are visible to
+// the optimizer so they can be constant folded, scheduled, and vectorized.
+// The 64 and 128 bit inline assembler versions are still preferred where they
+// are available since loops over those widths rarely vectorize and the
+// assembler is then slightly faster. Define NO_BUILTIN_OVERFLOW to use the
+// inline assembler (or, with NO_INLINE_ASM, the portable) implementations
+// for every width.
+#ifndef NO_BUILTIN_OVERFLOW
+#if defined(__GNUC__) || defined(__clang__)
+#define SATURATION_BUILTIN_OVERFLOW 1
+#endif
+#endif  // NO_BUILTIN_OVERFLOW
+#ifndef SATURATION_BUILTIN_OVERFLOW
+#define SATURATION_BUILTIN_OVERFLOW 0
+#endif
+
+// C++20's std::is_constant_evaluated() allows the functions implemented with
+// inline assembler to be constexpr: during constant evaluation they use the
+// portable implementations instead. SATURATION_ASM_CONSTEXPR is the specifier
+// for those functions. Before C++20 it is plain inline. Then an operation can
+// be constant evaluated only if the inline assembler is not used for it: with
+// NO_INLINE_ASM, on compilers or targets without the assembler, or (for the
+// 8, 16 and 32 bit widths) when SATURATION_BUILTIN_OVERFLOW is set.
+#if defined(__cpp_lib_is_constant_evaluated) && __cpp_constexpr >= 201907L
+#define SATURATION_HAVE_CONSTEXPR_ASM 1
+#define SATURATION_ASM_CONSTEXPR constexpr
+#else
+#define SATURATION_HAVE_CONSTEXPR_ASM 0
+#define SATURATION_ASM_CONSTEXPR inline
+#endif
+
+// The inline assembler functions which report overflow (addu_ovf<N>() and so
+// on) return the processor's carry or overflow flag using GCC's flag output
+// operands where the compiler supports them.
+#if !defined(NO_INLINE_ASM) && defined(__GNUC__) && defined(__x86_64__) && \
+    defined(__GCC_ASM_FLAG_OUTPUTS__)
+#define SATURATION_ASM_FLAG_OUTPUTS 1
+#else
+#define SATURATION_ASM_FLAG_OUTPUTS 0
+#endif
+
 namespace saturation {
 
 /// Yields the smallest signed integral type with at least \p N bits.
@@ -51,8 +94,9 @@ struct sinteger<64> {
 /// \brief Yields a signed integral type of 128 bits.
 template <>
 struct sinteger<128> {
-  /// A 128 bit signed integer type.
-  using type = __int128;
+  /// A 128 bit signed integer type. (__extension__ suppresses the -pedantic
+  /// diagnostic for this non-standard type.)
+  __extension__ typedef __int128 type;
 };
 #else
 /// \brief Yields no type when the compiler does not support 128 bit integers.
@@ -97,8 +141,8 @@ struct uinteger<64> {
 /// \brief Yields an unsigned integral type of 128 bits.
 template <>
 struct uinteger<128> {
-  /// A 128 bit signed integer type.
-  using type = unsigned __int128;
+  /// A 128 bit unsigned integer type.
+  __extension__ typedef unsigned __int128 type;
 };
 #else
 /// \brief Yields no type when the compiler does not support 128 bit integers.
@@ -106,13 +150,19 @@ template <>
 struct uinteger<128> {};
 #endif
 
+/// The largest value of N accepted by the scalar arithmetic functions
+/// (addu<N>(), adds<N>(), subu<N>(), subs<N>(), mulu<N>(), muls<N>(),
+/// divu<N>(), and divs<N>()). This is 128 if the compiler's 128 bit integer
+/// types are enabled by HAVE_INT128 and 64 otherwise.
+inline constexpr auto max_width = size_t{HAVE_INT128 ? 128 : 64};
+
 /// \brief Equivalent to (T{1}<<N)-T{1} where T is an unsigned integral type.
 ///
 /// Avoids the risk of overflow if N is equal to the number of bits in T.
 /// Yields 0 if \p N is 0.
 ///
 /// \tparam N  The number of bits of result.
-template <size_t N, typename = typename std::enable_if_t<(N <= 64)>>
+template <size_t N, typename = typename std::enable_if_t<(N <= 128)>>
 struct mask {
   /// Static constant of type uinteger_t<N> with value \f$ 2^N-1 \f$.
   static constexpr uinteger_t<N> value =
@@ -163,6 +213,29 @@ struct ulimits {
   static constexpr type min () { return 0U; }
 };
 
+/// \brief The result of one of the functions which perform saturating
+///   arithmetic and report whether the result was clamped (addu_ovf<N>() and
+///   so on).
+///
+/// \tparam T  The type of the result.
+template <typename T>
+struct ovf_result {
+  /// The saturated result.
+  T value;
+  /// True if the exact result could not be represented and \p value is the
+  /// limit to which it was clamped; false otherwise.
+  bool saturated;
+
+  friend constexpr bool operator== (ovf_result const& x,
+                                    ovf_result const& y) noexcept {
+    return x.value == y.value && x.saturated == y.saturated;
+  }
+  friend constexpr bool operator!= (ovf_result const& x,
+                                    ovf_result const& y) noexcept {
+    return !(x == y);
+  }
+};
+
 namespace details {
 
 /// Counts the number of set bits in a value. This version is sometimes
@@ -184,6 +257,16 @@ constexpr bool is_register_width (size_t const n) {
   return n % 8 == 0 && pop_count (n) == 1U;
 }
 
+/// Returns true if called during constant evaluation. Always false before
+/// C++20, where the functions which call it cannot be constant evaluated.
+constexpr bool is_constant_evaluated () noexcept {
+#if SATURATION_HAVE_CONSTEXPR_ASM
+  return std::is_constant_evaluated ();
+#else
+  return false;
+#endif  // SATURATION_HAVE_CONSTEXPR_ASM
+}
+
 /// \brief Holds a value of \p N bits which may be signed or unsigned.
 ///
 /// \tparam N The number of bits that the type should hold.
@@ -0,0 +1,434 @@
+/// \file wide_int.hpp
+/// \brief Fixed-width saturating integers wider than 128 bits.
+///
+/// wide_uint<Bits> and wide_int<Bits> hold an unsigned or twos complement
+/// value as an array of 64 bit limbs in fixed-size (stack) storage. Their
+/// saturating operations run carry-chained loops over the limbs and apply a
+/// single branch-free saturation at the end so that, for example, a wide
+/// accumulator can be updated in an inner loop without allocation.
+
+#ifndef SATURATION_WIDE_INT_HPP
+#define SATURATION_WIDE_INT_HPP
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <utility>
+
+#include "saturation/mul.hpp"
+#include "saturation/types.hpp"
+
+#ifndef NO_INLINE_ASM
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#endif  // __GNUC__ && __x86_64__
+#endif  // NO_INLINE_ASM
+
+namespace saturation {
+
+/// \brief A fixed-width integer of \p Bits bits stored as 64 bit limbs.
+///
+/// Limb 0 holds the least significant 64 bits. Signed values use twos
+/// complement so that the most significant bit of the last limb is the sign.
+///
+/// \tparam Bits  The number of bits. Must be a multiple of 64 and at least
+///   128.
+/// \tparam IsSigned  True if the value is signed; false otherwise.
+template <size_t Bits, bool IsSigned,
+          typename = typename std::enable_if_t<(Bits >= 128 && Bits % 64 == 0)>>
+class wide_integer {
+public:
+  /// The number of 64 bit limbs.
+  static constexpr auto limb_count = Bits / 64U;
+  using limbs_type = std::array<uint64_t, limb_count>;
+
+  /// Constructs a value of zero.
+  constexpr wide_integer () noexcept = default;
+  /// Constructs from a standard integer, sign-extending if the type is
+  /// signed.
+  explicit constexpr wide_integer (
+      std::conditional_t<IsSigned, int64_t, uint64_t> const v) noexcept
+      : limbs_{} {
+    limbs_[0] = static_cast<uint64_t> (v);
+    auto extend = uint64_t{0};
+    if constexpr (IsSigned) {
+      extend = static_cast<uint64_t> (v >> 63U);  // sign extension
+    }
+    for (auto ctr = size_t{1}; ctr < limb_count; ++ctr) {
+      limbs_[ctr] = extend;
+    }
+  }
+  /// Constructs from an array of limbs, least significant first.
+  explicit constexpr wide_integer (limbs_type const& limbs) noexcept
+      : limbs_{limbs} {}
+
+  /// Returns the largest representable value.
+  static constexpr wide_integer max () noexcept {
+    auto result = filled (~uint64_t{0});
+    if constexpr (IsSigned) {
+      result.limbs_[limb_count - 1U] >>= 1U;
+    }
+    return result;
+  }
+  /// Returns the smallest representable value.
+  static constexpr wide_integer min () noexcept {
+    auto result = wide_integer{};
+    if constexpr (IsSigned) {
+      result.limbs_[limb_count - 1U] = uint64_t{1} << 63U;
+    }
+    return result;
+  }
+
+  /// Returns the limbs, least significant first.
+  constexpr limbs_type const& limbs () const noexcept { return limbs_; }
+  /// Returns limb \p pos where limb 0 is the least significant.
+  constexpr uint64_t limb (size_t const pos) const noexcept {
+    assert (pos < limb_count);  // wide_integer<> limb index out of range
+    return limbs_[pos];
+  }
+  /// Returns true if the value is less than zero.
+  constexpr bool is_negative () const noexcept {
+    return IsSigned && (limbs_[limb_count - 1U] >> 63U) != 0U;
+  }
+
+  friend constexpr bool operator== (wide_integer const& x,
+                                    wide_integer const& y) noexcept {
+    auto diff = uint64_t{0};
+    for (auto ctr = size_t{0}; ctr < limb_count; ++ctr) {
+      diff |= x.limbs_[ctr] ^ y.limbs_[ctr];
+    }
+    return diff == 0U;
+  }
+  friend constexpr bool operator!= (wide_integer const& x,
+                                    wide_integer const& y) noexcept {
+    return !(x == y);
+  }
+  friend constexpr bool operator< (wide_integer const& x,
+                                   wide_integer const& y) noexcept {
+    // Flipping the sign bits orders signed values as unsigned.
+    constexpr auto flip = IsSigned ? uint64_t{1} << 63U : uint64_t{0};
+    auto const top = limb_count - 1U;
+    if (x.limbs_[top] != y.limbs_[top]) {
+      return (x.limbs_[top] ^ flip) < (y.limbs_[top] ^ flip);
+    }
+    for (auto ctr = top; ctr > 0U; --ctr) {
+      if (x.limbs_[ctr - 1U] != y.limbs_[ctr - 1U]) {
+        return x.limbs_[ctr - 1U] < y.limbs_[ctr - 1U];
+      }
+    }
+    return false;
+  }
+  friend constexpr bool operator> (wide_integer const& x,
+                                   wide_integer const& y) noexcept {
+    return y < x;
+  }
+
+private:
+  static constexpr wide_integer filled (uint64_t const v) noexcept {
+    auto result = wide_integer{};
+    for (auto& l : result.limbs_) {
+      l = v;
+    }
+    return result;
+  }
+
+  limbs_type limbs_{};
+};
+
+/// An unsigned saturating integer of \p Bits bits.
+template <size_t Bits>
+using wide_uint = wide_integer<Bits, false>;
+/// A signed (twos complement) saturating integer of \p Bits bits.
+template <size_t Bits>
+using wide_int = wide_integer<Bits, true>;
+
+namespace details {
+
+/// Returns the low 64 bits of \p x + \p y + \p carry and sets \p carry to
+/// the carry out.
+constexpr uint64_t add_carry_generic (uint64_t const x, uint64_t const y,
+                                      unsigned char& carry) {
+  auto const sum = x + y;
+  auto const res = sum + carry;
+  carry = static_cast<unsigned char> ((sum < x) | (res < sum));
+  return res;
+}
+/// Returns the low 64 bits of \p x - \p y - \p borrow and sets \p borrow to
+/// the borrow out.
+constexpr uint64_t sub_borrow_generic (uint64_t const x, uint64_t const y,
+                                       unsigned char& borrow) {
+  auto const diff = x - y;
+  auto const res = diff - borrow;
+  borrow = static_cast<unsigned char> ((x < y) | (diff < borrow));
+  return res;
+}
+
+#if !defined(NO_INLINE_ASM) && defined(__GNUC__) && defined(__x86_64__)
+/// Returns the low 64 bits of \p x + \p y + \p carry and sets \p carry to
+/// the carry out. This version compiles to an adc instruction.
+SATURATION_ASM_CONSTEXPR uint64_t add_carry (uint64_t const x, uint64_t const y,
+                                             unsigned char& carry) {
+  if (is_constant_evaluated ()) {
+    return add_carry_generic (x, y, carry);
+  }
+  unsigned long long res = 0;
+  carry = _addcarry_u64 (carry, x, y, &res);
+  return res;
+}
+/// Returns the low 64 bits of \p x - \p y - \p borrow and sets \p borrow to
+/// the borrow out. This version compiles to an sbb instruction.
+SATURATION_ASM_CONSTEXPR uint64_t sub_borrow (uint64_t const x,
+                                              uint64_t const y,
+                                              unsigned char& borrow) {
+  if (is_constant_evaluated ()) {
+    return sub_borrow_generic (x, y, borrow);
+  }
+  unsigned long long res = 0;
+  borrow = _subborrow_u64 (borrow, x, y, &res);
+  return res;
+}
+#else
+constexpr uint64_t add_carry (uint64_t const x, uint64_t const y,
+                              unsigned char& carry) {
+  return add_carry_generic (x, y, carry);
+}
+constexpr uint64_t sub_borrow (uint64_t const x, uint64_t const y,
+                               unsigned char& borrow) {
+  return sub_borrow_generic (x, y, borrow);
+}
+#endif  // !NO_INLINE_ASM && __GNUC__ && __x86_64__
+
+/// Multiplies two limbs returning a pair holding the high- and low-order
+/// halves of the product respectively. Uses mulx where BMI2 is available;
+/// otherwise the portable multiply().
+#if !defined(NO_INLINE_ASM) && defined(__GNUC__) && defined(__x86_64__) && \
+    defined(__BMI2__)
+SATURATION_ASM_CONSTEXPR std::pair<uint64_t, uint64_t> multiply_limb (
+    uint64_t const x, uint64_t const y) {
+  if (is_constant_evaluated ()) {
+    return multiply (x, y);
+  }
+  unsigned long long hi = 0;
+  auto const lo = _mulx_u64 (x, y, &hi);
+  return std::make_pair (static_cast<uint64_t> (hi), uint64_t{lo});
+}
+#else
+constexpr std::pair<uint64_t, uint64_t> multiply_limb (uint64_t const x,
+                                                       uint64_t const y) {
+  return multiply (x, y);
+}
+#endif  // !NO_INLINE_ASM && __GNUC__ && __x86_64__ && __BMI2__
+
+/// Replaces each limb of \p res with the corresponding limb of \p v if
+/// \p select is 1. \p select must be 0 or 1.
+template <size_t Limbs>
+constexpr void select_limbs (std::array<uint64_t, Limbs>& res,
+                             std::array<uint64_t, Limbs> const& v,
+                             uint64_t const select) {
+  auto const mask = uint64_t{0} - select;
+  for (auto ctr = size_t{0}; ctr < Limbs; ++ctr) {
+    res[ctr] = (res[ctr] & ~mask) | (v[ctr] & mask);
+  }
+}
+
+/// Returns the saturated value (max or min) for a signed result whose sign
+/// should match that of a value whose most significant limb is \p top.
+template <size_t Limbs>
+constexpr std::array<uint64_t, Limbs> signed_limit (uint64_t const top) {
+  // max: 0x7FF...F; min: 0x800...0. Both follow from the sign bit s as
+  // limbs of (s - 1) with the top bit of the last one flipped.
+  auto const fill = (top >> 63U) - 1U;
+  std::array<uint64_t, Limbs> v{};
+  for (auto& l : v) {
+    l = fill;
+  }
+  v[Limbs - 1U] ^= uint64_t{1} << 63U;
+  return v;
+}
+
+/// Negates the twos complement value \p x in place.
+template <size_t Limbs>
+constexpr void negate_limbs (std::array<uint64_t, Limbs>& x) {
+  unsigned char borrow = 0;
+  for (auto& l : x) {
+    l = sub_borrow (0U, l, borrow);
+  }
+}
+
+/// Computes the low \p Limbs limbs of \p x &times; \p y. Returns them along
+/// with a flag which is true if the full product does not fit.
+template <size_t Limbs>
+constexpr std::pair<bool, std::array<uint64_t, Limbs>> multiply_limbs (
+    std::array<uint64_t, Limbs> const& x,
+    std::array<uint64_t, Limbs> const& y) {
+  std::array<uint64_t, Limbs> res{};
+  auto overflow = uint64_t{0};
+  for (auto i = size_t{0}; i < Limbs; ++i) {
+    // Partial products which land in limb i + j < Limbs are accumulated.
+    // x * y + a + b cannot exceed 128 bits so the high half of the sum (the
+    // carry into the next limb) fits in 64 bits.
+    auto carry = uint64_t{0};
+    for (auto j = size_t{0}; i + j < Limbs; ++j) {
+      auto const [hi, lo] = multiply_limb (x[i], y[j]);
+      unsigned char c0 = 0;
+      unsigned char c1 = 0;
+      res[i + j] = add_carry (res[i + j], lo, c0);
+      res[i + j] = add_carry (res[i + j], carry, c1);
+      carry = hi + c0 + c1;
+    }
+    overflow |= carry;
+    // Any non-zero partial product beyond the last limb is an overflow.
+    for (auto j = Limbs - i; j < Limbs; ++j) {
+      overflow |= static_cast<uint64_t> ((x[i] != 0U) & (y[j] != 0U));
+    }
+  }
+  return std::make_pair (overflow != 0U, res);
+}
+
+}  // end namespace details
+
+/// \name Wide Integer Arithmetic
+/// Functions that perform saturating arithmetic on wide_uint<Bits> and
+/// wide_int<Bits> values.
+/// @{
+
+/// \brief Computes \p x + \p y.
+///
+/// \returns  \p x + \p y or wide_uint<Bits>::max() if the result cannot be
+///   represented in \p Bits bits.
+template <size_t Bits>
+constexpr wide_uint<Bits> addu (wide_uint<Bits> const& x,
+                                wide_uint<Bits> const& y) {
+  typename wide_uint<Bits>::limbs_type res{};
+  unsigned char carry = 0;
+  for (auto ctr = size_t{0}; ctr < res.size (); ++ctr) {
+    res[ctr] = details::add_carry (x.limb (ctr), y.limb (ctr), carry);
+  }
+  auto const saturate = uint64_t{0} - carry;
+  for (auto& l : res) {
+    l |= saturate;
+  }
+  return wide_uint<Bits>{res};
+}
+/// \brief Computes \p x - \p y.
+///
+/// \returns  \p x - \p y or 0 if the result would be negative.
+template <size_t Bits>
+constexpr wide_uint<Bits> subu (wide_uint<Bits> const& x,
+                                wide_uint<Bits> const& y) {
+  typename wide_uint<Bits>::limbs_type res{};
+  unsigned char borrow = 0;
+  for (auto ctr = size_t{0}; ctr < res.size (); ++ctr) {
+    res[ctr] = details::sub_borrow (x.limb (ctr), y.limb (ctr), borrow);
+  }
+  auto const keep = uint64_t{borrow} - 1U;
+  for (auto& l : res) {
+    l &= keep;
+  }
+  return wide_uint<Bits>{res};
+}
+/// \brief Computes \p x &times; \p y.
+///
+/// \returns  \p x &times; \p y or wide_uint<Bits>::max() if the result cannot
+///   be represented in \p Bits bits.
+template <size_t Bits>
+constexpr wide_uint<Bits> mulu (wide_uint<Bits> const& x,
+                                wide_uint<Bits> const& y) {
+  auto [overflow, res] = details::multiply_limbs (x.limbs (), y.limbs ());
+  auto const saturate = uint64_t{0} - overflow;
+  for (auto& l : res) {
+    l |= saturate;
+  }
+  return wide_uint<Bits>{res};
+}
+
+/// \brief Computes \p x + \p y.
+///
+/// \returns  \p x + \p y. If the result would be too large,
+///   wide_int<Bits>::max(); if it would be too small, wide_int<Bits>::min().
+template <size_t Bits>
+constexpr wide_int<Bits> adds (wide_int<Bits> const& x,
+                               wide_int<Bits> const& y) {
+  typename wide_int<Bits>::limbs_type res{};
+  unsigned char carry = 0;
+  for (auto ctr = size_t{0}; ctr < res.size (); ++ctr) {
+    res[ctr] = details::add_carry (x.limb (ctr), y.limb (ctr), carry);
+  }
+  // Overflow if x and y have the same sign and the result's sign differs.
+  auto const top = res.size () - 1U;
+  auto const xt = x.limb (top);
+  auto const overflow = ((xt ^ res[top]) & (y.limb (top) ^ res[top])) >> 63U;
+  details::select_limbs (
+      res, details::signed_limit<wide_int<Bits>::limb_count> (xt), overflow);
+  return wide_int<Bits>{res};
+}
+/// \brief Computes \p x - \p y.
+///
+/// \returns  \p x - \p y. If the result would be too large,
+///   wide_int<Bits>::max(); if it would be too small, wide_int<Bits>::min().
+template <size_t Bits>
+constexpr wide_int<Bits> subs (wide_int<Bits> const& x,
+                               wide_int<Bits> const& y) {
+  typename wide_int<Bits>::limbs_type res{};
+  unsigned char borrow = 0;
+  for (auto ctr = size_t{0}; ctr < res.size (); ++ctr) {
+    res[ctr] = details::sub_borrow (x.limb (ctr), y.limb (ctr), borrow);
+  }
+  // Overflow if x and y have different signs and the result's sign differs
+  // from x.
+  auto const top = res.size () - 1U;
+  auto const xt = x.limb (top);
+  auto const overflow = ((xt ^ y.limb (top)) & (xt ^ res[top])) >> 63U;
+  details::select_limbs (
+      res, details::signed_limit<wide_int<Bits>::limb_count> (xt), overflow);
+  return wide_int<Bits>{res};
+}
+/// \brief Computes \p x &times; \p y.
+///
+/// The product of the magnitudes is computed and then compared with the
+/// largest magnitude which can be represented with the sign of the result.
+///
+/// \returns  \p x &times; \p y. If the result would be too large,
+///   wide_int<Bits>::max(); if it would be too small, wide_int<Bits>::min().
+template <size_t Bits>
+constexpr wide_int<Bits> muls (wide_int<Bits> const& x,
+                               wide_int<Bits> const& y) {
+  constexpr auto limbs = wide_int<Bits>::limb_count;
+  constexpr auto top = limbs - 1U;
+  auto abs_x = x.limbs ();
+  auto abs_y = y.limbs ();
+  auto const x_sign = abs_x[top] >> 63U;
+  auto const y_sign = abs_y[top] >> 63U;
+  // The magnitude of min() is 2^(Bits-1) which is representable unsigned.
+  auto negated = abs_x;
+  details::negate_limbs (negated);
+  details::select_limbs (abs_x, negated, x_sign);
+  negated = abs_y;
+  details::negate_limbs (negated);
+  details::select_limbs (abs_y, negated, y_sign);
+
+  auto [overflow, res] = details::multiply_limbs (abs_x, abs_y);
+  // A magnitude with the top bit set only fits if the result is negative and
+  // the magnitude is exactly 2^(Bits-1).
+  auto const negative = x_sign ^ y_sign;
+  auto low_bits = res[top] & ~(uint64_t{1} << 63U);
+  for (auto ctr = size_t{0}; ctr < top; ++ctr) {
+    low_bits |= res[ctr];
+  }
+  auto const too_large =
+      static_cast<uint64_t> (overflow) |
+      ((res[top] >> 63U) & ((negative ^ 1U) | (low_bits != 0U)));
+
+  negated = res;
+  details::negate_limbs (negated);
+  details::select_limbs (res, negated, negative);
+  // signed_limit<>() takes the sign from the top bit: min() if negative.
+  details::select_limbs (res, details::signed_limit<limbs> (negative << 63U),
+                         too_large);
+  return wide_int<Bits>{res};
+}
+/// @}
+
+}  // end namespace saturation
+
+#endif  // SATURATION_WIDE_INT_HPP
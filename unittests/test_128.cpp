@@ -0,0 +1,165 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "saturation/saturation.hpp"
+
+using namespace saturation;
+
+#if HAVE_INT128
+
+namespace {
+
+using u128 = uinteger_t<128>;
+using s128 = sinteger_t<128>;
+
+constexpr u128 make_u128 (uint64_t const hi, uint64_t const lo) {
+  return u128{hi} << 64U | lo;
+}
+
+static_assert (mulu<128> (make_u128 (1U, 0U), make_u128 (1U, 0U)) ==
+               ulimits<128>::max ());
+static_assert (mulu<128> (make_u128 (0U, 3U), make_u128 (5U, 7U)) ==
+               make_u128 (15U, 21U));
+static_assert (muls<128> (slimits<128>::min (), -1) == slimits<128>::max ());
+static_assert (muls<128> (slimits<128>::min (), 1) == slimits<128>::min ());
+static_assert (muls<100> (slimits<100>::max (), -1) ==
+               slimits<100>::min () + 1);
+static_assert (divs<128> (slimits<128>::min (), -1) == slimits<128>::max ());
+
+/// Returns the edge-case values of \p N bits together with \p count
+/// pseudo-random values of varying magnitude.
+template <size_t N, bool IsSigned>
+std::vector<std::conditional_t<IsSigned, sinteger_t<N>, uinteger_t<N>>>
+make_values (size_t const count, unsigned const seed) {
+  using value_type =
+      std::conditional_t<IsSigned, sinteger_t<N>, uinteger_t<N>>;
+  constexpr auto min = IsSigned ? static_cast<u128> (slimits<N>::min ()) : 0U;
+  constexpr auto max = IsSigned ? static_cast<u128> (slimits<N>::max ())
+                                : static_cast<u128> (ulimits<N>::max ());
+  std::vector<value_type> result;
+  for (auto ctr = u128{0}; ctr < 4U; ++ctr) {
+    result.push_back (static_cast<value_type> (min + ctr));
+    result.push_back (static_cast<value_type> (max - ctr));
+    result.push_back (static_cast<value_type> (ctr));
+    if constexpr (IsSigned) {
+      result.push_back (static_cast<value_type> (u128{0} - ctr));
+    }
+  }
+  std::mt19937_64 generator{seed};
+  for (auto ctr = size_t{0}; ctr < count; ++ctr) {
+    auto const hi = generator ();
+    auto const lo = generator ();
+    // Shift right so that products are not (almost) always saturated.
+    auto v = make_u128 (hi, lo) >> (ctr % 128U);
+    if constexpr (IsSigned) {
+      // Sign-extend from bit N-1.
+      auto const sign = u128{1} << (N - 1U);
+      v = ((v & mask_v<N>) ^ sign) - sign;
+    } else {
+      v &= mask_v<N>;
+    }
+    result.push_back (static_cast<value_type> (v));
+  }
+  return result;
+}
+
+/// Clamps \p v to the range of an unsigned value of \p N bits.
+template <size_t N>
+u128 clamp_unsigned (bool const overflow, u128 const v) {
+  return overflow || v > ulimits<N>::max () ? ulimits<N>::max () : v;
+}
+/// Clamps \p v to the range of a signed value of \p N bits. \p overflow
+/// indicates that the true result is the opposite sign to \p v.
+template <size_t N>
+s128 clamp_signed (bool const overflow, s128 const v) {
+  if (overflow) {
+    return v < 0 ? slimits<N>::max () : slimits<N>::min ();
+  }
+  return std::clamp (v, s128{slimits<N>::min ()}, s128{slimits<N>::max ()});
+}
+
+/// Checks each of the scalar arithmetic functions for \p N bits against
+/// results computed with the compiler's overflow checking builtins.
+template <size_t N>
+void check () {
+  auto const uvalues = make_values<N, false> (200U, N);
+  for (auto const x : uvalues) {
+    for (auto const y : uvalues) {
+      u128 r;
+      auto o = __builtin_add_overflow (x, y, &r);
+      ASSERT_EQ (addu<N> (x, y), clamp_unsigned<N> (o, r));
+      o = __builtin_sub_overflow (x, y, &r);
+      ASSERT_EQ (subu<N> (x, y), o ? u128{0} : r);
+      o = __builtin_mul_overflow (x, y, &r);
+      ASSERT_EQ (mulu<N> (x, y), clamp_unsigned<N> (o, r));
+      if (y != 0U) {
+        ASSERT_EQ (divu<N> (x, y), x / y);
+      }
+    }
+  }
+  auto const svalues = make_values<N, true> (200U, N + 1U);
+  for (auto const x : svalues) {
+    for (auto const y : svalues) {
+      s128 r;
+      auto o = __builtin_add_overflow (x, y, &r);
+      ASSERT_EQ (adds<N> (x, y), clamp_signed<N> (o, r));
+      o = __builtin_sub_overflow (x, y, &r);
+      ASSERT_EQ (subs<N> (x, y), clamp_signed<N> (o, r));
+      o = __builtin_mul_overflow (x, y, &r);
+      // The sign of an overflowed product is that of x ^ y.
+      ASSERT_EQ (muls<N> (x, y),
+                 o ? ((x < 0) != (y < 0) ? slimits<N>::min ()
+                                         : slimits<N>::max ())
+                   : clamp_signed<N> (false, r));
+      if (y != 0 && !(x == slimits<N>::min () && y == -1)) {
+        ASSERT_EQ (divs<N> (x, y), x / y);
+      }
+    }
+  }
+}
+
+}  // end anonymous namespace
+
+TEST (Saturation128, 65) {
+  check<65> ();
+}
+TEST (Saturation128, 100) {
+  check<100> ();
+}
+TEST (Saturation128, 127) {
+  check<127> ();
+}
+TEST (Saturation128, 128) {
+  check<128> ();
+}
+TEST (Saturation128, Edges) {
+  constexpr auto maxu = ulimits<128>::max ();
+  constexpr auto max = slimits<128>::max ();
+  constexpr auto min = slimits<128>::min ();
+  EXPECT_TRUE (addu<128> (maxu, 1U) == maxu);
+  EXPECT_TRUE (addu<128> (make_u128 (0U, ~uint64_t{0}), 1U) ==
+               make_u128 (1U, 0U));
+  EXPECT_TRUE (subu<128> (make_u128 (1U, 0U), 1U) ==
+               make_u128 (0U, ~uint64_t{0}));
+  EXPECT_TRUE (subu<128> (0U, 1U) == 0U);
+  EXPECT_TRUE (adds<128> (max, 1) == max);
+  EXPECT_TRUE (adds<128> (min, -1) == min);
+  EXPECT_TRUE (adds<128> (min, max) == -1);
+  EXPECT_TRUE (subs<128> (min, 1) == min);
+  EXPECT_TRUE (subs<128> (0, min) == max);
+  EXPECT_TRUE (subs<128> (-1, min) == max);
+  EXPECT_TRUE (mulu<128> (make_u128 (0U, ~uint64_t{0}),
+                          make_u128 (0U, ~uint64_t{0})) ==
+               make_u128 (~uint64_t{0} - 1U, 1U));
+  constexpr auto two_64 = static_cast<s128> (make_u128 (1U, 0U));
+  constexpr auto two_63 = s128{1} << 63U;
+  EXPECT_TRUE (muls<128> (two_64, -two_63) == min);
+  EXPECT_TRUE (muls<128> (-two_64, two_63) == min);
+  EXPECT_TRUE (muls<128> (two_64, two_63) == max);
+  EXPECT_TRUE (muls<128> (-two_64, -two_63) == max);
+}
+
+#endif  // HAVE_INT128
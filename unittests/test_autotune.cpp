@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "saturation/autotune.hpp"
+
+using namespace saturation;
+
+namespace {
+
+class Autotune : public testing::Test {
+protected:
+  /// Each test uses its own directory, which is removed when it finishes.
+  Autotune ()
+      : path_{std::filesystem::temp_directory_path () /
+              ("saturation-autotune-" +
+               std::to_string (std::random_device{}())) /
+              "autotune.txt"} {}
+  ~Autotune () override {
+    std::error_code error;
+    std::filesystem::remove_all (path_.parent_path (), error);
+  }
+
+  autotune_options options () const {
+    autotune_options result;
+    result.cache_path = path_.string ();
+    return result;
+  }
+
+  std::filesystem::path path_;
+};
+
+}  // end anonymous namespace
+
+TEST_F (Autotune, MeasureThenCache) {
+  auto const first = autotune (options ());
+  // Eight operations at each of seven widths.
+  ASSERT_EQ (first.size (), 56U);
+  for (auto const& c : first) {
+    EXPECT_FALSE (c.cached) << c.op << '<' << c.bits << '>';
+    EXPECT_LE (c.level, selected_isa ()) << c.op << '<' << c.bits << '>';
+  }
+  ASSERT_TRUE (std::filesystem::exists (path_));
+
+  auto const second = autotune (options ());
+  ASSERT_EQ (second.size (), first.size ());
+  for (auto ctr = size_t{0}; ctr < first.size (); ++ctr) {
+    EXPECT_TRUE (second[ctr].cached);
+    EXPECT_STREQ (second[ctr].op, first[ctr].op);
+    EXPECT_EQ (second[ctr].bits, first[ctr].bits);
+    EXPECT_EQ (second[ctr].level, first[ctr].level);
+  }
+}
+TEST_F (Autotune, BadEntry) {
+  autotune (options ());
+  // Replace the choice for addu<8> with one that is not a level.
+  std::vector<std::string> lines;
+  {
+    std::ifstream is{path_};
+    std::string line;
+    while (std::getline (is, line)) {
+      if (line.find ("\taddu\t8\t") != std::string::npos) {
+        line = line.substr (0, line.rfind ('\t') + 1U) + "bogus";
+      }
+      lines.push_back (line);
+    }
+  }
+  {
+    std::ofstream os{path_, std::ios::trunc};
+    os << "another cpu\tavx2\taddu\t8\tavx2\n";
+    for (auto const& line : lines) {
+      os << line << '\n';
+    }
+  }
+
+  auto const choices = autotune (options ());
+  for (auto const& c : choices) {
+    auto const is_bad = std::string{c.op} == "addu" && c.bits == 8U;
+    EXPECT_EQ (c.cached, !is_bad) << c.op << '<' << c.bits << '>';
+  }
+  // The lines for another processor are kept.
+  std::ifstream is{path_};
+  std::string line;
+  ASSERT_TRUE (std::getline (is, line));
+  EXPECT_EQ (line, "another cpu\tavx2\taddu\t8\tavx2");
+}
+TEST_F (Autotune, NoCache) {
+  auto opts = options ();
+  opts.use_cache = false;
+  for (auto const& c : autotune (opts)) {
+    EXPECT_FALSE (c.cached);
+  }
+  EXPECT_FALSE (std::filesystem::exists (path_));
+}
+TEST_F (Autotune, ResultsUnchanged) {
+  autotune (options ());
+  std::array<int16_t, 4> const x{{32767, -32768, 100, -5}};
+  std::array<int16_t, 4> const y{{1, -1, 200, 3}};
+  std::array<int16_t, 4> out{};
+  batch::adds<16> (x, y, out);
+  EXPECT_EQ (out, (std::array<int16_t, 4>{{32767, -32768, 300, -2}}));
+  batch::muls<16> (x, y, out);
+  EXPECT_EQ (out, (std::array<int16_t, 4>{{32767, 32767, 20000, -15}}));
+}
+TEST (CpuModel, NotEmpty) {
+  EXPECT_FALSE (cpu_model ().empty ());
+}
@@ -0,0 +1,229 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <random>
+#include <vector>
+
+#include "saturation/batch.hpp"
+
+using namespace saturation;
+
+namespace {
+
+/// Returns a vector of \p count values of \p N bits. The vector begins with
+/// the interesting edge cases (zero, one, the extreme values of the type and
+/// their neighbours) and is filled with pseudo-random values.
+template <typename T, size_t N>
+std::vector<T> make_values (size_t const count, unsigned const seed) {
+  constexpr auto is_unsigned = std::is_unsigned_v<T>;
+  constexpr auto min = static_cast<T> (is_unsigned ? ulimits<N>::min ()
+                                                   : slimits<N>::min ());
+  constexpr auto max = static_cast<T> (is_unsigned ? ulimits<N>::max ()
+                                                   : slimits<N>::max ());
+  std::vector<T> result{T{0},
+                        T{1},
+                        static_cast<T> (min + 1),
+                        min,
+                        static_cast<T> (max - 1),
+                        max,
+                        static_cast<T> (max / 2),
+                        static_cast<T> (min / 2)};
+  std::mt19937_64 generator{seed};
+  // uniform_int_distribution<> cannot be instantiated for character types.
+  using wide_type = std::conditional_t<is_unsigned, uint64_t, int64_t>;
+  std::uniform_int_distribution<wide_type> distribution{min, max};
+  // Values of no more than half the width are also drawn so that products do
+  // not always overflow.
+  constexpr auto half = static_cast<wide_type> (max >> (N / 2U));
+  std::uniform_int_distribution<wide_type> narrow{
+      static_cast<wide_type> (is_unsigned ? 0 : -half), half};
+  while (result.size () < count) {
+    auto& d = result.size () % 2U == 0U ? distribution : narrow;
+    result.push_back (static_cast<T> (d (generator)));
+  }
+  result.resize (count);
+  return result;
+}
+
+// The vector lengths used by the tests. These are chosen to exercise empty
+// arrays, arrays shorter than a vector register, and arrays with a partial
+// final register.
+constexpr std::array<size_t, 6> lengths{{0U, 1U, 15U, 64U, 100U, 1027U}};
+
+/// Checks the kernels implementing \p Op on values of \p N bits against the
+/// scalar implementation at each instruction set level supported by the host.
+template <details::batch_op Op, size_t N>
+void check_kernels (unsigned const seed) {
+  using arg_type = details::batch_arg_t<Op, N>;
+  for (auto const level : {isa::scalar, isa::sse2, isa::avx2, isa::avx512}) {
+    if (level > detected_isa ()) {
+      continue;
+    }
+    auto const kernel = details::resolve_kernel<Op, N> (level);
+    for (auto const length : lengths) {
+      auto const x = make_values<arg_type, N> (length, seed);
+      auto y = make_values<arg_type, N> (length, seed + 1U);
+      if constexpr (Op == details::batch_op::divu ||
+                    Op == details::batch_op::divs) {
+        // Division by zero is undefined.
+        std::replace (y.begin (), y.end (), arg_type{0}, arg_type{1});
+      }
+      if constexpr (Op == details::batch_op::divu_saturate ||
+                    Op == details::batch_op::divs_saturate) {
+        // Make a third of the divisors zero.
+        for (auto ctr = size_t{0}; ctr < length; ctr += 3U) {
+          y[ctr] = arg_type{0};
+        }
+      }
+      std::vector<arg_type> out (length);
+      kernel (x.data (), y.data (), out.data (), length);
+      for (auto ctr = size_t{0}; ctr < length; ++ctr) {
+        auto const expected = details::scalar_op<Op, N>::apply (x[ctr], y[ctr]);
+        EXPECT_EQ (out[ctr], expected)
+            << "isa " << to_string (level) << " index " << ctr << " x "
+            << +x[ctr] << " y " << +y[ctr];
+      }
+    }
+  }
+}
+
+}  // end anonymous namespace
+
+template <typename T>
+class Batch : public testing::Test {};
+TYPED_TEST_SUITE_P (Batch);
+
+TYPED_TEST_P (Batch, UnsignedAdd) {
+  check_kernels<details::batch_op::addu, TypeParam::value> (1U);
+}
+TYPED_TEST_P (Batch, SignedAdd) {
+  check_kernels<details::batch_op::adds, TypeParam::value> (3U);
+}
+TYPED_TEST_P (Batch, UnsignedSubtract) {
+  check_kernels<details::batch_op::subu, TypeParam::value> (5U);
+}
+TYPED_TEST_P (Batch, SignedSubtract) {
+  check_kernels<details::batch_op::subs, TypeParam::value> (7U);
+}
+TYPED_TEST_P (Batch, UnsignedMultiply) {
+  check_kernels<details::batch_op::mulu, TypeParam::value> (13U);
+}
+TYPED_TEST_P (Batch, SignedMultiply) {
+  check_kernels<details::batch_op::muls, TypeParam::value> (15U);
+}
+TYPED_TEST_P (Batch, UnsignedDivide) {
+  check_kernels<details::batch_op::divu, TypeParam::value> (17U);
+}
+TYPED_TEST_P (Batch, SignedDivide) {
+  check_kernels<details::batch_op::divs, TypeParam::value> (19U);
+}
+TYPED_TEST_P (Batch, UnsignedDivideByZero) {
+  check_kernels<details::batch_op::divu_saturate, TypeParam::value> (21U);
+}
+TYPED_TEST_P (Batch, SignedDivideByZero) {
+  check_kernels<details::batch_op::divs_saturate, TypeParam::value> (23U);
+}
+TYPED_TEST_P (Batch, Public) {
+  constexpr auto n = TypeParam::value;
+  using uint_type = uinteger_t<n>;
+  auto const x = make_values<uint_type, n> (100U, 9U);
+  auto const y = make_values<uint_type, n> (100U, 10U);
+  std::vector<uint_type> out (x.size ());
+  batch::addu<n> (x, y, out);
+  for (auto ctr = size_t{0}; ctr < x.size (); ++ctr) {
+    EXPECT_EQ (out[ctr], addu<n> (x[ctr], y[ctr])) << "index " << ctr;
+  }
+  batch::subu<n> (x, y, out);
+  for (auto ctr = size_t{0}; ctr < x.size (); ++ctr) {
+    EXPECT_EQ (out[ctr], subu<n> (x[ctr], y[ctr])) << "index " << ctr;
+  }
+}
+TYPED_TEST_P (Batch, InPlace) {
+  constexpr auto n = TypeParam::value;
+  using sint_type = sinteger_t<n>;
+  auto x = make_values<sint_type, n> (100U, 11U);
+  auto const y = make_values<sint_type, n> (100U, 12U);
+  auto const original = x;
+  batch::adds<n> (x, y, x);
+  for (auto ctr = size_t{0}; ctr < x.size (); ++ctr) {
+    EXPECT_EQ (x[ctr], adds<n> (original[ctr], y[ctr])) << "index " << ctr;
+  }
+}
+
+REGISTER_TYPED_TEST_SUITE_P (Batch, UnsignedAdd, SignedAdd, UnsignedSubtract,
+                             SignedSubtract, UnsignedMultiply, SignedMultiply,
+                             UnsignedDivide, SignedDivide, UnsignedDivideByZero,
+                             SignedDivideByZero, Public, InPlace);
+template <unsigned Value>
+using unsigned_constant = std::integral_constant<unsigned, Value>;
+using batch_width_types =
+    testing::Types<unsigned_constant<8U>, unsigned_constant<16U>,
+                   unsigned_constant<32U>, unsigned_constant<64U>>;
+INSTANTIATE_TYPED_TEST_SUITE_P (ExplicitWidths, Batch, batch_width_types, );
+// Widths whose values do not fill their lanes.
+using padded_width_types =
+    testing::Types<unsigned_constant<4U>, unsigned_constant<7U>,
+                   unsigned_constant<12U>, unsigned_constant<14U>,
+                   unsigned_constant<15U>, unsigned_constant<24U>,
+                   unsigned_constant<31U>>;
+INSTANTIATE_TYPED_TEST_SUITE_P (PaddedWidths, Batch, padded_width_types, );
+
+TEST (BatchTypeDriven, AddAndSubtract) {
+  std::array<int16_t, 5> const x{{0, 1, -32768, 32767, 100}};
+  std::array<int16_t, 5> const y{{0, -1, -1, 1, -200}};
+  std::array<int16_t, 5> out{};
+  batch::add<int16_t> (x, y, out);
+  EXPECT_EQ (out, (std::array<int16_t, 5>{{0, 0, -32768, 32767, -100}}));
+  batch::sub<int16_t> (x, y, out);
+  EXPECT_EQ (out, (std::array<int16_t, 5>{{0, 2, -32767, 32766, 300}}));
+
+  std::array<uint8_t, 3> const ux{{0, 200, 255}};
+  std::array<uint8_t, 3> const uy{{1, 100, 0}};
+  std::array<uint8_t, 3> uout{};
+  batch::add (span<uint8_t const>{ux}, span<uint8_t const>{uy},
+              span<uint8_t>{uout});
+  EXPECT_EQ (uout, (std::array<uint8_t, 3>{{1, 255, 255}}));
+  batch::sub (span<uint8_t const>{ux}, span<uint8_t const>{uy},
+              span<uint8_t>{uout});
+  EXPECT_EQ (uout, (std::array<uint8_t, 3>{{0, 100, 255}}));
+  batch::mul<uint8_t> (ux, uy, uout);
+  EXPECT_EQ (uout, (std::array<uint8_t, 3>{{0, 255, 0}}));
+  std::array<int16_t, 5> const divisors{{1, -1, -1, 2, -3}};
+  batch::div<int16_t> (x, divisors, out);
+  EXPECT_EQ (out, (std::array<int16_t, 5>{{0, -1, 32767, 16383, -33}}));
+  std::array<int16_t, 5> const zeros{{0, 0, 0, 0, 2}};
+  batch::div<int16_t, divide_by_zero::saturate> (x, zeros, out);
+  EXPECT_EQ (out, (std::array<int16_t, 5>{{0, 32767, -32768, 32767, 50}}));
+}
+
+#if !defined(NO_SIMD) && defined(__GNUC__) && defined(__x86_64__)
+TEST (BatchPadded, VectorKernels) {
+  using details::batch_op;
+  using details::batch_scalar;
+  using details::resolve_kernel;
+  EXPECT_NE ((resolve_kernel<batch_op::addu, 12> (isa::sse2)),
+             (&batch_scalar<batch_op::addu, 12>));
+  EXPECT_NE ((resolve_kernel<batch_op::subs, 24> (isa::sse2)),
+             (&batch_scalar<batch_op::subs, 24>));
+  EXPECT_NE ((resolve_kernel<batch_op::adds, 7> (isa::sse2)),
+             (&batch_scalar<batch_op::adds, 7>));
+  // There are no vector kernels for values wider than 32 bits which do not
+  // fill a 64 bit lane.
+  EXPECT_EQ ((resolve_kernel<batch_op::addu, 48> (isa::sse2)),
+             (&batch_scalar<batch_op::addu, 48>));
+}
+#endif  // !NO_SIMD && __GNUC__ && __x86_64__
+
+TEST (Isa, Override) {
+  using details::apply_isa_override;
+  EXPECT_EQ (apply_isa_override (nullptr, isa::avx2), isa::avx2);
+  EXPECT_EQ (apply_isa_override ("", isa::avx2), isa::avx2);
+  EXPECT_EQ (apply_isa_override ("bogus", isa::avx2), isa::avx2);
+  EXPECT_EQ (apply_isa_override ("scalar", isa::avx2), isa::scalar);
+  EXPECT_EQ (apply_isa_override ("sse2", isa::avx2), isa::sse2);
+  EXPECT_EQ (apply_isa_override ("avx2", isa::avx2), isa::avx2);
+  EXPECT_EQ (apply_isa_override ("avx512", isa::avx2), isa::avx2);
+  EXPECT_EQ (apply_isa_override ("avx512", isa::avx512), isa::avx512);
+  EXPECT_LE (selected_isa (), detected_isa ());
+}
@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+
+#include <array>
+
+#include "saturation/saturation.hpp"
+#include "saturation/wide_int.hpp"
+
+using namespace saturation;
+
+#if SATURATION_HAVE_CONSTEXPR_ASM
+
+namespace {
+
+// Each of the functions which may be implemented with inline assembler can
+// be constant evaluated.
+static_assert (addu<8> (200U, 100U) == 255U);
+static_assert (addu<16> (65535U, 1U) == 65535U);
+static_assert (addu<32> (1U, 2U) == 3U);
+static_assert (addu<64> (ulimits<64>::max (), 1U) == ulimits<64>::max ());
+static_assert (adds<16> (32767, 1) == 32767);
+static_assert (adds<32> (slimits<32>::min (), -1) == slimits<32>::min ());
+static_assert (adds<64> (slimits<64>::max (), 1) == slimits<64>::max ());
+static_assert (subu<16> (1U, 2U) == 0U);
+static_assert (subu<32> (5U, 2U) == 3U);
+static_assert (subu<64> (0U, 1U) == 0U);
+static_assert (mulu<8> (16U, 16U) == 255U);
+static_assert (mulu<16> (256U, 255U) == 65280U);
+static_assert (mulu<32> (65536U, 65536U) == ulimits<32>::max ());
+static_assert (mulu<64> (uint64_t{1} << 32U, uint64_t{1} << 32U) ==
+               ulimits<64>::max ());
+static_assert (muls<16> (-256, 256) == -32768);
+static_assert (muls<32> (-65536, -65536) == slimits<32>::max ());
+static_assert (muls<64> (slimits<64>::min (), -1) == slimits<64>::max ());
+static_assert (addu8 (255U, 1U) == 255U);
+static_assert (adds16 (-32768, -1) == -32768);
+static_assert (subu32 (0U, 1U) == 0U);
+static_assert (muls32 (46341, 46341) == slimits<32>::max ());
+#if HAVE_INT128
+static_assert (addu<128> (ulimits<128>::max (), 1U) == ulimits<128>::max ());
+static_assert (adds<128> (slimits<128>::min (), -1) == slimits<128>::min ());
+static_assert (subu<128> (0U, 1U) == 0U);
+static_assert (subs<128> (slimits<128>::min (), 1) == slimits<128>::min ());
+#endif  // HAVE_INT128
+
+static_assert (addu (wide_uint<192>::max (), wide_uint<192>{1U}) ==
+               wide_uint<192>::max ());
+static_assert (subs (wide_int<256>::min (), wide_int<256>{1}) ==
+               wide_int<256>::min ());
+static_assert (muls (wide_int<128>{-3}, wide_int<128>{5}) ==
+               wide_int<128>{-15});
+
+/// A gain curve of the sort which would otherwise be computed at startup:
+/// \p count samples of a 16 bit ramp scaled by \p gain.
+template <size_t Count>
+constexpr std::array<int16_t, Count> make_gain_table (int16_t const gain) {
+  std::array<int16_t, Count> result{};
+  auto sample = int16_t{0};
+  for (auto& v : result) {
+    v = muls<16> (sample, gain);
+    sample = adds<16> (sample, 1000);
+  }
+  return result;
+}
+
+constexpr auto gain_table = make_gain_table<64> (-3);
+
+}  // end anonymous namespace
+
+TEST (Constexpr, GainTable) {
+  auto sample = int16_t{0};
+  for (auto const v : gain_table) {
+    // Compare against the run-time (inline assembler) results.
+    EXPECT_EQ (v, muls<16> (sample, -3));
+    sample = adds<16> (sample, 1000);
+  }
+  EXPECT_EQ (gain_table.back (), slimits<16>::min ());
+}
+
+#endif  // SATURATION_HAVE_CONSTEXPR_ASM
@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+
+#include <random>
+
+#include "saturation/div.hpp"
+
+using namespace saturation;
+
+static_assert (details::divu_table<8> (255U, 1U) == 255U);
+static_assert (details::divs_table<8> (-128, -1) == 127);
+static_assert (details::divu_double<24> (0xFFFFFFU, 3U) == 0x555555U);
+static_assert (details::divs_double<24> (-0x800000, -1) == 0x7FFFFF);
+
+namespace {
+
+/// Checks the narrow division functions against the integer division
+/// instruction for each divisor in [\p first_y, \p last_y] and each dividend
+/// in [\p first_x, \p last_x] (stepping by \p step_x).
+template <size_t N, bool Table>
+void check_unsigned (uint32_t const first_y, uint32_t const last_y,
+                     uint32_t const step_x) {
+  using uint_type = uinteger_t<N>;
+  for (auto y = first_y; y <= last_y; ++y) {
+    auto const uy = static_cast<uint_type> (y);
+    for (auto x = uint32_t{0}; x <= ulimits<N>::max (); x += step_x) {
+      auto const ux = static_cast<uint_type> (x);
+      auto const expected = details::divu_hardware<N> (ux, uy);
+      if constexpr (Table) {
+        ASSERT_EQ (details::divu_table<N> (ux, uy), expected)
+            << "x " << x << " y " << y;
+      }
+      ASSERT_EQ (details::divu_double<N> (ux, uy), expected)
+          << "x " << x << " y " << y;
+    }
+  }
+}
+
+template <size_t N, bool Table>
+void check_signed (int32_t const first_y, int32_t const last_y,
+                   int32_t const step_x) {
+  using sint_type = sinteger_t<N>;
+  for (auto y = first_y; y <= last_y; ++y) {
+    if (y == 0) {
+      continue;
+    }
+    auto const sy = static_cast<sint_type> (y);
+    for (auto x = int32_t{slimits<N>::min ()}; x <= slimits<N>::max ();
+         x += step_x) {
+      auto const sx = static_cast<sint_type> (x);
+      auto const expected = details::divs_hardware<N> (sx, sy);
+      if constexpr (Table) {
+        ASSERT_EQ (details::divs_table<N> (sx, sy), expected)
+            << "x " << x << " y " << y;
+      }
+      ASSERT_EQ (details::divs_double<N> (sx, sy), expected)
+          << "x " << x << " y " << y;
+    }
+  }
+}
+
+}  // end anonymous namespace
+
+TEST (NarrowDivide, Exhaustive4) {
+  check_unsigned<4, true> (1U, ulimits<4>::max (), 1U);
+  check_signed<4, true> (slimits<4>::min (), slimits<4>::max (), 1);
+}
+TEST (NarrowDivide, Exhaustive8) {
+  check_unsigned<8, true> (1U, ulimits<8>::max (), 1U);
+  check_signed<8, true> (slimits<8>::min (), slimits<8>::max (), 1);
+}
+TEST (NarrowDivide, Exhaustive10) {
+  check_unsigned<10, false> (1U, ulimits<10>::max (), 1U);
+  check_signed<10, false> (slimits<10>::min (), slimits<10>::max (), 1);
+}
+TEST (NarrowDivide, 16) {
+  // Every divisor with a sample of dividends, then every dividend for a
+  // handful of small divisors.
+  check_unsigned<16, false> (1U, ulimits<16>::max (), 509U);
+  check_signed<16, false> (slimits<16>::min (), slimits<16>::max (), 509);
+  check_unsigned<16, false> (1U, 64U, 1U);
+  check_signed<16, false> (-64, 64, 1);
+}
+TEST (NarrowDivide, 24) {
+  check_unsigned<24, false> (1U, 64U, 1021U);
+  check_signed<24, false> (-64, 64, 1021);
+
+  std::mt19937 generator{24U};
+  std::uniform_int_distribution<uint32_t> udistribution{1U,
+                                                        ulimits<24>::max ()};
+  std::uniform_int_distribution<int32_t> sdistribution{slimits<24>::min (),
+                                                       slimits<24>::max ()};
+  for (auto ctr = 0; ctr < 100000; ++ctr) {
+    auto const ux = udistribution (generator);
+    auto const uy = udistribution (generator) >> (ctr % 24);
+    if (uy != 0U) {
+      ASSERT_EQ (details::divu_double<24> (ux, uy),
+                 details::divu_hardware<24> (ux, uy))
+          << "x " << ux << " y " << uy;
+    }
+    auto const sx = sdistribution (generator);
+    auto const sy = sdistribution (generator) >> (ctr % 24);
+    if (sy != 0) {
+      ASSERT_EQ (details::divs_double<24> (sx, sy),
+                 details::divs_hardware<24> (sx, sy))
+          << "x " << sx << " y " << sy;
+    }
+  }
+}
@@ -0,0 +1,261 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "saturation/batch.hpp"
+#include "saturation/div_round.hpp"
+
+using namespace saturation;
+
+static_assert (divu_round<8, rounding::nearest> (7U, 2U) == 4U);
+static_assert (divu_round<8, rounding::ceil> (255U, 2U) == 128U);
+static_assert (divs_round<8, rounding::nearest> (-7, 2) == -4);
+static_assert (divs_round<8, rounding::floor> (-7, 2) == -4);
+static_assert (divs_round<8, rounding::ceil> (-7, 2) == -3);
+static_assert (divs_round<8, rounding::away_from_zero> (-128, -1) == 127);
+static_assert (divs_round<8, rounding::nearest> (-128, 3) == -43);
+
+namespace {
+
+/// Computes the expected value of \p x / \p y rounded according to \p Mode
+/// by correcting the truncated quotient with conventional (branching) code.
+template <size_t N, rounding Mode>
+int64_t expected_signed (int64_t const x, int64_t const y) {
+  if (x == slimits<N>::min () && y == -1) {
+    return slimits<N>::max ();
+  }
+  auto q = x / y;
+  auto const r = x % y;
+  if (r != 0) {
+    auto const negative = (r < 0) != (y < 0);
+    auto const away = negative ? int64_t{-1} : int64_t{1};
+    auto const abs_r = r < 0 ? 0U - static_cast<uint64_t> (r)
+                             : static_cast<uint64_t> (r);
+    auto const abs_y = y < 0 ? 0U - static_cast<uint64_t> (y)
+                             : static_cast<uint64_t> (y);
+    switch (Mode) {
+    case rounding::toward_zero: break;
+    case rounding::floor: q -= negative ? 1 : 0; break;
+    case rounding::ceil: q += negative ? 0 : 1; break;
+    case rounding::away_from_zero: q += away; break;
+    case rounding::nearest: q += abs_r >= abs_y - abs_r ? away : 0; break;
+    }
+  }
+  return q;
+}
+template <size_t N, rounding Mode>
+uint64_t expected_unsigned (uint64_t const x, uint64_t const y) {
+  auto q = x / y;
+  auto const r = x % y;
+  if (r != 0U) {
+    switch (Mode) {
+    case rounding::toward_zero:
+    case rounding::floor: break;
+    case rounding::ceil:
+    case rounding::away_from_zero: ++q; break;
+    case rounding::nearest: q += r >= y - r ? 1U : 0U; break;
+    }
+  }
+  return q;
+}
+
+/// Returns the edge-case values of \p N bits together with \p count
+/// pseudo-random values.
+template <size_t N, bool IsSigned>
+std::vector<std::conditional_t<IsSigned, sinteger_t<N>, uinteger_t<N>>>
+make_values (size_t const count, unsigned const seed) {
+  using value_type =
+      std::conditional_t<IsSigned, sinteger_t<N>, uinteger_t<N>>;
+  using wide_type = std::conditional_t<IsSigned, int64_t, uint64_t>;
+  constexpr auto min =
+      IsSigned ? wide_type (slimits<N>::min ()) : wide_type (0);
+  constexpr auto max = IsSigned ? wide_type (slimits<N>::max ())
+                                : wide_type (ulimits<N>::max ());
+  std::vector<value_type> result;
+  for (auto ctr = wide_type (0); ctr < wide_type (8); ++ctr) {
+    result.push_back (static_cast<value_type> (min + ctr));
+    result.push_back (static_cast<value_type> (max - ctr));
+    result.push_back (static_cast<value_type> (ctr));
+    if constexpr (IsSigned) {
+      result.push_back (static_cast<value_type> (-ctr));
+    }
+  }
+  std::mt19937_64 generator{seed};
+  std::uniform_int_distribution<wide_type> distribution{min, max};
+  for (auto ctr = size_t{0}; ctr < count; ++ctr) {
+    // Alternate full-width values with narrower ones so that the quotients
+    // are not mostly 0 or 1.
+    auto const v = distribution (generator);
+    result.push_back (
+        static_cast<value_type> (ctr % 2U == 0U ? v : v >> (ctr % N)));
+  }
+  return result;
+}
+
+/// Returns every value of \p N bits.
+template <size_t N, bool IsSigned>
+std::vector<std::conditional_t<IsSigned, sinteger_t<N>, uinteger_t<N>>>
+all_values () {
+  using value_type =
+      std::conditional_t<IsSigned, sinteger_t<N>, uinteger_t<N>>;
+  std::vector<value_type> result;
+  auto v = IsSigned ? int64_t{slimits<N>::min ()} : int64_t{0};
+  auto const last =
+      IsSigned ? int64_t{slimits<N>::max ()} : int64_t{ulimits<N>::max ()};
+  for (; v <= last; ++v) {
+    result.push_back (static_cast<value_type> (v));
+  }
+  return result;
+}
+
+/// Checks the scalar and divider forms of divu_round<N, Mode>() for each
+/// combination of \p dividends and \p divisors.
+template <size_t N, rounding Mode>
+void check_unsigned (std::vector<uinteger_t<N>> const& dividends,
+                     std::vector<uinteger_t<N>> const& divisors) {
+  for (auto const y : divisors) {
+    if (y == 0U) {
+      continue;
+    }
+    divider<N, false> const d{y};
+    for (auto const x : dividends) {
+      auto const expected =
+          static_cast<uinteger_t<N>> (expected_unsigned<N, Mode> (x, y));
+      ASSERT_EQ ((divu_round<N, Mode> (x, y)), expected)
+          << "x " << +x << " y " << +y;
+      ASSERT_EQ ((divu_round<N, Mode> (x, d)), expected)
+          << "x " << +x << " y " << +y;
+    }
+  }
+}
+/// Checks the scalar and divider forms of divs_round<N, Mode>() for each
+/// combination of \p dividends and \p divisors.
+template <size_t N, rounding Mode>
+void check_signed (std::vector<sinteger_t<N>> const& dividends,
+                   std::vector<sinteger_t<N>> const& divisors) {
+  for (auto const y : divisors) {
+    if (y == 0) {
+      continue;
+    }
+    divider<N, true> const d{y};
+    for (auto const x : dividends) {
+      auto const expected =
+          static_cast<sinteger_t<N>> (expected_signed<N, Mode> (x, y));
+      ASSERT_EQ ((divs_round<N, Mode> (x, y)), expected)
+          << "x " << +x << " y " << +y;
+      ASSERT_EQ ((divs_round<N, Mode> (x, d)), expected)
+          << "x " << +x << " y " << +y;
+    }
+  }
+}
+
+template <size_t N>
+void check_exhaustive () {
+  auto const uvalues = all_values<N, false> ();
+  auto const svalues = all_values<N, true> ();
+  check_unsigned<N, rounding::toward_zero> (uvalues, uvalues);
+  check_unsigned<N, rounding::floor> (uvalues, uvalues);
+  check_unsigned<N, rounding::ceil> (uvalues, uvalues);
+  check_unsigned<N, rounding::away_from_zero> (uvalues, uvalues);
+  check_unsigned<N, rounding::nearest> (uvalues, uvalues);
+  check_signed<N, rounding::toward_zero> (svalues, svalues);
+  check_signed<N, rounding::floor> (svalues, svalues);
+  check_signed<N, rounding::ceil> (svalues, svalues);
+  check_signed<N, rounding::away_from_zero> (svalues, svalues);
+  check_signed<N, rounding::nearest> (svalues, svalues);
+}
+template <size_t N>
+void check_sample () {
+  auto const ux = make_values<N, false> (300, N);
+  auto const uy = make_values<N, false> (300, N + 1U);
+  auto const sx = make_values<N, true> (300, N + 2U);
+  auto const sy = make_values<N, true> (300, N + 3U);
+  check_unsigned<N, rounding::toward_zero> (ux, uy);
+  check_unsigned<N, rounding::floor> (ux, uy);
+  check_unsigned<N, rounding::ceil> (ux, uy);
+  check_unsigned<N, rounding::away_from_zero> (ux, uy);
+  check_unsigned<N, rounding::nearest> (ux, uy);
+  check_signed<N, rounding::toward_zero> (sx, sy);
+  check_signed<N, rounding::floor> (sx, sy);
+  check_signed<N, rounding::ceil> (sx, sy);
+  check_signed<N, rounding::away_from_zero> (sx, sy);
+  check_signed<N, rounding::nearest> (sx, sy);
+}
+
+/// Checks the batch forms of divu_round<N, Mode>() and divs_round<N, Mode>()
+/// including in-place operation.
+template <size_t N, rounding Mode>
+void check_batch () {
+  auto const ux = make_values<N, false> (1000, 1U);
+  auto uy = make_values<N, false> (1000, 2U);
+  std::replace (uy.begin (), uy.end (), uinteger_t<N>{0}, uinteger_t<N>{1});
+  std::vector<uinteger_t<N>> uout (ux.size ());
+  batch::divu_round<N, Mode> (ux, uy, uout);
+  for (auto ctr = size_t{0}; ctr < ux.size (); ++ctr) {
+    EXPECT_EQ (uout[ctr], (divu_round<N, Mode> (ux[ctr], uy[ctr])))
+        << "index " << ctr;
+  }
+  uout = ux;
+  divider<N, false> const ud{7U};
+  batch::divu_round<N, Mode> (uout, ud, uout);
+  for (auto ctr = size_t{0}; ctr < ux.size (); ++ctr) {
+    EXPECT_EQ (uout[ctr], (divu_round<N, Mode> (ux[ctr], 7U)))
+        << "index " << ctr;
+  }
+
+  auto const sx = make_values<N, true> (1000, 3U);
+  auto sy = make_values<N, true> (1000, 4U);
+  std::replace (sy.begin (), sy.end (), sinteger_t<N>{0}, sinteger_t<N>{-1});
+  auto sout = sx;
+  batch::divs_round<N, Mode> (sout, sy, sout);
+  for (auto ctr = size_t{0}; ctr < sx.size (); ++ctr) {
+    EXPECT_EQ (sout[ctr], (divs_round<N, Mode> (sx[ctr], sy[ctr])))
+        << "index " << ctr;
+  }
+  divider<N, true> const sd{-6};
+  batch::divs_round<N, Mode> (sx, sd, sout);
+  for (auto ctr = size_t{0}; ctr < sx.size (); ++ctr) {
+    EXPECT_EQ (sout[ctr], (divs_round<N, Mode> (sx[ctr], -6)))
+        << "index " << ctr;
+  }
+}
+template <size_t N>
+void check_batch_modes () {
+  check_batch<N, rounding::toward_zero> ();
+  check_batch<N, rounding::floor> ();
+  check_batch<N, rounding::ceil> ();
+  check_batch<N, rounding::away_from_zero> ();
+  check_batch<N, rounding::nearest> ();
+}
+
+}  // end anonymous namespace
+
+TEST (DivideRound, Exhaustive4) {
+  check_exhaustive<4> ();
+}
+TEST (DivideRound, Exhaustive8) {
+  check_exhaustive<8> ();
+}
+TEST (DivideRound, 12) {
+  check_sample<12> ();
+}
+TEST (DivideRound, 16) {
+  check_sample<16> ();
+}
+TEST (DivideRound, 32) {
+  check_sample<32> ();
+}
+TEST (DivideRound, 48) {
+  check_sample<48> ();
+}
+TEST (DivideRound, 64) {
+  check_sample<64> ();
+}
+TEST (DivideRound, Batch) {
+  check_batch_modes<8> ();
+  check_batch_modes<16> ();
+  check_batch_modes<32> ();
+  check_batch_modes<64> ();
+}
@@ -0,0 +1,273 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "saturation/div.hpp"
+#include "saturation/divider.hpp"
+
+using namespace saturation;
+
+static_assert (divider<8, false>{3U} (200U) == 66U);
+static_assert (divider<8, true>{-1} (-128) == 127);
+static_assert (divider<12, true>{-1} (-2048) == 2047);
+static_assert (divu<8, 3U> (200U) == 66U);
+static_assert (divs<8, -1> (-128) == 127);
+static_assert (divs<8, -128> (-128) == 1);
+static_assert (divs<64, 7> (-15) == -2);
+
+namespace {
+
+/// Returns the interesting edge-case values of \p N bits together with
+/// \p count pseudo-random values.
+template <size_t N, bool IsSigned>
+std::vector<std::conditional_t<IsSigned, sinteger_t<N>, uinteger_t<N>>>
+make_values (size_t const count, unsigned const seed) {
+  using value_type =
+      std::conditional_t<IsSigned, sinteger_t<N>, uinteger_t<N>>;
+  using wide_type = std::conditional_t<IsSigned, int64_t, uint64_t>;
+  constexpr auto min = static_cast<wide_type> (
+      IsSigned ? wide_type (slimits<N>::min ()) : wide_type (0));
+  constexpr auto max =
+      static_cast<wide_type> (IsSigned ? wide_type (slimits<N>::max ())
+                                       : wide_type (ulimits<N>::max ()));
+  std::vector<value_type> result;
+  for (auto const v : {wide_type (0), wide_type (1), wide_type (2),
+                       wide_type (3), min, wide_type (min + 1), max,
+                       wide_type (max - 1), wide_type (max / 2),
+                       wide_type (min / 2)}) {
+    result.push_back (static_cast<value_type> (v));
+  }
+  if constexpr (IsSigned) {
+    result.push_back (static_cast<value_type> (-1));
+    result.push_back (static_cast<value_type> (-2));
+  }
+  for (auto shift = 1U; shift < N; ++shift) {
+    auto const pow2 = static_cast<wide_type> (wide_type (1) << shift);
+    if (pow2 <= max) {
+      result.push_back (static_cast<value_type> (pow2));
+      result.push_back (static_cast<value_type> (pow2 - 1));
+      result.push_back (static_cast<value_type> (pow2 + 1));
+      if constexpr (IsSigned) {
+        result.push_back (static_cast<value_type> (-pow2));
+      }
+    }
+  }
+  std::mt19937_64 generator{seed};
+  std::uniform_int_distribution<wide_type> distribution{min, max};
+  for (auto ctr = size_t{0}; ctr < count; ++ctr) {
+    result.push_back (static_cast<value_type> (distribution (generator)));
+  }
+  return result;
+}
+
+template <size_t N>
+void check_unsigned (std::vector<uinteger_t<N>> const& divisors,
+                     std::vector<uinteger_t<N>> const& dividends) {
+  for (auto const d : divisors) {
+    if (d == 0U) {
+      continue;
+    }
+    divider<N, false> const divide{d};
+    for (auto const x : dividends) {
+      ASSERT_EQ (divide (x), divu<N> (x, d)) << "x " << +x << " d " << +d;
+    }
+  }
+}
+
+template <size_t N>
+void check_signed (std::vector<sinteger_t<N>> const& divisors,
+                   std::vector<sinteger_t<N>> const& dividends) {
+  for (auto const d : divisors) {
+    if (d == 0) {
+      continue;
+    }
+    divider<N, true> const divide{d};
+    for (auto const x : dividends) {
+      ASSERT_EQ (divide (x), divs<N> (x, d)) << "x " << +x << " d " << +d;
+    }
+  }
+}
+
+/// Returns every value of \p N bits.
+template <size_t N, bool IsSigned>
+std::vector<std::conditional_t<IsSigned, sinteger_t<N>, uinteger_t<N>>>
+all_values () {
+  using value_type =
+      std::conditional_t<IsSigned, sinteger_t<N>, uinteger_t<N>>;
+  std::vector<value_type> result;
+  auto v = IsSigned ? int64_t{slimits<N>::min ()} : int64_t{0};
+  auto const last =
+      IsSigned ? int64_t{slimits<N>::max ()} : int64_t{ulimits<N>::max ()};
+  for (; v <= last; ++v) {
+    result.push_back (static_cast<value_type> (v));
+  }
+  return result;
+}
+
+/// Returns candidate divisors for tests of division of \p N bit unsigned
+/// values by a constant. Those which are out of range are skipped.
+template <size_t N>
+constexpr std::array<uint64_t, 28> unsigned_divisors () {
+  constexpr auto max = uint64_t{ulimits<N>::max ()};
+  return {{1U, 2U, 3U, 5U, 6U, 7U, 9U, 10U, 12U, 25U, 60U, 100U, 641U, 1000U,
+           7919U, 65537U, 0x7FFFFFFFU, 6700417U, 1000000007U, 0x100000001U,
+           0xAAAAAAAAAAAAAAABU, 0x8000000000000001U, 0xFFFFFFFFFFFFFFF0U,
+           max, max - 1U, max / 3U, (max >> 1U) + 2U, (max >> 1U) - 1U}};
+}
+/// Returns candidate divisors for tests of division of \p N bit signed values
+/// by a constant. Those which are out of range are skipped.
+template <size_t N>
+constexpr std::array<int64_t, 28> signed_divisors () {
+  constexpr auto max = int64_t{slimits<N>::max ()};
+  constexpr auto min = int64_t{slimits<N>::min ()};
+  return {{1, -1, 2, -2, 3, -3, 5, -7, 10, -10, 641, -1000, 7919, 1000000007,
+           -6700417, 0x5555555555555555, -0x2AAAAAAAAAAAAAAB,
+           0x4000000000000001,
+           max, min, min + 1, max - 1, max / 3, -(max / 3), (max >> 1) + 2,
+           -(max >> 1) - 2, min / 2, (max >> 1) - 1}};
+}
+
+template <size_t N, uint64_t D>
+void check_constant_unsigned (std::vector<uinteger_t<N>> const& dividends) {
+  if constexpr (D != 0U && D <= ulimits<N>::max ()) {
+    constexpr auto d = static_cast<uinteger_t<N>> (D);
+    for (auto const x : dividends) {
+      ASSERT_EQ ((divu<N, d> (x)), divu<N> (x, d)) << "x " << +x << " d " << +d;
+    }
+  }
+}
+template <size_t N, int64_t D>
+void check_constant_signed (std::vector<sinteger_t<N>> const& dividends) {
+  if constexpr (D != 0 && D >= slimits<N>::min () &&
+                D <= slimits<N>::max ()) {
+    constexpr auto d = static_cast<sinteger_t<N>> (D);
+    for (auto const x : dividends) {
+      ASSERT_EQ ((divs<N, d> (x)), divs<N> (x, d)) << "x " << +x << " d " << +d;
+    }
+  }
+}
+
+/// Checks division of every \p N bit value by every \p N bit constant.
+template <size_t N, size_t... Is>
+void check_all_constants (std::index_sequence<Is...>) {
+  auto const udividends = all_values<N, false> ();
+  (check_constant_unsigned<N, Is> (udividends), ...);
+  auto const sdividends = all_values<N, true> ();
+  (check_constant_signed<N, static_cast<int64_t> (Is) + slimits<N>::min ()> (
+       sdividends),
+   ...);
+}
+/// Checks division of a selection of \p N bit values by a selection of
+/// constants.
+template <size_t N, size_t... Is>
+void check_constants (std::index_sequence<Is...>) {
+  constexpr auto udivisors = unsigned_divisors<N> ();
+  auto const udividends = make_values<N, false> (200, N);
+  (check_constant_unsigned<N, udivisors[Is]> (udividends), ...);
+  constexpr auto sdivisors = signed_divisors<N> ();
+  auto const sdividends = make_values<N, true> (200, N + 1U);
+  (check_constant_signed<N, sdivisors[Is]> (sdividends), ...);
+}
+
+}  // end anonymous namespace
+
+TEST (Divider, Exhaustive4) {
+  check_unsigned<4> (all_values<4, false> (), all_values<4, false> ());
+  check_signed<4> (all_values<4, true> (), all_values<4, true> ());
+}
+TEST (Divider, Exhaustive8) {
+  check_unsigned<8> (all_values<8, false> (), all_values<8, false> ());
+  check_signed<8> (all_values<8, true> (), all_values<8, true> ());
+}
+TEST (Divider, Exhaustive10) {
+  check_unsigned<10> (all_values<10, false> (), all_values<10, false> ());
+  check_signed<10> (all_values<10, true> (), all_values<10, true> ());
+}
+TEST (Divider, AllDivisors16) {
+  check_unsigned<16> (all_values<16, false> (),
+                      make_values<16, false> (64, 1));
+  check_signed<16> (all_values<16, true> (), make_values<16, true> (64, 2));
+}
+TEST (Divider, 24) {
+  check_unsigned<24> (make_values<24, false> (500, 3),
+                      make_values<24, false> (500, 4));
+  check_signed<24> (make_values<24, true> (500, 5),
+                    make_values<24, true> (500, 6));
+}
+TEST (Divider, 32) {
+  check_unsigned<32> (make_values<32, false> (500, 7),
+                      make_values<32, false> (500, 8));
+  check_signed<32> (make_values<32, true> (500, 9),
+                    make_values<32, true> (500, 10));
+}
+TEST (Divider, 48) {
+  check_unsigned<48> (make_values<48, false> (500, 11),
+                      make_values<48, false> (500, 12));
+  check_signed<48> (make_values<48, true> (500, 13),
+                    make_values<48, true> (500, 14));
+}
+TEST (Divider, 64) {
+  check_unsigned<64> (make_values<64, false> (500, 15),
+                      make_values<64, false> (500, 16));
+  check_signed<64> (make_values<64, true> (500, 17),
+                    make_values<64, true> (500, 18));
+}
+TEST (Divider, Overloads) {
+  EXPECT_EQ (divu (uint16_t{1000}, divider<16, false>{7U}), 142U);
+  EXPECT_EQ (divs (int16_t{-1000}, divider<16, true>{7}), -142);
+  EXPECT_EQ (divs (int16_t{-32768}, divider<16, true>{-1}), 32767);
+  EXPECT_EQ ((divider<32, true>{-7}.divisor ()), -7);
+}
+TEST (Divider, Batch) {
+  auto const x = make_values<32, true> (100, 19);
+  std::vector<int32_t> out (x.size ());
+  divider<32, true> const d{-10};
+  batch::divs<32> (x, d, out);
+  for (auto ctr = size_t{0}; ctr < x.size (); ++ctr) {
+    EXPECT_EQ (out[ctr], divs<32> (x[ctr], -10)) << "index " << ctr;
+  }
+
+  auto ux = make_values<8, false> (100, 20);
+  auto const original = ux;
+  batch::divu<8> (ux, divider<8, false>{3U}, ux);
+  for (auto ctr = size_t{0}; ctr < ux.size (); ++ctr) {
+    EXPECT_EQ (ux[ctr], divu<8> (original[ctr], 3U)) << "index " << ctr;
+  }
+}
+
+TEST (ConstantDivisor, Exhaustive4) {
+  check_all_constants<4> (std::make_index_sequence<16> ());
+}
+TEST (ConstantDivisor, Exhaustive8) {
+  check_all_constants<8> (std::make_index_sequence<256> ());
+}
+TEST (ConstantDivisor, 12) {
+  check_constants<12> (std::make_index_sequence<28> ());
+}
+TEST (ConstantDivisor, 16) {
+  check_constants<16> (std::make_index_sequence<28> ());
+}
+TEST (ConstantDivisor, 24) {
+  check_constants<24> (std::make_index_sequence<28> ());
+}
+TEST (ConstantDivisor, 31) {
+  check_constants<31> (std::make_index_sequence<28> ());
+}
+TEST (ConstantDivisor, 32) {
+  check_constants<32> (std::make_index_sequence<28> ());
+}
+TEST (ConstantDivisor, 33) {
+  check_constants<33> (std::make_index_sequence<28> ());
+}
+TEST (ConstantDivisor, 48) {
+  check_constants<48> (std::make_index_sequence<28> ());
+}
+TEST (ConstantDivisor, 63) {
+  check_constants<63> (std::make_index_sequence<28> ());
+}
+TEST (ConstantDivisor, 64) {
+  check_constants<64> (std::make_index_sequence<28> ());
+}
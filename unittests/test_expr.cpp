@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+
+#include <random>
+#include <type_traits>
+#include <vector>
+
+#include "saturation/expr.hpp"
+
+using namespace saturation;
+
+namespace {
+
+/// Returns \p count pseudo-random values of \p N bits.
+template <size_t N, bool IsSigned>
+auto make_values (size_t const count, unsigned const seed) {
+  using value_type = std::conditional_t<IsSigned, sinteger_t<N>, uinteger_t<N>>;
+  using wide_type = std::conditional_t<IsSigned, int64_t, uint64_t>;
+  constexpr auto min =
+      IsSigned ? wide_type (slimits<N>::min ()) : wide_type (0);
+  constexpr auto max = IsSigned ? wide_type (slimits<N>::max ())
+                                : wide_type (ulimits<N>::max ());
+  std::vector<value_type> result{static_cast<value_type> (min),
+                                 static_cast<value_type> (max),
+                                 value_type{0}, value_type{1}};
+  std::mt19937_64 generator{seed};
+  std::uniform_int_distribution<wide_type> distribution{min, max};
+  while (result.size () < count) {
+    result.push_back (static_cast<value_type> (distribution (generator)));
+  }
+  return result;
+}
+
+template <size_t N>
+void check_gain_mix () {
+  auto const a = make_values<N, true> (1000U, 1U);
+  auto const b = make_values<N, true> (1000U, 2U);
+  auto const c = make_values<N, true> (1000U, 3U);
+  constexpr auto gain = sinteger_t<N>{3};
+  std::vector<sinteger_t<N>> out (a.size ());
+  expr::assign (out, expr::input<N> (a) * gain + expr::input<N> (b) -
+                           expr::input<N> (c));
+  for (auto ctr = size_t{0}; ctr < a.size (); ++ctr) {
+    ASSERT_EQ (out[ctr],
+               subs<N> (adds<N> (muls<N> (a[ctr], gain), b[ctr]), c[ctr]))
+        << "index " << ctr;
+  }
+}
+
+}  // end anonymous namespace
+
+TEST (Expr, GainMix) {
+  check_gain_mix<8> ();
+  check_gain_mix<12> ();
+  check_gain_mix<16> ();
+  check_gain_mix<24> ();
+  check_gain_mix<32> ();
+  check_gain_mix<64> ();
+}
+TEST (Expr, Unsigned) {
+  auto const a = make_values<16, false> (500U, 4U);
+  auto const b = make_values<16, false> (500U, 5U);
+  std::vector<uint16_t> out (a.size ());
+  // A constant may be either operand.
+  expr::assign (out, 2U * (expr::input<16> (a) - expr::input<16> (b)) + 7U);
+  for (auto ctr = size_t{0}; ctr < a.size (); ++ctr) {
+    ASSERT_EQ (out[ctr],
+               addu<16> (mulu<16> (2U, subu<16> (a[ctr], b[ctr])), 7U))
+        << "index " << ctr;
+  }
+}
+TEST (Expr, InPlace) {
+  auto a = make_values<16, true> (300U, 6U);
+  auto const original = a;
+  auto const x = expr::input<16> (a);
+  expr::assign (a, x * x - 100);
+  for (auto ctr = size_t{0}; ctr < a.size (); ++ctr) {
+    ASSERT_EQ (a[ctr], subs<16> (muls<16> (original[ctr], original[ctr]), 100))
+        << "index " << ctr;
+  }
+}
+TEST (Expr, Empty) {
+  std::vector<int32_t> const in;
+  std::vector<int32_t> out;
+  expr::assign (out, expr::input<32> (in) + 1);
+  EXPECT_TRUE (out.empty ());
+}
+TEST (Expr, ConstantSaturates) {
+  std::vector<int16_t> const a{-3, -1, 0, 1, 2, 1000};
+  std::vector<int16_t> out (a.size ());
+  // 70000 does not fit in 16 bits: it is clamped to 32767 rather than
+  // wrapping to 4464.
+  expr::assign (out, expr::input<16> (a) * 70000);
+  for (auto ctr = size_t{0}; ctr < a.size (); ++ctr) {
+    ASSERT_EQ (out[ctr], muls<16> (a[ctr], 32767)) << "index " << ctr;
+  }
+  expr::assign (out, expr::input<16> (a) + (-70000));
+  for (auto ctr = size_t{0}; ctr < a.size (); ++ctr) {
+    ASSERT_EQ (out[ctr], adds<16> (a[ctr], -32768)) << "index " << ctr;
+  }
+
+  std::vector<uint16_t> const b{0U, 1U, 2U, 65535U};
+  std::vector<uint16_t> uout (b.size ());
+  // A negative constant is clamped to 0 for an unsigned expression.
+  expr::assign (uout, expr::input<16> (b) * -1);
+  for (auto const v : uout) {
+    ASSERT_EQ (v, 0U);
+  }
+  expr::assign (uout, expr::input<16> (b) + 0x10001U);
+  for (auto const v : uout) {
+    ASSERT_EQ (v, 65535U);
+  }
+
+  // The range of a width which is not register-sized is that of the width.
+  std::vector<int16_t> const c{1, -2};
+  std::vector<int16_t> narrow_out (c.size ());
+  expr::assign (narrow_out, expr::input<12> (c) * 5000);
+  EXPECT_EQ (narrow_out[0], slimits<12>::max ());
+  EXPECT_EQ (narrow_out[1], slimits<12>::min ());
+}
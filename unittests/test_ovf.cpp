@@ -0,0 +1,244 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdint>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+#include "saturation/batch.hpp"
+#include "saturation/wide_int.hpp"
+
+using namespace saturation;
+
+namespace {
+
+// Wide enough to hold the exact sum, difference or product of any two 64 bit
+// values.
+using wide_type = wide_int<192>;
+
+// Widths which are not register-sized are always constant evaluated with the
+// portable implementations.
+static_assert (addu_ovf<12> (4000U, 95U) ==
+               ovf_result<uint16_t>{ulimits<12>::max (), false});
+static_assert (addu_ovf<12> (4000U, 96U) ==
+               ovf_result<uint16_t>{ulimits<12>::max (), true});
+static_assert (adds_ovf<12> (-2000, -49) == ovf_result<int16_t>{-2048, true});
+static_assert (subu_ovf<24> (1U, 2U) == ovf_result<uint32_t>{0U, true});
+static_assert (subs_ovf<24> (-8388607, 1) ==
+               ovf_result<int32_t>{-8388608, false});
+static_assert (mulu_ovf<24> (4096U, 4096U) ==
+               ovf_result<uint32_t>{ulimits<24>::max (), true});
+static_assert (muls_ovf<12> (-64, 32) == ovf_result<int16_t>{-2048, false});
+static_assert (muls_ovf<12> (-64, -32) == ovf_result<int16_t>{2047, true});
+
+/// Returns \p count values of \p N bits: the edge cases followed by
+/// pseudo-random values, half of which are narrow so that products do not
+/// (almost) always saturate.
+template <typename T, size_t N>
+std::vector<T> make_values (size_t const count, unsigned const seed) {
+  constexpr auto is_unsigned = std::is_unsigned_v<T>;
+  constexpr auto min = static_cast<T> (is_unsigned ? ulimits<N>::min ()
+                                                   : slimits<N>::min ());
+  constexpr auto max = static_cast<T> (is_unsigned ? ulimits<N>::max ()
+                                                   : slimits<N>::max ());
+  std::vector<T> result{T{0},
+                        T{1},
+                        static_cast<T> (min + 1),
+                        min,
+                        static_cast<T> (max - 1),
+                        max,
+                        static_cast<T> (max / 2),
+                        static_cast<T> (min / 2)};
+  std::mt19937_64 generator{seed};
+  using uniform_type = std::conditional_t<is_unsigned, uint64_t, int64_t>;
+  std::uniform_int_distribution<uniform_type> distribution{min, max};
+  constexpr auto half = static_cast<uniform_type> (max >> (N / 2U));
+  std::uniform_int_distribution<uniform_type> narrow{
+      static_cast<uniform_type> (is_unsigned ? 0 : -half), half};
+  while (result.size () < count) {
+    auto& d = result.size () % 2U == 0U ? distribution : narrow;
+    result.push_back (static_cast<T> (d (generator)));
+  }
+  result.resize (count);
+  return result;
+}
+
+/// Returns \p v converted to wide_type.
+template <typename T>
+wide_type widen (T const v) {
+  if constexpr (std::is_signed_v<T>) {
+    return wide_type{static_cast<int64_t> (v)};
+  } else {
+    return wide_type{wide_type::limbs_type{{static_cast<uint64_t> (v)}}};
+  }
+}
+
+/// Returns true if the exact result of \p Op applied to \p x and \p y cannot
+/// be represented in \p N bits.
+template <details::batch_op Op, size_t N, typename T>
+bool exact_overflows (T const x, T const y) {
+  using details::batch_op;
+  auto const wx = widen (x);
+  auto const wy = widen (y);
+  // None of these can saturate in wide_type, so the result is exact.
+  wide_type exact;
+  if constexpr (Op == batch_op::addu || Op == batch_op::adds) {
+    exact = adds (wx, wy);
+  } else if constexpr (Op == batch_op::subu || Op == batch_op::subs) {
+    exact = subs (wx, wy);
+  } else {
+    exact = muls (wx, wy);
+  }
+  if constexpr (details::is_unsigned_op (Op)) {
+    return exact.is_negative () || exact > widen (ulimits<N>::max ());
+  } else {
+    return exact < widen (slimits<N>::min ()) ||
+           exact > widen (slimits<N>::max ());
+  }
+}
+
+/// Checks the scalar function which reports saturation for \p Op against the
+/// saturating function and an exact computation.
+template <details::batch_op Op, size_t N>
+void check_scalar () {
+  using arg_type = details::batch_arg_t<Op, N>;
+  auto const values = make_values<arg_type, N> (64U, N);
+  for (auto const x : values) {
+    for (auto const y : values) {
+      auto const [value, saturated] =
+          details::scalar_op<Op, N>::apply_ovf (x, y);
+      ASSERT_EQ (value, (details::scalar_op<Op, N>::apply (x, y)))
+          << "N " << N << " x " << +x << " y " << +y;
+      ASSERT_EQ (saturated, (exact_overflows<Op, N> (x, y)))
+          << "N " << N << " x " << +x << " y " << +y;
+    }
+  }
+}
+
+template <size_t N>
+void check_scalar_ops () {
+  check_scalar<details::batch_op::addu, N> ();
+  check_scalar<details::batch_op::adds, N> ();
+  check_scalar<details::batch_op::subu, N> ();
+  check_scalar<details::batch_op::subs, N> ();
+  check_scalar<details::batch_op::mulu, N> ();
+  check_scalar<details::batch_op::muls, N> ();
+}
+
+// The array lengths used by the batch tests: empty, shorter than a vector
+// register, a whole number of 64 bit mask words, and with partial final
+// registers and mask bytes.
+constexpr std::array<size_t, 7> lengths{{0U, 1U, 15U, 64U, 100U, 129U, 1027U}};
+
+/// Checks the kernels implementing \p Op on values of \p N bits with
+/// saturation reporting at each instruction set level supported by the host.
+template <details::batch_op Op, size_t N>
+void check_kernels (unsigned const seed) {
+  using arg_type = details::batch_arg_t<Op, N>;
+  for (auto const level : {isa::scalar, isa::sse2, isa::avx2, isa::avx512}) {
+    if (level > detected_isa ()) {
+      continue;
+    }
+    auto const kernel = details::resolve_ovf_kernel<Op, N> (level);
+    for (auto const length : lengths) {
+      auto const x = make_values<arg_type, N> (length, seed);
+      auto const y = make_values<arg_type, N> (length, seed + 1U);
+      std::vector<arg_type> out (length);
+      // Every byte of the mask is written: start with all bits set.
+      std::vector<uint8_t> clipped ((length + 7U) / 8U, uint8_t{0xFF});
+      kernel (x.data (), y.data (), out.data (), clipped.data (), length);
+      for (auto ctr = size_t{0}; ctr < length; ++ctr) {
+        auto const expected =
+            details::scalar_op<Op, N>::apply_ovf (x[ctr], y[ctr]);
+        auto const bit = (clipped[ctr / 8U] >> (ctr % 8U)) & 1U;
+        ASSERT_EQ (out[ctr], expected.value)
+            << "isa " << to_string (level) << " N " << N << " index " << ctr;
+        ASSERT_EQ (bit != 0U, expected.saturated)
+            << "isa " << to_string (level) << " N " << N << " index " << ctr
+            << " x " << +x[ctr] << " y " << +y[ctr];
+      }
+      if (length % 8U != 0U) {
+        EXPECT_EQ (clipped.back () >> (length % 8U), 0U)
+            << "isa " << to_string (level) << " N " << N << " length "
+            << length;
+      }
+    }
+  }
+}
+
+template <size_t N>
+void check_kernel_ops () {
+  check_kernels<details::batch_op::addu, N> (1U);
+  check_kernels<details::batch_op::adds, N> (3U);
+  check_kernels<details::batch_op::subu, N> (5U);
+  check_kernels<details::batch_op::subs, N> (7U);
+  check_kernels<details::batch_op::mulu, N> (9U);
+  check_kernels<details::batch_op::muls, N> (11U);
+}
+
+}  // end anonymous namespace
+
+TEST (Ovf, Edges) {
+  EXPECT_EQ (addu_ovf<32> (0xFFFFFFF0U, 0x10U),
+             (ovf_result<uint32_t>{0xFFFFFFFFU, true}));
+  EXPECT_EQ (addu_ovf<32> (0xFFFFFFF0U, 0x0FU),
+             (ovf_result<uint32_t>{0xFFFFFFFFU, false}));
+  EXPECT_EQ (adds_ovf<16> (30000, 10000), (ovf_result<int16_t>{32767, true}));
+  EXPECT_EQ (subu_ovf<64> (1U, 2U), (ovf_result<uint64_t>{0U, true}));
+  EXPECT_EQ (subs_ovf<8> (-100, 100), (ovf_result<int8_t>{-128, true}));
+  EXPECT_EQ (mulu_ovf<8> (15U, 17U), (ovf_result<uint8_t>{255U, false}));
+  EXPECT_EQ (mulu_ovf<8> (16U, 16U), (ovf_result<uint8_t>{255U, true}));
+  EXPECT_EQ (muls_ovf<64> (int64_t{1} << 40, -(int64_t{1} << 40)),
+             (ovf_result<int64_t>{slimits<64>::min (), true}));
+  EXPECT_EQ (muls_ovf<32> (-65536, 32768),
+             (ovf_result<int32_t>{slimits<32>::min (), false}));
+}
+TEST (Ovf, Scalar) {
+  check_scalar_ops<4> ();
+  check_scalar_ops<7> ();
+  check_scalar_ops<8> ();
+  check_scalar_ops<12> ();
+  check_scalar_ops<16> ();
+  check_scalar_ops<24> ();
+  check_scalar_ops<31> ();
+  check_scalar_ops<32> ();
+  check_scalar_ops<48> ();
+  check_scalar_ops<63> ();
+  check_scalar_ops<64> ();
+}
+TEST (Ovf, Kernels) {
+  check_kernel_ops<4> ();
+  check_kernel_ops<7> ();
+  check_kernel_ops<8> ();
+  check_kernel_ops<12> ();
+  check_kernel_ops<16> ();
+  check_kernel_ops<24> ();
+  check_kernel_ops<31> ();
+  check_kernel_ops<32> ();
+  check_kernel_ops<48> ();
+  check_kernel_ops<64> ();
+}
+TEST (Ovf, Batch) {
+  std::array<int16_t, 10> const x{
+      {0, 32767, -32768, 100, 32000, -32000, 1, 2, 3, 32767}};
+  std::array<int16_t, 10> const y{{0, 1, -1, -200, 1000, -1000, 1, 2, 3, 0}};
+  std::array<int16_t, 10> out{};
+  std::array<uint8_t, 2> clipped{};
+  batch::adds_ovf<16> (x, y, out, clipped);
+  EXPECT_EQ (out,
+             (std::array<int16_t, 10>{
+                 {0, 32767, -32768, -100, 32767, -32768, 2, 4, 6, 32767}}));
+  EXPECT_EQ (clipped, (std::array<uint8_t, 2>{{0x36, 0x00}}));
+
+  std::array<uint8_t, 3> const ux{{0, 200, 255}};
+  std::array<uint8_t, 3> const uy{{1, 100, 0}};
+  std::array<uint8_t, 3> uout{};
+  std::array<uint8_t, 1> uclipped{};
+  batch::subu_ovf<8> (ux, uy, uout, uclipped);
+  EXPECT_EQ (uout, (std::array<uint8_t, 3>{{0, 100, 255}}));
+  EXPECT_EQ (uclipped[0], 0x01);
+  batch::mulu_ovf<8> (ux, uy, uout, uclipped);
+  EXPECT_EQ (uout, (std::array<uint8_t, 3>{{0, 255, 0}}));
+  EXPECT_EQ (uclipped[0], 0x02);
+}
@@ -0,0 +1,158 @@
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+#include "saturation/packed_array.hpp"
+
+using namespace saturation;
+
+namespace {
+
+/// Returns \p count pseudo-random values of \p N bits. The first few are the
+/// extreme values of the type.
+template <size_t N, bool IsSigned>
+std::vector<typename packed_array<N, IsSigned>::value_type>
+make_values (size_t const count, unsigned const seed) {
+  using value_type = typename packed_array<N, IsSigned>::value_type;
+  using wide_type = std::conditional_t<IsSigned, int64_t, uint64_t>;
+  constexpr auto min =
+      IsSigned ? wide_type (slimits<N>::min ()) : wide_type (0);
+  constexpr auto max = IsSigned ? wide_type (slimits<N>::max ())
+                                : wide_type (ulimits<N>::max ());
+  std::vector<value_type> result{static_cast<value_type> (min),
+                                 static_cast<value_type> (max),
+                                 value_type{0}, value_type{1}};
+  std::mt19937_64 generator{seed};
+  std::uniform_int_distribution<wide_type> distribution{min, max};
+  while (result.size () < count) {
+    result.push_back (static_cast<value_type> (distribution (generator)));
+  }
+  result.resize (count);
+  return result;
+}
+
+template <size_t N, bool IsSigned>
+void check_round_trip () {
+  // A length which is not a multiple of the block size.
+  auto const values = make_values<N, IsSigned> (200U, N);
+  packed_array<N, IsSigned> arr{values};
+  ASSERT_EQ (arr.size (), values.size ());
+  for (auto ctr = size_t{0}; ctr < values.size (); ++ctr) {
+    ASSERT_EQ (arr.get (ctr), values[ctr]) << "index " << ctr;
+  }
+  // Overwriting an element must not disturb its neighbours.
+  arr.set (7U, values[0]);
+  EXPECT_EQ (arr.get (6U), values[6]);
+  EXPECT_EQ (arr.get (7U), values[0]);
+  EXPECT_EQ (arr.get (8U), values[8]);
+
+  std::vector<typename packed_array<N, IsSigned>::value_type> out (50U);
+  arr.unpack (100U, out);
+  for (auto ctr = size_t{0}; ctr < out.size (); ++ctr) {
+    EXPECT_EQ (out[ctr], values[100U + ctr]) << "index " << ctr;
+  }
+}
+
+/// Checks that applying \p op to two packed arrays matches applying
+/// \p scalar to each pair of elements.
+template <size_t N, bool IsSigned, typename BulkOp, typename ScalarOp>
+void check_op (BulkOp const op, ScalarOp const scalar, unsigned const seed) {
+  auto const xv = make_values<N, IsSigned> (300U, seed);
+  auto const yv = make_values<N, IsSigned> (300U, seed + 1U);
+  packed_array<N, IsSigned> const x{xv};
+  packed_array<N, IsSigned> const y{yv};
+  packed_array<N, IsSigned> out (xv.size ());
+  op (x, y, out);
+  for (auto ctr = size_t{0}; ctr < xv.size (); ++ctr) {
+    ASSERT_EQ (out.get (ctr), scalar (xv[ctr], yv[ctr]))
+        << "index " << ctr << " x " << +xv[ctr] << " y " << +yv[ctr];
+  }
+  // In place.
+  auto inout = x;
+  op (inout, y, inout);
+  for (auto ctr = size_t{0}; ctr < xv.size (); ++ctr) {
+    ASSERT_EQ (inout.get (ctr), out.get (ctr)) << "index " << ctr;
+  }
+}
+
+template <size_t N>
+void check_ops () {
+  using uarray = packed_array<N, false>;
+  using sarray = packed_array<N, true>;
+  using uint_type = uinteger_t<N>;
+  using sint_type = sinteger_t<N>;
+  check_op<N, false> (
+      [] (uarray const& x, uarray const& y, uarray& out) {
+        batch::addu (x, y, out);
+      },
+      [] (uint_type x, uint_type y) { return addu<N> (x, y); }, 1U);
+  check_op<N, true> (
+      [] (sarray const& x, sarray const& y, sarray& out) {
+        batch::adds (x, y, out);
+      },
+      [] (sint_type x, sint_type y) { return adds<N> (x, y); }, 3U);
+  check_op<N, false> (
+      [] (uarray const& x, uarray const& y, uarray& out) {
+        batch::subu (x, y, out);
+      },
+      [] (uint_type x, uint_type y) { return subu<N> (x, y); }, 5U);
+  check_op<N, true> (
+      [] (sarray const& x, sarray const& y, sarray& out) {
+        batch::subs (x, y, out);
+      },
+      [] (sint_type x, sint_type y) { return subs<N> (x, y); }, 7U);
+  check_op<N, false> (
+      [] (uarray const& x, uarray const& y, uarray& out) {
+        batch::mulu (x, y, out);
+      },
+      [] (uint_type x, uint_type y) { return mulu<N> (x, y); }, 9U);
+  check_op<N, true> (
+      [] (sarray const& x, sarray const& y, sarray& out) {
+        batch::muls (x, y, out);
+      },
+      [] (sint_type x, sint_type y) { return muls<N> (x, y); }, 11U);
+}
+
+}  // end anonymous namespace
+
+TEST (PackedArray, Empty) {
+  packed_array<12, false> const arr;
+  EXPECT_TRUE (arr.empty ());
+  EXPECT_EQ (arr.size (), 0U);
+  packed_array<12, false> out;
+  batch::addu (arr, arr, out);
+  EXPECT_TRUE (out.empty ());
+}
+TEST (PackedArray, Storage) {
+  // 64 elements of 12 bits occupy 12 words (plus one spare).
+  packed_array<12, false> const arr (64U);
+  EXPECT_EQ (arr.storage_bytes (), 13U * sizeof (uint64_t));
+  packed_array<24, true> const arr24{-1, 2, -8388608, 8388607};
+  EXPECT_EQ (arr24.get (0U), -1);
+  EXPECT_EQ (arr24.get (1U), 2);
+  EXPECT_EQ (arr24.get (2U), -8388608);
+  EXPECT_EQ (arr24.get (3U), 8388607);
+}
+TEST (PackedArray, RoundTrip) {
+  check_round_trip<4, false> ();
+  check_round_trip<4, true> ();
+  check_round_trip<12, false> ();
+  check_round_trip<12, true> ();
+  check_round_trip<24, false> ();
+  check_round_trip<24, true> ();
+  check_round_trip<33, true> ();
+  check_round_trip<63, false> ();
+  check_round_trip<64, false> ();
+  check_round_trip<64, true> ();
+}
+TEST (PackedArray, Operations) {
+  check_ops<4> ();
+  check_ops<8> ();
+  check_ops<12> ();
+  check_ops<14> ();
+  check_ops<24> ();
+  check_ops<32> ();
+  check_ops<48> ();
+  check_ops<64> ();
+}
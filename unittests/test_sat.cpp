@@ -108,6 +108,33 @@ TYPED_TEST_P (Saturation, SignedDivide) {
   EXPECT_EQ (divs<bits> (max, sint_type{2}), sint_type{max / 2});
   EXPECT_EQ (divs<bits> (min, sint_type{-1}), max);
 }
+TYPED_TEST_P (Saturation, DivideByZero) {
+  constexpr auto bits = TypeParam::value;
+  using uint_type = uinteger_t<bits>;
+  using sint_type = sinteger_t<bits>;
+  constexpr auto maxu = ulimits<bits>::max ();
+  constexpr auto max = slimits<bits>::max ();
+  constexpr auto min = slimits<bits>::min ();
+  constexpr auto saturate = divide_by_zero::saturate;
+  EXPECT_EQ ((divu<bits, saturate> (uint_type{0}, uint_type{0})), uint_type{0});
+  EXPECT_EQ ((divu<bits, saturate> (uint_type{1}, uint_type{0})), maxu);
+  EXPECT_EQ ((divu<bits, saturate> (maxu, uint_type{0})), maxu);
+  EXPECT_EQ ((divu<bits, saturate> (uint_type{10}, uint_type{2})),
+             uint_type{5});
+  EXPECT_EQ ((divu<bits, divide_by_zero::undefined> (maxu, uint_type{1})),
+             maxu);
+
+  EXPECT_EQ ((divs<bits, saturate> (sint_type{0}, sint_type{0})), sint_type{0});
+  EXPECT_EQ ((divs<bits, saturate> (sint_type{1}, sint_type{0})), max);
+  EXPECT_EQ ((divs<bits, saturate> (max, sint_type{0})), max);
+  EXPECT_EQ ((divs<bits, saturate> (sint_type{-1}, sint_type{0})), min);
+  EXPECT_EQ ((divs<bits, saturate> (min, sint_type{0})), min);
+  EXPECT_EQ ((divs<bits, saturate> (min, sint_type{-1})), max);
+  EXPECT_EQ ((divs<bits, saturate> (sint_type{-4}, sint_type{2})),
+             sint_type{-2});
+  EXPECT_EQ ((divs<bits, divide_by_zero::undefined> (max, sint_type{2})),
+             sint_type{max / 2});
+}
 TYPED_TEST_P (Saturation, UnsignedMultiply) {
   constexpr auto bits = TypeParam::value;
   using uint_type = uinteger_t<bits>;
@@ -144,7 +171,7 @@ TYPED_TEST_P (Saturation, SignedMultiply) {
 
 REGISTER_TYPED_TEST_SUITE_P (Saturation, UnsignedAdd, SignedAdd, SignedSubtract,
                              UnsignedSubtract, UnsignedDivide, SignedDivide,
-                             UnsignedMultiply, SignedMultiply);
+                             DivideByZero, UnsignedMultiply, SignedMultiply);
 template <unsigned Value>
 using unsigned_constant = std::integral_constant<unsigned, Value>;
 using width_types = testing::Types<
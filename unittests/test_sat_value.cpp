@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+
+#include <random>
+#include <type_traits>
+
+#include "saturation/sat.hpp"
+
+using namespace saturation;
+
+namespace {
+
+// A sat<> is passed and returned in a register just like its value type, so
+// the operators compile to the same code as the free functions.
+static_assert (sizeof (sat_int<24>) == sizeof (sinteger_t<24>));
+static_assert (sizeof (sat_uint<64>) == sizeof (uinteger_t<64>));
+static_assert (std::is_trivially_copyable_v<sat_int<24>>);
+static_assert (std::is_standard_layout_v<sat_uint<12>>);
+
+// Widening conversions are implicit; narrowing ones are not.
+static_assert (std::is_convertible_v<sat_int<16>, sat_int<24>>);
+static_assert (std::is_convertible_v<sat_uint<16>, sat_uint<16>>);
+static_assert (std::is_convertible_v<sat_uint<12>, sat_int<16>>);
+static_assert (!std::is_convertible_v<sat_int<24>, sat_int<16>>);
+static_assert (!std::is_convertible_v<sat_uint<16>, sat_int<16>>);
+static_assert (!std::is_convertible_v<sat_int<8>, sat_uint<16>>);
+static_assert (!std::is_convertible_v<int, sat_int<16>>);
+
+static_assert ((sat_int<24>{8000000} + sat_int<24>{8000000}) ==
+               sat_int<24>::max ());
+static_assert ((sat_int<24>{-8000000} - sat_int<24>{8000000}) ==
+               sat_int<24>::min ());
+static_assert (-sat_int<12>::min () == sat_int<12>::max ());
+static_assert (-sat_uint<12>{5U} == sat_uint<12>{});
+static_assert ((sat_uint<12>{100U} * sat_uint<12>{100U}) ==
+               sat_uint<12>::max ());
+static_assert ((sat_int<8>::min () / sat_int<8>{-1}) == sat_int<8>::max ());
+static_assert (sat_int<12>::clamp (5000) == sat_int<12>::max ());
+static_assert (sat_int<12>::clamp (-5000L) == sat_int<12>::min ());
+static_assert (sat_int<12>::clamp (-5).get () == -5);
+static_assert (sat_uint<12>::clamp (-5) == sat_uint<12>{});
+static_assert (sat_uint<12>::clamp (~0ULL) == sat_uint<12>::max ());
+static_assert (sat_int<12>::clamp (sat_uint<16>::max ()) ==
+               sat_int<12>::max ());
+
+constexpr sat_int<24> accumulate (sat_int<24> acc, sat_int<16> const v) {
+  acc += v;
+  acc *= sat_int<24>{2};
+  return acc;
+}
+static_assert (accumulate (sat_int<24>{100}, sat_int<16>{-50}).get () == 100);
+
+/// Checks each operator of sat<N, IsSigned> against the corresponding free
+/// function for pseudo-random values.
+template <size_t N, bool IsSigned>
+void check () {
+  using value = sat<N, IsSigned>;
+  using value_type = typename value::value_type;
+  std::mt19937_64 generator{N};
+  auto const random = [&generator] () {
+    auto const r = generator () >> (generator () % 64U);
+    return value::clamp (IsSigned && (r & 1U) != 0U
+                             ? -static_cast<int64_t> (r >> 1U)
+                             : static_cast<int64_t> (r >> 1U));
+  };
+  for (auto ctr = 0; ctr < 10000; ++ctr) {
+    auto const x = random ();
+    auto const y = random ();
+    value_type const vx = x.get ();
+    value_type const vy = y.get ();
+    if constexpr (IsSigned) {
+      ASSERT_EQ ((x + y).get (), adds<N> (vx, vy));
+      ASSERT_EQ ((x - y).get (), subs<N> (vx, vy));
+      ASSERT_EQ ((x * y).get (), muls<N> (vx, vy));
+      if (vy != 0) {
+        ASSERT_EQ ((x / y).get (), divs<N> (vx, vy));
+      }
+    } else {
+      ASSERT_EQ ((x + y).get (), addu<N> (vx, vy));
+      ASSERT_EQ ((x - y).get (), subu<N> (vx, vy));
+      ASSERT_EQ ((x * y).get (), mulu<N> (vx, vy));
+      if (vy != 0U) {
+        ASSERT_EQ ((x / y).get (), divu<N> (vx, vy));
+      }
+    }
+    auto z = x;
+    z -= y;
+    ASSERT_EQ (z, x - y);
+    ASSERT_EQ (x < y, vx < vy);
+  }
+}
+
+}  // end anonymous namespace
+
+TEST (SatValue, Operators) {
+  check<8, true> ();
+  check<12, false> ();
+  check<24, true> ();
+  check<32, false> ();
+  check<48, true> ();
+  check<64, true> ();
+  check<64, false> ();
+}
+TEST (SatValue, Widening) {
+  sat_int<16> const a{-30000};
+  sat_int<24> const b{20000};
+  // a is widened to 24 bits so the result does not saturate at 16.
+  auto const c = a + b * sat_int<24>{-1};
+  static_assert (std::is_same_v<decltype (c), sat_int<24> const>);
+  EXPECT_EQ (c.get (), -50000);
+  sat_int<32> d = c;
+  d *= sat_int<32>{1000000};
+  EXPECT_EQ (d, sat_int<32>::min ());
+}
@@ -0,0 +1,160 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+#include "saturation/std_compat.hpp"
+#include "saturation/wide_int.hpp"
+
+using namespace saturation;
+
+namespace {
+
+// Wide enough to hold the exact sum, difference or product of any two 64 bit
+// values.
+using wide_type = wide_int<192>;
+
+static_assert (saturate_cast<uint8_t> (-1) == 0U);
+static_assert (saturate_cast<uint8_t> (256) == 255U);
+static_assert (saturate_cast<int8_t> (200U) == 127);
+static_assert (saturate_cast<int8_t> (-200) == -128);
+static_assert (saturate_cast<int64_t> (~uint64_t{0}) ==
+               std::numeric_limits<int64_t>::max ());
+static_assert (saturate_cast<uint64_t> (std::numeric_limits<int64_t>::min ()) ==
+               0U);
+static_assert (saturate_cast<uint32_t> (int64_t{1} << 40U) ==
+               std::numeric_limits<uint32_t>::max ());
+static_assert (saturate_cast<int16_t> (uint8_t{255}) == 255);
+
+/// Returns the edge-case values of \p T together with a selection of
+/// pseudo-random values.
+template <typename T>
+std::vector<T> make_values () {
+  using limits = std::numeric_limits<T>;
+  std::vector<T> result{limits::min (),
+                        static_cast<T> (limits::min () + 1),
+                        limits::max (),
+                        static_cast<T> (limits::max () - 1),
+                        T{0},
+                        T{1},
+                        T{2},
+                        static_cast<T> (-1)};
+  std::mt19937_64 generator{sizeof (T)};
+  for (auto ctr = 0; ctr < 100; ++ctr) {
+    // Shift right so that products are not (almost) always saturated.
+    result.push_back (static_cast<T> (generator () >> (ctr % 64)));
+  }
+  return result;
+}
+
+/// Returns \p v converted to wide_type.
+template <typename T>
+wide_type widen (T const v) {
+  if constexpr (std::is_signed_v<T>) {
+    return wide_type{static_cast<int64_t> (v)};
+  } else {
+    return wide_type{wide_type::limbs_type{{static_cast<uint64_t> (v)}}};
+  }
+}
+
+/// Clamps \p v to the range of \p T.
+template <typename T>
+T clamp (wide_type const& v) {
+  using limits = std::numeric_limits<T>;
+  auto const lo = widen (limits::min ());
+  auto const hi = widen (limits::max ());
+  return static_cast<T> ((v < lo ? lo : (hi < v ? hi : v)).limb (0));
+}
+
+/// Returns the exact quotient \p x / \p y clamped to the range of \p T. The
+/// only quotient which cannot be represented is min() / -1.
+template <typename T>
+T clamped_quotient (T const x, T const y) {
+  if constexpr (std::is_signed_v<T>) {
+    if (x == std::numeric_limits<T>::min () && y == T{-1}) {
+      return std::numeric_limits<T>::max ();
+    }
+  }
+  return static_cast<T> (x / y);
+}
+
+/// Checks each of the arithmetic functions for type \p T against the result
+/// computed with a wider type and clamped.
+template <typename T>
+void check () {
+  auto const values = make_values<T> ();
+  for (auto const x : values) {
+    auto const wx = widen (x);
+    for (auto const y : values) {
+      auto const wy = widen (y);
+      // None of these can saturate in wide_type, so the results are exact.
+      ASSERT_EQ (add_sat (x, y), clamp<T> (adds (wx, wy)));
+      ASSERT_EQ (sub_sat (x, y), clamp<T> (subs (wx, wy)));
+      ASSERT_EQ (mul_sat (x, y), clamp<T> (muls (wx, wy)));
+      if (y != 0) {
+        ASSERT_EQ (div_sat (x, y), clamped_quotient (x, y));
+      }
+    }
+  }
+}
+
+/// Checks saturate_cast<R>() from type \p T against a clamp computed with a
+/// wider type.
+template <typename R, typename T>
+void check_cast () {
+  for (auto const x : make_values<T> ()) {
+    ASSERT_EQ (saturate_cast<R> (x), clamp<R> (widen (x)));
+  }
+}
+
+template <typename T>
+void check_casts_from () {
+  check_cast<int8_t, T> ();
+  check_cast<uint8_t, T> ();
+  check_cast<int16_t, T> ();
+  check_cast<uint16_t, T> ();
+  check_cast<int32_t, T> ();
+  check_cast<uint32_t, T> ();
+  check_cast<int64_t, T> ();
+  check_cast<uint64_t, T> ();
+}
+
+}  // end anonymous namespace
+
+TEST (StdCompat, Edges) {
+  EXPECT_EQ (add_sat<int8_t> (100, 100), 127);
+  EXPECT_EQ (add_sat<uint8_t> (200, 100), 255);
+  EXPECT_EQ (sub_sat<unsigned> (1U, 2U), 0U);
+  EXPECT_EQ (sub_sat<long long> (std::numeric_limits<long long>::min (), 1),
+             std::numeric_limits<long long>::min ());
+  EXPECT_EQ (mul_sat<short> (-300, 300), std::numeric_limits<short>::min ());
+  EXPECT_EQ (div_sat<int> (std::numeric_limits<int>::min (), -1),
+             std::numeric_limits<int>::max ());
+}
+TEST (StdCompat, Signed) {
+  check<signed char> ();
+  check<short> ();
+  check<int> ();
+  check<long> ();
+  check<long long> ();
+}
+TEST (StdCompat, Unsigned) {
+  check<unsigned char> ();
+  check<unsigned short> ();
+  check<unsigned> ();
+  check<unsigned long> ();
+  check<unsigned long long> ();
+}
+TEST (StdCompat, SaturateCast) {
+  check_casts_from<int8_t> ();
+  check_casts_from<uint8_t> ();
+  check_casts_from<int16_t> ();
+  check_casts_from<uint16_t> ();
+  check_casts_from<int32_t> ();
+  check_casts_from<uint32_t> ();
+  check_casts_from<int64_t> ();
+  check_casts_from<uint64_t> ();
+}
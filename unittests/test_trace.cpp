@@ -0,0 +1,126 @@
+// Tracing is enabled for this translation unit only: no other test includes
+// trace.hpp.
+#define SATURATION_TRACE 1
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "saturation/trace.hpp"
+
+using namespace saturation;
+
+namespace {
+
+/// Returns the number of events recorded for \p o at line \p line of this
+/// file.
+uint64_t count_at (trace::op const o, unsigned const line) {
+  uint64_t result = 0;
+  for (auto const& r : trace::snapshot ()) {
+    if (r.operation == o && r.where.line == line &&
+        std::string{r.where.file} == __FILE__) {
+      result += r.count;
+    }
+  }
+  return result;
+}
+
+}  // end anonymous namespace
+
+TEST (Trace, Counts) {
+  trace::reset ();
+  auto const line = unsigned{__LINE__ + 3};
+  for (auto x = 0; x < 100; ++x) {
+    auto const v = static_cast<int8_t> (x);
+    EXPECT_EQ (traced::adds<8> (v, int8_t{100}), (adds<8> (v, int8_t{100})));
+  }
+  // 100 + x saturates for x >= 28.
+  EXPECT_EQ (count_at (trace::op::adds, line), 72U);
+
+  auto const records = trace::snapshot ();
+  ASSERT_EQ (records.size (), 1U);
+  EXPECT_EQ (records[0].operation, trace::op::adds);
+  EXPECT_EQ (records[0].bits, 8U);
+  EXPECT_STREQ (records[0].where.function, "TestBody");
+  EXPECT_EQ (trace::dropped (), 0U);
+}
+TEST (Trace, Operations) {
+  trace::reset ();
+  auto const line = unsigned{__LINE__ + 1};
+  EXPECT_EQ (traced::addu<12> (4000U, 100U), 4095U);
+  EXPECT_EQ (traced::subu<32> (1U, 2U), 0U);
+  EXPECT_EQ (traced::subs<16> (-32768, 1), -32768);
+  EXPECT_EQ (traced::mulu<64> (uint64_t{1} << 32, uint64_t{1} << 32),
+             ulimits<64>::max ());
+  EXPECT_EQ (traced::muls<24> (-4096, 4096), slimits<24>::min ());
+  // None of these saturate.
+  EXPECT_EQ (traced::addu<12> (4000U, 95U), 4095U);
+  EXPECT_EQ (traced::muls<24> (-2048, 4096), slimits<24>::min ());
+
+  EXPECT_EQ (count_at (trace::op::addu, line), 1U);
+  EXPECT_EQ (count_at (trace::op::subu, line + 1U), 1U);
+  EXPECT_EQ (count_at (trace::op::subs, line + 2U), 1U);
+  EXPECT_EQ (count_at (trace::op::mulu, line + 3U), 1U);
+  EXPECT_EQ (count_at (trace::op::muls, line + 5U), 1U);
+  EXPECT_EQ (trace::snapshot ().size (), 5U);
+}
+TEST (Trace, Threads) {
+  trace::reset ();
+  constexpr auto threads = 4;
+  constexpr auto calls = 10000;
+  auto const line = unsigned{__LINE__ + 4};
+  auto const work = [] {
+    for (auto ctr = 0; ctr < calls; ++ctr) {
+      // Saturates on every other call.
+      traced::subu<16> (static_cast<uint16_t> (ctr % 2), 1U);
+    }
+  };
+  std::vector<std::thread> pool;
+  for (auto ctr = 0; ctr < threads; ++ctr) {
+    pool.emplace_back (work);
+  }
+  for (auto& t : pool) {
+    t.join ();
+  }
+  // Each thread flushed its counts as it exited.
+  EXPECT_EQ (count_at (trace::op::subu, line), uint64_t{threads * calls / 2});
+}
+TEST (Trace, ManySites) {
+  trace::reset ();
+  // More sites than fit in a thread's table, which is flushed when full.
+  for (auto ctr = 0U; ctr < 200U; ++ctr) {
+    traced::mulu<8> (16U, 16U, trace::location{__FILE__, "site", ctr});
+  }
+  auto const records = trace::snapshot ();
+  EXPECT_EQ (records.size (), 200U);
+  for (auto const& r : records) {
+    EXPECT_EQ (r.count, 1U);
+  }
+}
+TEST (Trace, Dump) {
+  trace::reset ();
+  traced::adds<16> (30000, 30000, trace::location{"a\\b.cpp", "f", 10U});
+  traced::adds<16> (30000, 30000, trace::location{"a\\b.cpp", "f", 10U});
+  traced::mulu<32> (1U << 16U, 1U << 16U,
+                    trace::location{"c\"d.cpp", "g", 20U});
+
+  std::ostringstream text;
+  trace::dump_text (text);
+  EXPECT_EQ (text.str (),
+             "a\\b.cpp:10: f: adds<16> saturated 2 times\n"
+             "c\"d.cpp:20: g: mulu<32> saturated 1 times\n");
+
+  std::ostringstream json;
+  trace::dump_json (json);
+  EXPECT_EQ (json.str (),
+             "{\"sites\":["
+             "{\"op\":\"adds\",\"bits\":16,\"file\":\"a\\\\b.cpp\",\"line\":10,"
+             "\"function\":\"f\",\"count\":2},"
+             "{\"op\":\"mulu\",\"bits\":32,\"file\":\"c\\\"d.cpp\",\"line\":20,"
+             "\"function\":\"g\",\"count\":1}"
+             "],\"dropped\":0}\n");
+}
@@ -0,0 +1,182 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <random>
+#include <vector>
+
+#include "saturation/wide_int.hpp"
+
+using namespace saturation;
+
+namespace {
+
+enum class op { add, sub, mul };
+
+/// A reference implementation which computes the exact result of \p o using
+/// 32 bit digits wide enough that nothing can overflow, then saturates it.
+template <size_t Bits, bool IsSigned>
+wide_integer<Bits, IsSigned> reference (op const o,
+                                        wide_integer<Bits, IsSigned> const& x,
+                                        wide_integer<Bits, IsSigned> const& y) {
+  constexpr auto limbs = Bits / 64U;
+  constexpr auto digits = 2U * Bits / 32U + 2U;
+  // Convert to digits, sign- or zero-extending.
+  auto const to_digits = [] (wide_integer<Bits, IsSigned> const& v) {
+    std::vector<uint32_t> d (digits, v.is_negative () ? ~uint32_t{0} : 0U);
+    for (auto ctr = size_t{0}; ctr < limbs; ++ctr) {
+      d[ctr * 2U] = static_cast<uint32_t> (v.limb (ctr));
+      d[ctr * 2U + 1U] = static_cast<uint32_t> (v.limb (ctr) >> 32U);
+    }
+    return d;
+  };
+  auto const dx = to_digits (x);
+  auto const dy = to_digits (y);
+  std::vector<uint32_t> r (digits, 0U);
+  switch (o) {
+  case op::add:
+  case op::sub: {
+    auto carry = int64_t{0};
+    for (auto ctr = size_t{0}; ctr < digits; ++ctr) {
+      auto const t = int64_t{dx[ctr]} +
+                     (o == op::add ? int64_t{dy[ctr]} : -int64_t{dy[ctr]}) +
+                     carry;
+      r[ctr] = static_cast<uint32_t> (t);
+      carry = t >> 32;  // arithmetic shift gives the signed carry
+    }
+  } break;
+  case op::mul:
+    // The product modulo 2^(32 * digits): correct for twos complement.
+    for (auto i = size_t{0}; i < digits; ++i) {
+      auto carry = uint64_t{0};
+      for (auto j = size_t{0}; i + j < digits; ++j) {
+        auto const t = uint64_t{dx[i]} * dy[j] + r[i + j] + carry;
+        r[i + j] = static_cast<uint32_t> (t);
+        carry = t >> 32U;
+      }
+    }
+    break;
+  }
+  // The result fits if every digit above the first Bits bits is the
+  // extension of bit Bits - 1 (or zero if unsigned).
+  auto const negative = (r[digits - 1U] >> 31U) != 0U;
+  auto const sign_bit = (r[limbs * 2U - 1U] >> 31U) != 0U;
+  auto const extension = IsSigned && sign_bit ? ~uint32_t{0} : 0U;
+  auto fits = IsSigned || !negative;
+  for (auto ctr = limbs * 2U; ctr < digits; ++ctr) {
+    fits = fits && r[ctr] == extension;
+  }
+  if (!fits) {
+    if (negative) {
+      return wide_integer<Bits, IsSigned>::min ();
+    }
+    return wide_integer<Bits, IsSigned>::max ();
+  }
+  typename wide_integer<Bits, IsSigned>::limbs_type l{};
+  for (auto ctr = size_t{0}; ctr < limbs; ++ctr) {
+    l[ctr] = uint64_t{r[ctr * 2U]} | uint64_t{r[ctr * 2U + 1U]} << 32U;
+  }
+  return wide_integer<Bits, IsSigned>{l};
+}
+
+/// Returns a collection of edge-case and pseudo-random values.
+template <size_t Bits, bool IsSigned>
+std::vector<wide_integer<Bits, IsSigned>> make_values (unsigned const seed) {
+  using wide = wide_integer<Bits, IsSigned>;
+  using limbs_type = typename wide::limbs_type;
+  using small = std::conditional_t<IsSigned, int64_t, uint64_t>;
+  std::vector<wide> result{wide{},
+                           wide{small{1}},
+                           wide{small{2}},
+                           wide::max (),
+                           wide::min (),
+                           wide{static_cast<small> (-1)},
+                           wide{std::numeric_limits<small>::max ()},
+                           wide{std::numeric_limits<small>::min ()}};
+  for (auto ctr = size_t{0}; ctr < wide::limb_count; ++ctr) {
+    limbs_type l{};
+    l[ctr] = 1U;
+    result.emplace_back (l);
+    l[ctr] = ~uint64_t{0};
+    result.emplace_back (l);
+  }
+  std::mt19937_64 generator{seed};
+  for (auto ctr = 0; ctr < 40; ++ctr) {
+    limbs_type l{};
+    // Vary the number of significant limbs so that products do not always
+    // overflow.
+    auto const used = 1U + static_cast<size_t> (ctr) % wide::limb_count;
+    for (auto pos = size_t{0}; pos < used; ++pos) {
+      l[pos] = generator ();
+    }
+    if (IsSigned && ctr % 2 == 1) {
+      for (auto pos = used; pos < wide::limb_count; ++pos) {
+        l[pos] = ~uint64_t{0};
+      }
+    }
+    result.emplace_back (l);
+  }
+  return result;
+}
+
+template <size_t Bits>
+void check () {
+  auto const uvalues = make_values<Bits, false> (Bits);
+  for (auto const& x : uvalues) {
+    for (auto const& y : uvalues) {
+      ASSERT_EQ (addu (x, y).limbs (), reference (op::add, x, y).limbs ());
+      ASSERT_EQ (subu (x, y).limbs (), reference (op::sub, x, y).limbs ());
+      ASSERT_EQ (mulu (x, y).limbs (), reference (op::mul, x, y).limbs ());
+    }
+  }
+  auto const svalues = make_values<Bits, true> (Bits + 1U);
+  for (auto const& x : svalues) {
+    for (auto const& y : svalues) {
+      ASSERT_EQ (adds (x, y).limbs (), reference (op::add, x, y).limbs ());
+      ASSERT_EQ (subs (x, y).limbs (), reference (op::sub, x, y).limbs ());
+      ASSERT_EQ (muls (x, y).limbs (), reference (op::mul, x, y).limbs ());
+    }
+  }
+}
+
+}  // end anonymous namespace
+
+TEST (WideInt, Construct) {
+  wide_int<192> const minus_one{-1};
+  EXPECT_TRUE (minus_one.is_negative ());
+  for (auto const l : minus_one.limbs ()) {
+    EXPECT_EQ (l, ~uint64_t{0});
+  }
+  EXPECT_TRUE (wide_int<192>::min () < minus_one);
+  EXPECT_TRUE (minus_one < wide_int<192>{0});
+  EXPECT_TRUE (wide_int<192>{0} < wide_int<192>::max ());
+  EXPECT_TRUE (wide_uint<256>{5U} > wide_uint<256>{4U});
+  EXPECT_TRUE (wide_uint<256>::min () == wide_uint<256>{});
+  EXPECT_FALSE (wide_uint<256>{}.is_negative ());
+}
+TEST (WideInt, Accumulate) {
+  // Summing many large values saturates rather than wrapping.
+  auto acc = wide_uint<192>{};
+  auto const v =
+      wide_uint<192>{wide_uint<192>::limbs_type{0U, 0U, uint64_t{1} << 62U}};
+  for (auto ctr = 0; ctr < 3; ++ctr) {
+    acc = addu (acc, v);
+  }
+  EXPECT_EQ (acc.limb (2U), uint64_t{3} << 62U);
+  acc = addu (acc, v);
+  EXPECT_EQ (acc, wide_uint<192>::max ());
+
+  auto sacc = wide_int<256>{};
+  for (auto ctr = 0; ctr < 8; ++ctr) {
+    sacc = adds (sacc, wide_int<256>::min ());
+  }
+  EXPECT_EQ (sacc, wide_int<256>::min ());
+}
+TEST (WideInt, 128) {
+  check<128> ();
+}
+TEST (WideInt, 192) {
+  check<192> ();
+}
+TEST (WideInt, 256) {
+  check<256> ();
+}
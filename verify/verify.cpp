@@ -0,0 +1,517 @@
+/// \file verify.cpp
+/// \brief Checks the saturating functions and the batch kernels against
+/// widen-and-clamp references.
+///
+/// For each operation (including the divisions which saturate on division
+/// by zero) and each width from 4 to 64 bits, the scalar function and every
+/// batch kernel usable on this processor (see cpu.hpp) are compared with a
+/// reference which computes the exact result in a wider type and clamps it.
+/// Values of up to 16 bits (--exhaustive_bits) are checked with every pair
+/// of operands: 2^32 pairs for each 16 bit operation. Wider values are
+/// checked with --samples pairs for each operation and width (2^26 by
+/// default), drawn from a mixture of uniformly distributed values, edge
+/// cases (the limits of the type, small values, powers of two), values of
+/// random magnitude, and pairs close to the point at which the result
+/// begins to saturate. The samples depend only on --seed, not on the number
+/// of threads (--threads, by default one for each core).
+///
+/// The implementation of the scalar functions is chosen at compile time, so
+/// this file is built once for each strategy, as are the benchmarks:
+/// verify_builtin, verify_asm (NO_BUILTIN_OVERFLOW), and verify_generic
+/// (NO_INLINE_ASM and NO_BUILTIN_OVERFLOW). Set SATURATION_ISA to check a
+/// lower instruction set level's kernels only. Use --ops (a comma-separated
+/// list of names such as "adds,mulu"), --min_bits, and --max_bits to check
+/// a subset. The program prints a line for each operation and width, the
+/// first few mismatches, and exits with a non-zero status if there were
+/// any.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "operands.hpp"
+#include "saturation/batch.hpp"
+
+#ifndef SATURATION_VERIFY_STRATEGY
+#define SATURATION_VERIFY_STRATEGY "builtin"
+#endif
+
+using namespace saturation;
+using bench::int128_type;
+using details::batch_arg_t;
+using details::batch_kernel_t;
+using details::batch_op;
+using details::is_unsigned_op;
+
+namespace {
+
+struct options {
+  /// Values of up to this number of bits are checked exhaustively.
+  size_t exhaustive_bits = 16;
+  /// The number of pairs of operands checked for wider values.
+  uint64_t samples = uint64_t{1} << 26U;
+  unsigned threads = std::max (std::thread::hardware_concurrency (), 1U);
+  uint64_t seed = 1;
+  size_t min_bits = 4;
+  size_t max_bits = 64;
+  /// A comma-separated list of the operations to check. All are checked if
+  /// empty.
+  std::string ops;
+
+  bool selected (batch_op const op) const {
+    if (ops.empty ()) {
+      return true;
+    }
+    auto const list = ',' + ops + ',';
+    return list.find (',' + std::string{to_string (op)} + ',') !=
+           std::string::npos;
+  }
+};
+
+/// Counts the mismatches and prints the first few of them.
+class failures {
+public:
+  template <typename T>
+  void report (char const* const what, batch_op const op, size_t const bits,
+               T const x, T const y, T const expected, T const actual) {
+    if (count_++ >= max_printed) {
+      return;
+    }
+    std::lock_guard<std::mutex> const lock{mutex_};
+    std::fprintf (stderr, "%s<%zu> (%s): x=%s y=%s expected %s got %s\n",
+                  to_string (op), bits, what, std::to_string (x).c_str (),
+                  std::to_string (y).c_str (),
+                  std::to_string (expected).c_str (),
+                  std::to_string (actual).c_str ());
+  }
+  uint64_t count () const noexcept { return count_.load (); }
+
+private:
+  static constexpr auto max_printed = uint64_t{20};
+  std::atomic<uint64_t> count_{0};
+  std::mutex mutex_;
+};
+
+/// The smallest value of the arguments of \p Op on \p N bit values.
+template <batch_op Op, size_t N>
+constexpr int128_type lowest () noexcept {
+  return is_unsigned_op (Op) ? int128_type{0}
+                             : int128_type{slimits<N>::min ()};
+}
+/// The largest value of the arguments of \p Op on \p N bit values.
+template <batch_op Op, size_t N>
+constexpr int128_type highest () noexcept {
+  return is_unsigned_op (Op) ? int128_type{ulimits<N>::max ()}
+                             : int128_type{slimits<N>::max ()};
+}
+
+/// True if \p Op is a division whose result is undefined if the divisor is
+/// zero. Such pairs are never checked.
+constexpr bool zero_divisor_undefined (batch_op const op) noexcept {
+  return op == batch_op::divu || op == batch_op::divs;
+}
+
+/// The widen-and-clamp reference for \p Op applied to \p x and \p y.
+template <batch_op Op, size_t N>
+constexpr batch_arg_t<Op, N> reference (batch_arg_t<Op, N> const x,
+                                        batch_arg_t<Op, N> const y) noexcept {
+  using arg = batch_arg_t<Op, N>;
+  if constexpr (Op == batch_op::divu_saturate ||
+                Op == batch_op::divs_saturate) {
+    // Division by zero gives the limit with the sign of the dividend.
+    if (y == 0) {
+      return x > 0   ? static_cast<arg> (highest<Op, N> ())
+             : x < 0 ? static_cast<arg> (lowest<Op, N> ())
+                     : arg{0};
+    }
+  }
+  return bench::naive<Op, N> (x, y);
+}
+
+template <batch_op Op, size_t N>
+struct kernel {
+  char const* name;
+  batch_kernel_t<Op, N> function;
+};
+
+/// Returns the distinct batch kernels for \p Op on \p N bit values at the
+/// instruction set levels up to selected_isa(). Each is named after the
+/// lowest level at which it is used.
+template <batch_op Op, size_t N>
+std::vector<kernel<Op, N>> kernels () {
+  std::vector<kernel<Op, N>> result;
+  for (auto const level : {isa::scalar, isa::sse2, isa::avx2, isa::avx512}) {
+    if (level > selected_isa ()) {
+      break;
+    }
+    auto const function = details::resolve_kernel<Op, N> (level);
+    if (std::none_of (result.begin (), result.end (),
+                      [function] (kernel<Op, N> const& k) {
+                        return k.function == function;
+                      })) {
+      result.push_back ({to_string (level), function});
+    }
+  }
+  return result;
+}
+
+/// Compares the scalar function and the batch kernels with the reference
+/// for blocks of operands. Each thread has its own checker.
+template <batch_op Op, size_t N>
+class checker {
+public:
+  using arg = batch_arg_t<Op, N>;
+
+  checker (std::vector<kernel<Op, N>> const& kernels, failures& log)
+      : kernels_{kernels}, log_{log} {}
+
+  void operator() (arg const* const x, arg const* const y, size_t const n) {
+    expected_.resize (n);
+    actual_.resize (n);
+    for (auto ctr = size_t{0}; ctr < n; ++ctr) {
+      expected_[ctr] = reference<Op, N> (x[ctr], y[ctr]);
+    }
+    for (auto ctr = size_t{0}; ctr < n; ++ctr) {
+      actual_[ctr] = details::scalar_op<Op, N>::apply (x[ctr], y[ctr]);
+    }
+    compare ("function", x, y, n);
+    for (auto const& k : kernels_) {
+      // Poison the output so that an element which a kernel fails to write
+      // is not mistaken for a correct result.
+      for (auto ctr = size_t{0}; ctr < n; ++ctr) {
+        actual_[ctr] = static_cast<arg> (~expected_[ctr]);
+      }
+      k.function (x, y, actual_.data (), n);
+      compare (k.name, x, y, n);
+    }
+  }
+
+private:
+  void compare (char const* const what, arg const* const x,
+                arg const* const y, size_t const n) {
+    if (std::equal (expected_.begin (), expected_.begin () + n,
+                    actual_.begin ())) {
+      return;
+    }
+    for (auto ctr = size_t{0}; ctr < n; ++ctr) {
+      if (actual_[ctr] != expected_[ctr]) {
+        log_.report (what, Op, N, x[ctr], y[ctr], expected_[ctr],
+                     actual_[ctr]);
+      }
+    }
+  }
+
+  std::vector<kernel<Op, N>> const& kernels_;
+  failures& log_;
+  std::vector<arg> expected_;
+  std::vector<arg> actual_;
+};
+
+/// Calls a function object made by \p make_worker for each integer in
+/// [0, \p count) using \p threads threads. Each thread makes its own worker.
+template <typename MakeWorker>
+void parallel_for (unsigned const threads, uint64_t const count,
+                   MakeWorker const& make_worker) {
+  std::atomic<uint64_t> next{0};
+  auto const run = [&] {
+    auto worker = make_worker ();
+    for (auto index = next++; index < count; index = next++) {
+      worker (index);
+    }
+  };
+  std::vector<std::thread> pool;
+  for (auto ctr = 1U; ctr < threads; ++ctr) {
+    pool.emplace_back (run);
+  }
+  run ();
+  for (auto& t : pool) {
+    t.join ();
+  }
+}
+
+/// Checks every pair of operands for \p Op on \p N bit values. Each unit of
+/// work is the row of pairs which share a first operand. Returns the number
+/// of pairs checked.
+template <batch_op Op, size_t N>
+uint64_t exhaustive (options const& opts,
+                     std::vector<kernel<Op, N>> const& ks, failures& log) {
+  using arg = batch_arg_t<Op, N>;
+  std::vector<arg> ys;
+  for (auto v = lowest<Op, N> (); v <= highest<Op, N> (); ++v) {
+    if (v != 0 || !zero_divisor_undefined (Op)) {
+      ys.push_back (static_cast<arg> (v));
+    }
+  }
+  auto const rows =
+      static_cast<uint64_t> (highest<Op, N> () - lowest<Op, N> () + 1);
+  parallel_for (opts.threads, rows, [&] {
+    return [&ys, c = checker<Op, N>{ks, log},
+            xs = std::vector<arg> (ys.size ())] (uint64_t const row) mutable {
+      std::fill (xs.begin (), xs.end (),
+                 static_cast<arg> (lowest<Op, N> () + row));
+      c (xs.data (), ys.data (), ys.size ());
+    };
+  });
+  return rows * ys.size ();
+}
+
+/// Draws pairs of operands for \p Op on \p N bit values.
+template <batch_op Op, size_t N>
+class sampler {
+public:
+  using arg = batch_arg_t<Op, N>;
+
+  explicit sampler (std::seed_seq& seq) : generator_{seq} {}
+
+  std::pair<arg, arg> operator() () {
+    arg x = 0;
+    arg y = 0;
+    switch (generator_ () % 4U) {
+    case 0:
+      x = uniform ();
+      y = uniform ();
+      break;
+    case 1:
+      x = any ();
+      y = any ();
+      break;
+    default:
+      x = any ();
+      y = partner (x);
+      break;
+    }
+    if (zero_divisor_undefined (Op) && y == 0) {
+      y = 1;
+    }
+    return {x, y};
+  }
+
+private:
+  static arg clamp (int128_type const v) noexcept {
+    return static_cast<arg> (
+        std::clamp (v, lowest<Op, N> (), highest<Op, N> ()));
+  }
+  /// Returns a value of between -2 and 2.
+  int128_type delta () {
+    return static_cast<int128_type> (generator_ () % 5U) - 2;
+  }
+
+  /// Uniformly distributed over the range of the type.
+  arg uniform () {
+    constexpr auto mask = ulimits<N>::max ();
+    return static_cast<arg> (lowest<Op, N> () +
+                             static_cast<int128_type> (generator_ () & mask));
+  }
+  /// A uniformly distributed value shifted right by a random number of bits
+  /// so that small magnitudes are as likely as large.
+  arg scaled () {
+    return static_cast<arg> (static_cast<int128_type> (uniform ()) >>
+                             (generator_ () % N));
+  }
+  /// An edge case: a limit of the type, a small value, or a power of two, or
+  /// a neighbour of one of these.
+  arg edge () {
+    constexpr auto lo = lowest<Op, N> ();
+    constexpr auto hi = highest<Op, N> ();
+    constexpr auto root = int128_type{1} << (N / 2U);
+    auto const power = int128_type{1} << (generator_ () % N);
+    int128_type const values[] = {lo,     hi,   0,     1,     -1, hi / 2,
+                                  lo / 2, root, -root, power, -power};
+    constexpr auto size = sizeof (values) / sizeof (values[0]);
+    return clamp (values[generator_ () % size] + delta ());
+  }
+  arg any () {
+    switch (generator_ () % 3U) {
+    case 0: return uniform ();
+    case 1: return scaled ();
+    default: return edge ();
+    }
+  }
+  /// Returns a value y such that \p x and y are close to the boundary at
+  /// which the result of Op begins to saturate.
+  arg partner (arg const x) {
+    constexpr auto lo = lowest<Op, N> ();
+    constexpr auto hi = highest<Op, N> ();
+    auto const wx = static_cast<int128_type> (x);
+    auto base = int128_type{0};
+    if constexpr (Op == batch_op::addu || Op == batch_op::adds) {
+      // x + y == hi or x + y == lo.
+      base = wx >= 0 ? hi - wx : lo - wx;
+    } else if constexpr (Op == batch_op::subu || Op == batch_op::subs) {
+      // x - y == hi or x - y == lo.
+      base = wx >= 0 ? wx - (is_unsigned_op (Op) ? lo : hi) : wx - lo;
+    } else if constexpr (Op == batch_op::mulu || Op == batch_op::muls) {
+      // x * y == hi or x * y == lo.
+      if (wx == 0) {
+        return any ();
+      }
+      base = (generator_ () & 1U) != 0U || lo == 0 ? hi / wx : lo / wx;
+    } else {
+      // Divisors of zero, plus or minus one, and close to x.
+      base = (generator_ () & 1U) != 0U ? 0 : wx;
+    }
+    return clamp (base + delta ());
+  }
+
+  std::mt19937_64 generator_;
+};
+
+/// Checks opts.samples pairs of operands for \p Op on \p N bit values in
+/// blocks, each of which has its own random number generator. Returns the
+/// number of pairs checked.
+template <batch_op Op, size_t N>
+uint64_t sampled (options const& opts, std::vector<kernel<Op, N>> const& ks,
+                  failures& log) {
+  using arg = batch_arg_t<Op, N>;
+  constexpr auto block = uint64_t{4096};
+  auto const blocks = (opts.samples + block - 1U) / block;
+  parallel_for (opts.threads, blocks, [&] {
+    return [&, c = checker<Op, N>{ks, log}, xs = std::vector<arg> (block),
+            ys = std::vector<arg> (block)] (uint64_t const index) mutable {
+      std::seed_seq seq{static_cast<uint32_t> (opts.seed),
+                        static_cast<uint32_t> (opts.seed >> 32U),
+                        static_cast<uint32_t> (Op),
+                        static_cast<uint32_t> (N),
+                        static_cast<uint32_t> (index),
+                        static_cast<uint32_t> (index >> 32U)};
+      sampler<Op, N> s{seq};
+      auto const n = std::min (block, opts.samples - index * block);
+      for (auto ctr = uint64_t{0}; ctr < n; ++ctr) {
+        std::tie (xs[ctr], ys[ctr]) = s ();
+      }
+      c (xs.data (), ys.data (), n);
+    };
+  });
+  return opts.samples;
+}
+
+/// Checks \p Op on \p N bit values and prints a summary.
+template <batch_op Op, size_t N>
+void verify (options const& opts, failures& log) {
+  if (N < opts.min_bits || N > opts.max_bits || !opts.selected (Op)) {
+    return;
+  }
+  auto const ks = kernels<Op, N> ();
+  auto const before = log.count ();
+  auto const start = std::chrono::steady_clock::now ();
+  auto const all = N <= opts.exhaustive_bits;
+  auto const pairs = all ? exhaustive<Op, N> (opts, ks, log)
+                         : sampled<Op, N> (opts, ks, log);
+  std::chrono::duration<double> const elapsed =
+      std::chrono::steady_clock::now () - start;
+  auto const mismatches = log.count () - before;
+  std::printf ("%s<%zu>: %s %" PRIu64 " pairs, %zu kernel(s), %.1f s: %s\n",
+               to_string (Op), N, all ? "all" : "sampled", pairs, ks.size (),
+               elapsed.count (),
+               mismatches == 0U
+                   ? "ok"
+                   : (std::to_string (mismatches) + " mismatches").c_str ());
+  std::fflush (stdout);
+}
+
+template <size_t N>
+void verify_width (options const& opts, failures& log) {
+  verify<batch_op::addu, N> (opts, log);
+  verify<batch_op::adds, N> (opts, log);
+  verify<batch_op::subu, N> (opts, log);
+  verify<batch_op::subs, N> (opts, log);
+  verify<batch_op::mulu, N> (opts, log);
+  verify<batch_op::muls, N> (opts, log);
+  verify<batch_op::divu, N> (opts, log);
+  verify<batch_op::divs, N> (opts, log);
+  verify<batch_op::divu_saturate, N> (opts, log);
+  verify<batch_op::divs_saturate, N> (opts, log);
+}
+
+template <size_t... Offsets>
+void verify_widths (options const& opts, failures& log,
+                    std::index_sequence<Offsets...>) {
+  (verify_width<Offsets + 4U> (opts, log), ...);
+}
+
+/// Parses the command line into \p opts. Returns false if an option is not
+/// recognized or its value is malformed.
+bool parse_options (int const argc, char** const argv, options& opts) {
+  auto const number = [] (char const* const str, uint64_t const max,
+                          uint64_t* const out) {
+    char* end = nullptr;
+    auto const v = std::strtoull (str, &end, 0);
+    if (end == str || *end != '\0' || v > max) {
+      return false;
+    }
+    *out = v;
+    return true;
+  };
+  for (auto ctr = 1; ctr < argc; ++ctr) {
+    auto const* const arg = argv[ctr];
+    auto const value = [arg] (char const* const name) -> char const* {
+      auto const length = std::strlen (name);
+      return std::strncmp (arg, name, length) == 0 ? arg + length : nullptr;
+    };
+    uint64_t v = 0;
+    auto ok = true;
+    if (auto const* const s = value ("--exhaustive_bits=")) {
+      ok = number (s, 16, &v);
+      opts.exhaustive_bits = v;
+    } else if (auto const* const s = value ("--samples=")) {
+      ok = number (s, UINT64_MAX, &opts.samples);
+    } else if (auto const* const s = value ("--threads=")) {
+      ok = number (s, 1024, &v) && v > 0U;
+      opts.threads = static_cast<unsigned> (v);
+    } else if (auto const* const s = value ("--seed=")) {
+      ok = number (s, UINT64_MAX, &opts.seed);
+    } else if (auto const* const s = value ("--min_bits=")) {
+      ok = number (s, 64, &v);
+      opts.min_bits = v;
+    } else if (auto const* const s = value ("--max_bits=")) {
+      ok = number (s, 64, &v);
+      opts.max_bits = v;
+    } else if (auto const* const s = value ("--ops=")) {
+      opts.ops = s;
+    } else {
+      ok = false;
+    }
+    if (!ok) {
+      std::fprintf (stderr, "%s: bad option '%s'\n", argv[0], arg);
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // end anonymous namespace
+
+int main (int argc, char** argv) {
+  options opts;
+  if (!parse_options (argc, argv, opts)) {
+    std::fprintf (stderr,
+                  "usage: %s [--exhaustive_bits=B] [--samples=S] "
+                  "[--threads=T] [--seed=S] [--min_bits=B] [--max_bits=B] "
+                  "[--ops=op,...]\n",
+                  argv[0]);
+    return EXIT_FAILURE;
+  }
+  std::printf ("strategy: %s\ncpu: %s\nisa: %s\nthreads: %u\nseed: %" PRIu64
+               "\n",
+               SATURATION_VERIFY_STRATEGY, cpu_model ().c_str (),
+               to_string (selected_isa ()), opts.threads, opts.seed);
+  failures log;
+  verify_widths (opts, log, std::make_index_sequence<61>{});
+  if (log.count () > 0U) {
+    std::fprintf (stderr, "%" PRIu64 " mismatches\n", log.count ());
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}